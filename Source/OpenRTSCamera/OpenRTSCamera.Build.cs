@@ -31,8 +31,12 @@ public class OpenRTSCamera : ModuleRules
 			new[]
 			{
 				"CoreUObject",
+				"DeveloperSettings",
 				"Engine",
 				"EnhancedInput",
+				"Json",
+				"Projects",
+				"RenderCore",
 				"Slate",
 				"SlateCore",
 				"UMG"
@@ -0,0 +1,176 @@
+// Copyright 2024 Jesus Bracho All Rights Reserved.
+
+#include "RTSAssetPrefetchSubsystem.h"
+#include "OpenRTSCamera.h"
+#include "RTSCameraProfiling.h"
+#include "RTSCameraSettings.h"
+#include "RTSSelectable.h"
+#include "Engine/AssetManager.h"
+#include "Engine/StreamableManager.h"
+
+bool URTSAssetPrefetchSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	return Super::ShouldCreateSubsystem(Outer) && GetDefault<URTSCameraSettings>()->EnableAssetPrefetch;
+}
+
+void URTSAssetPrefetchSubsystem::Deinitialize()
+{
+	for (const auto& [Type, Entry] : this->Entries)
+	{
+		if (Entry.Handle.IsValid())
+		{
+			Entry.Handle->CancelHandle();
+		}
+	}
+
+	this->Entries.Empty();
+	this->ResidentBytes = 0;
+	this->LastPrefetchedType = FObjectKey();
+
+	Super::Deinitialize();
+}
+
+void URTSAssetPrefetchSubsystem::Prefetch(const URTSSelectable* Selectable)
+{
+	const auto Owner = Selectable != nullptr ? Selectable->GetOwner() : nullptr;
+	if (Owner == nullptr || Selectable->PrefetchAssets.Num() == 0)
+	{
+		return;
+	}
+
+	const FObjectKey Type(Owner->GetClass());
+	if (Type == this->LastPrefetchedType)
+	{
+		return;
+	}
+
+	this->LastPrefetchedType = Type;
+	if (const auto Entry = this->Entries.Find(Type))
+	{
+		Entry->LastUse = ++this->LastUse;
+		return;
+	}
+
+	RTSCAMERA_LLM_SCOPE(Selection);
+
+	TArray<FSoftObjectPath> AssetsToLoad;
+	for (const auto& Asset : Selectable->PrefetchAssets)
+	{
+		if (!Asset.IsNull())
+		{
+			AssetsToLoad.AddUnique(Asset.ToSoftObjectPath());
+		}
+	}
+
+	auto& NewEntry = this->Entries.Add(Type);
+	NewEntry.LastUse = ++this->LastUse;
+	if (AssetsToLoad.Num() > 0)
+	{
+		NewEntry.Handle = UAssetManager::GetStreamableManager().RequestAsyncLoad(
+			AssetsToLoad,
+			FStreamableDelegate::CreateUObject(this, &URTSAssetPrefetchSubsystem::OnTypeLoaded, Type)
+		);
+	}
+
+	UE_LOG(
+		LogOpenRTSCamera,
+		Verbose,
+		TEXT("Prefetching %d UI assets for %s"),
+		AssetsToLoad.Num(),
+		*Owner->GetClass()->GetName()
+	);
+
+	// Assets that were loaded already may complete the handle before it was stored
+	const auto& Entry = this->Entries.FindChecked(Type);
+	if (!Entry.IsSizeKnown && (!Entry.Handle.IsValid() || Entry.Handle->HasLoadCompleted()))
+	{
+		this->OnTypeLoaded(Type);
+	}
+	else
+	{
+		this->Trim();
+	}
+}
+
+void URTSAssetPrefetchSubsystem::PrefetchActors(const TArray<AActor*>& Actors)
+{
+	for (const auto Actor : Actors)
+	{
+		if (Actor != nullptr)
+		{
+			this->Prefetch(Actor->FindComponentByClass<URTSSelectable>());
+		}
+	}
+}
+
+bool URTSAssetPrefetchSubsystem::IsPrefetched(const AActor* Actor) const
+{
+	const auto Entry = Actor != nullptr ? this->Entries.Find(FObjectKey(Actor->GetClass())) : nullptr;
+	return Entry != nullptr && Entry->IsSizeKnown;
+}
+
+int64 URTSAssetPrefetchSubsystem::GetResidentBytes() const
+{
+	return this->ResidentBytes;
+}
+
+int32 URTSAssetPrefetchSubsystem::GetNumResidentTypes() const
+{
+	return this->Entries.Num();
+}
+
+void URTSAssetPrefetchSubsystem::OnTypeLoaded(const FObjectKey Type)
+{
+	const auto Entry = this->Entries.Find(Type);
+	if (Entry == nullptr || Entry->IsSizeKnown)
+	{
+		return;
+	}
+
+	// Estimated per type, assets shared by several types are counted for each of them
+	Entry->IsSizeKnown = true;
+	if (Entry->Handle.IsValid())
+	{
+		TArray<UObject*> LoadedAssets;
+		Entry->Handle->GetLoadedAssets(LoadedAssets);
+		for (const auto Asset : LoadedAssets)
+		{
+			if (Asset != nullptr)
+			{
+				Entry->SizeBytes += Asset->GetResourceSizeBytes(EResourceSizeMode::EstimatedTotal);
+			}
+		}
+	}
+
+	this->ResidentBytes += Entry->SizeBytes;
+	this->Trim();
+}
+
+void URTSAssetPrefetchSubsystem::Trim()
+{
+	const auto Settings = GetDefault<URTSCameraSettings>();
+	const auto BudgetBytes = static_cast<int64>(Settings->AssetPrefetchBudgetMB * 1024.0 * 1024.0);
+	while (
+		this->Entries.Num() > 1
+		&& (this->ResidentBytes > BudgetBytes || this->Entries.Num() > Settings->AssetPrefetchMaxTypes)
+	)
+	{
+		// Linear, the cache holds a few dozen types at most
+		auto LeastRecentlyUsed = this->Entries.CreateIterator();
+		for (auto It = this->Entries.CreateIterator(); It; ++It)
+		{
+			if (It->Value.LastUse < LeastRecentlyUsed->Value.LastUse)
+			{
+				LeastRecentlyUsed = It;
+			}
+		}
+
+		auto& Entry = LeastRecentlyUsed->Value;
+		if (Entry.Handle.IsValid())
+		{
+			Entry.Handle->CancelHandle();
+		}
+		this->ResidentBytes -= Entry.SizeBytes;
+		LeastRecentlyUsed.RemoveCurrent();
+	}
+}
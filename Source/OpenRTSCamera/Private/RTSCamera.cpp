@@ -1,23 +1,73 @@
 ﻿// Copyright 2024 Jesus Bracho All Rights Reserved.
 
 #include "RTSCamera.h"
-#include "UObject/ConstructorHelpers.h"
+#include "OpenRTSCamera.h"
 //#include "Math/UnrealMathUtility.h" // For FMath::Pow
 //#include "Delegates/DelegateCombinations.h"
 #include "Blueprint/WidgetLayoutLibrary.h"
+#include "ContentStreaming.h"
+#include "Engine/AssetManager.h"
+#include "Engine/GameInstance.h"
+#include "Engine/LevelStreaming.h"
 #include "Engine/LocalPlayer.h"
+#include "Engine/StreamableManager.h"
 #include "Engine/World.h"
+#include "EngineGlobals.h"
 #include "EnhancedInputComponent.h"
 #include "EnhancedInputSubsystems.h"
+#include "GameFramework/MovementComponent.h"
+#include "GameFramework/Pawn.h"
+#include "RTSAssetPrefetchSubsystem.h"
+#include "RTSCameraKinematics.h"
+#include "RTSCameraProfiling.h"
+#include "RTSCameraSettings.h"
+#include "RTSCameraSubsystem.h"
 #include "RTSSelectable.h"
+#include "RTSSelectionReplication.h"
+#include "RTSSelectionTopK.h"
 #include "Kismet/GameplayStatics.h"
 #include "Kismet/KismetMathLibrary.h"
+#include "Misc/FileHelper.h"
+#include "Net/UnrealNetwork.h"
+#include "WorldPartition/WorldPartitionSubsystem.h"
 //#include "Runtime/CoreUObject/Public/UObject/ConstructorHelpers.h"
 
+static RTSCameraKinematics::FVec2 ToKinematics(const FVector2D& Vector)
+{
+	return {Vector.X, Vector.Y};
+}
+
+static RTSCameraKinematics::FVec3 ToKinematics(const FVector& Vector)
+{
+	return {Vector.X, Vector.Y, Vector.Z};
+}
+
+static FVector FromKinematics(const RTSCameraKinematics::FVec3& Vector)
+{
+	return FVector(Vector.X, Vector.Y, Vector.Z);
+}
+
+namespace RTSCameraStreaming
+{
+	// How long the pan velocity takes to follow a change of direction
+	static constexpr float PanVelocitySmoothingTime = 0.2f;
+	// Moves this many times faster than MoveSpeed are teleports, not pans
+	static constexpr double TeleportSpeedScale = 4;
+	// Pans that would push the lookahead by less than this much of the view radius do not get one
+	static constexpr double MinimumLookaheadFraction = 0.1;
+}
+
+namespace RTSCameraViewReplication
+{
+	// A view that moved this many quantization steps since it was last sent is sent at the maximum rate
+	static constexpr float FastStepDifference = 64;
+}
 
 URTSCamera::URTSCamera()
 {
 	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.TickGroup = TG_PostPhysics;
+	this->CameraTickGroup = TG_PostPhysics;
 	this->CameraBlockingVolumeTag = FName("OpenRTSCamera#CameraBounds");
 	this->CollisionChannel = ECC_WorldStatic;
 	this->DragExtent = 0.6f;
@@ -28,140 +78,326 @@ URTSCamera::URTSCamera()
 	this->EnableCameraRotationLag = true;
 	this->EnableDynamicCameraHeight = true;
 	this->EnableEdgeScrolling = true;
+	this->EnableFixedTimestep = false;
+	this->EnableSelectionReplication = false;
+	this->EnableViewReplication = false;
 	this->FindGroundTraceLength = 100000;
+	this->FixedTimestepRate = 120;
+	this->MaxFixedTimestepSteps = 4;
 	this->MaximumZoomLength = 10000;//5000
 	this->MinimumZoomLength = 100;
 	this->RotateSpeed = 45;
 	this->StartingYAngle = -45.0f;
 	this->StartingZAngle = 0;
+	this->ViewReplicationExtents = FVector(100000, 100000, 20000);
+	this->ViewReplicationMaxRate = 20;
+	this->ViewReplicationMinRate = 2;
 	this->ZoomCatchupSpeed = 4;
 	this->ZoomSpeed = -200;
 
-	static ConstructorHelpers::FObjectFinder<UInputAction>
-		MoveCameraXAxisFinder(TEXT("/OpenRTSCamera/Inputs/MoveCameraXAxis"));
-	static ConstructorHelpers::FObjectFinder<UInputAction>
-		MoveCameraYAxisFinder(TEXT("/OpenRTSCamera/Inputs/MoveCameraYAxis"));
-	static ConstructorHelpers::FObjectFinder<UInputAction>
-		RotateCameraAxisFinder(TEXT("/OpenRTSCamera/Inputs/RotateCameraAxis"));
-	static ConstructorHelpers::FObjectFinder<UInputAction>
-		TurnCameraLeftFinder(TEXT("/OpenRTSCamera/Inputs/TurnCameraLeft"));
-	static ConstructorHelpers::FObjectFinder<UInputAction>
-		TurnCameraRightFinder(TEXT("/OpenRTSCamera/Inputs/TurnCameraRight"));
-	static ConstructorHelpers::FObjectFinder<UInputAction>
-		ZoomCameraFinder(TEXT("/OpenRTSCamera/Inputs/ZoomCamera"));
-	static ConstructorHelpers::FObjectFinder<UInputMappingContext>
-		InputMappingContextFinder(TEXT("/OpenRTSCamera/Inputs/OpenRTSCameraInputs"));
-
-	this->MoveCameraXAxis = MoveCameraXAxisFinder.Object;
-	this->MoveCameraYAxis = MoveCameraYAxisFinder.Object;
-	this->RotateCameraAxis = RotateCameraAxisFinder.Object;
-	this->TurnCameraLeft = TurnCameraLeftFinder.Object;
-	this->TurnCameraRight = TurnCameraRightFinder.Object;
-	this->ZoomCamera = ZoomCameraFinder.Object;
-	this->InputMappingContext = InputMappingContextFinder.Object;
-
-
-
 	//"RTSSelector.h"
 
 	PrimaryComponentTick.bCanEverTick = true;
 	LastMouseX = 0.0f;
 	LastMouseY = 0.0f;
 	bIsFirstTick = true;
+	IsDispatchingReplayedInput = false;
+	CursorSnapshotFrame = MAX_uint64;
+	HasCursorOverride = false;
+	IsInputBindingPending = false;
+	IsLocalCamera = false;
+	IsSpringArmConfigured = false;
+	LastViewSendTime = 0;
+	IsViewResendPending = false;
+	IsReceivingReplicatedView = false;
+	ReplicatedViewAlpha = 1;
+	ReplicatedViewDuration = 0;
+	LastViewReceiveTime = -1;
+	IsReplacingSelection = false;
+	CameraSubsystem = nullptr;
+	IsGroundAndBoundsBatched = false;
+	JumpPrewarmMinimumTime = 0.25f;
+	JumpPrewarmTimeout = 1.5f;
+	JumpTransitionDuration = 0;
+	JumpPhase = EJumpPhase::None;
+	JumpOrigin = FVector::ZeroVector;
+	JumpDestination = FVector::ZeroVector;
+	JumpElapsedTime = 0;
+	IsStreamingSourceRegistered = false;
+	EnableStreamingSource = false;
+	FrameDeltaSeconds = 0;
+	StreamingLookaheadTime = 1.f;
+	StreamingRadiusScale = 1.25f;
+	PanVelocity = FVector::ZeroVector;
+	LastPanLocation = FVector::ZeroVector;
+	CameraState = ERTSCameraStateFlags::None;
+	IsDragMoveCalled = false;
+	BroadcastZoomBand = ERTSCameraZoomBand::Near;
+	HasBroadcastZoomBand = false;
+	EnableFollowGroupFraming = true;
+	FollowGroupFramingScale = 1.5f;
+	FollowGroupFramingSpeed = 3;
+	FollowGroupOutlierScale = 3;
+	FollowGroupReclassificationsPerTick = 16;
+	FollowGroupReclassifyCursor = 0;
+	CameraOperationElapsedTime = 0;
+	IsCameraOperationStarted = false;
+	CameraOperationStartLocation = FVector::ZeroVector;
+	CameraOperationStartZoomLength = 0;
+	CameraOperationStartYaw = 0;
+	MaxSelectionCount = 0;
+	SelectionOrder = ERTSSelectionOrder::Priority;
+	NumDroppedFromLastSelection = 0;
+	ViewSnapshotBuffer = MakeShared<FRTSCameraViewSnapshotBuffer, ESPMode::ThreadSafe>();
+	LastHoverPrefetchTime = 0;
+	LastHoverCursorPosition = FVector2D(-1);
+	NumWeightedMoveCameraCommands = 0;
+	PendingMoveCameraSeconds = 0;
+	MoveCameraCommandScale = 1;
+	HasConsumedMoveCameraCommands = false;
+
+	// Input assets left unset are filled in from URTSCameraSettings once they have streamed in, see RequestInputAssets
+}
 
+void URTSCamera::OnRegister()
+{
+	RTSCAMERA_LLM_SCOPE(Camera);
 
-	// Add defaults for input actions
-	static ConstructorHelpers::FObjectFinder<UInputAction>
-		BeginSelectionActionFinder(TEXT("/OpenRTSCamera/Inputs/BeginSelection"));
+	Super::OnRegister();
 
-	this->BeginSelection = BeginSelectionActionFinder.Object;
-	//this->InputMappingContext = InputMappingContextFinder.Object;
+	if (this->EnableViewReplication || this->EnableSelectionReplication)
+	{
+		this->SetIsReplicated(true);
+	}
 
+	// Start streaming the input assets as early as possible so that they are usually resident by BeginPlay
+	if (this->ShouldBeLocalCamera())
+	{
+		this->RequestInputAssets();
+	}
 }
 
 void URTSCamera::BeginPlay()
 {
+	RTSCAMERA_LLM_SCOPE(Camera);
+
 	Super::BeginPlay();
 
-	const auto NetMode = this->GetNetMode();
-	if (NetMode != NM_DedicatedServer)
-	{
-		this->CollectComponentDependencyReferences();
-		this->ConfigureSpringArm();
-		this->TryToFindBoundaryVolumeReference();
-		this->ConditionallyEnableEdgeScrolling();
-		this->CheckForEnhancedInputComponent();
-		this->BindInputMappingContext();
-		this->BindInputActions();
+	this->SetTickGroup(this->CameraTickGroup);
 
+	if (this->GetNetMode() != NM_DedicatedServer)
+	{
+		// Possession decides which machine, and which local player, drives a camera pawn
+		if (const auto Pawn = Cast<APawn>(this->GetOwner()))
+		{
+			Pawn->ReceiveControllerChangedDelegate.AddUniqueDynamic(this, &URTSCamera::OnOwnerControllerChanged);
+		}
 
 		//"RTSSelector.h"
 
-		OnActorsSelected.AddDynamic(this, &URTSCamera::HandleSelectedActors);
-		UE_LOG(LogTemp, Warning, TEXT("NetMode != NM_DedicatedServer"));
+		OnActorsSelected.AddUniqueDynamic(this, &URTSCamera::HandleSelectedActors);
 	}
+
+	this->EvaluateCameraRole();
 }
 
-void URTSCamera::TickComponent(
-	const float DeltaTime,
-	const ELevelTick TickType,
-	FActorComponentTickFunction* ThisTickFunction
-)
+void URTSCamera::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
-	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
-	const auto NetMode = this->GetNetMode();
-	if (NetMode != NM_DedicatedServer && this->PlayerController->GetViewTarget() == this->Owner)
+	if (const auto Pawn = Cast<APawn>(this->GetOwner()))
 	{
-		this->DeltaSeconds = DeltaTime;
-		this->ApplyMoveCameraCommands();
-		this->ConditionallyPerformEdgeScrolling();
-		this->ConditionallyKeepCameraAtDesiredZoomAboveGround();
-		this->SmoothTargetArmLengthToDesiredZoom();
-		this->FollowTargetIfSet();
-		this->ConditionallyApplyCameraBounds();
+		Pawn->ReceiveControllerChangedDelegate.RemoveDynamic(this, &URTSCamera::OnOwnerControllerChanged);
+	}
 
-		
+	if (this->IsLocalCamera)
+	{
+		this->DeactivateLocalCamera();
+	}
+	else if (this->InputAssetsHandle.IsValid())
+	{
+		// Requested on registration for a camera that never became local
+		this->InputAssetsHandle->CancelHandle();
+		this->InputAssetsHandle.Reset();
+	}
+	this->CancelSequence();
+	this->ClearFollowGroup();
 
-		if (bIsMoveCameraYAxisCalled || bIsMoveCameraXAxisCalled)
-		{
-			// 方法被调用
-			IsMove = true;
-			IsKeyBoardMove = true;
-		}
-		else
-		{
-			// 方法未被调用
-			IsMove = false;
-			IsKeyBoardMove = false;
-			RTSKeyXMovement = 0;
-			RTSKeyYMovement = 0;
-		}
+	Super::EndPlay(EndPlayReason);
+}
 
-		if (RTSMouseLeftMovement || RTSMouseRightMovement || RTSMouseUpMovement || RTSMouseDownMovement)
-		{
-			IsMove = true;
-			IsMouseMove = true;
-		}
-		else
+void URTSCamera::RegisterComponentTickFunctions(const bool bRegister)
+{
+	// Servers and cameras of other players never tick at all, activating the camera or receiving a view registers it
+	Super::RegisterComponentTickFunctions(bRegister && (this->IsLocalCamera || this->IsReceivingReplicatedView));
+}
+
+bool URTSCamera::ShouldBeLocalCamera() const
+{
+	const auto World = this->GetWorld();
+	if (World == nullptr || !World->IsGameWorld() || this->GetNetMode() == NM_DedicatedServer)
+	{
+		return false;
+	}
+
+	if (const auto Pawn = Cast<APawn>(this->GetOwner()))
+	{
+		if (Pawn->GetController() != nullptr)
 		{
-			// 方法未被调用
-			IsMove = false;
-			IsMouseMove = false;
+			return Pawn->IsLocallyControlled();
 		}
-		
-		//UE_LOG(LogTemp, Warning, TEXT("IsMove: %s  IsKeyBoardMove: %s  IsMouseMove: %s"), IsMove ? TEXT("1") : TEXT("0"), IsKeyBoardMove ? TEXT("1") : TEXT("0"), IsMouseMove ? TEXT("1") : TEXT("0"));
-		//UE_LOG(LogTemp, Warning, TEXT("MouseLeft: %f  MouseRight: %f  MouseUp: %f  MouseDown: %f,KeyX: %f,KeyY: %f"), RTSMouseLeftMovement, RTSMouseRightMovement, RTSMouseUpMovement, RTSMouseDownMovement, RTSKeyXMovement, RTSKeyYMovement);
-		
-		//UE_LOG(LogTemp, Warning, TEXT("bIsDrawingSelectionBox: %s ,bIsPerformingSelection: %s "), HUD->bIsDrawingSelectionBox ? TEXT("1") : TEXT("0"), HUD->bIsPerformingSelection ? TEXT("1") : TEXT("0"));
 
+		return this->GetNetMode() != NM_Client;
+	}
 
-		// 重置标志
-		bIsMoveCameraYAxisCalled = false;
-		bIsMoveCameraXAxisCalled = false;
-		IsMove = false;
-		IsMouseMove = false;
+	return true;
+}
+
+void URTSCamera::EvaluateCameraRole()
+{
+	const auto ShouldBeLocal = this->ShouldBeLocalCamera();
+	if (ShouldBeLocal && !this->IsLocalCamera)
+	{
+		this->ActivateLocalCamera();
+	}
+	else if (!ShouldBeLocal && this->IsLocalCamera)
+	{
+		this->DeactivateLocalCamera();
+	}
+}
+
+void URTSCamera::OnOwnerControllerChanged(APawn* Pawn, AController* OldController, AController* NewController)
+{
+	// A local camera handed to another local player is rebound to it
+	if (this->IsLocalCamera && NewController != nullptr && NewController != this->PlayerController)
+	{
+		this->DeactivateLocalCamera();
+	}
+
+	// Selections mirrored by the previous controller are not the new one's to command
+	if (this->GetOwner()->HasAuthority())
+	{
+		this->SelectionReceiver = RTSSelectionReplication::FSelectionReceiver();
+	}
+
+	this->EvaluateCameraRole();
+}
+
+void URTSCamera::ActivateLocalCamera()
+{
+	this->IsLocalCamera = true;
+	this->RegisterComponentTickFunctions(true);
+
+	if (this->IsReceivingReplicatedView)
+	{
+		// The tick is paused between received views
+		this->IsReceivingReplicatedView = false;
+		this->SetComponentTickEnabled(true);
+	}
+
+	// Once registered, the subsystem ticks this camera and owns the follow target prerequisites
+	this->RemoveFollowTargetTickPrerequisites();
+	this->CameraSubsystem = this->GetWorld()->GetSubsystem<URTSCameraSubsystem>();
+	if (this->CameraSubsystem != nullptr)
+	{
+		this->CameraSubsystem->RegisterCamera(this);
+	}
+	this->AddFollowTargetTickPrerequisites();
+
+	this->CollectComponentDependencyReferences();
+
+	// Only the first activation places the camera, a change of player keeps the view where it was
+	if (!this->IsSpringArmConfigured)
+	{
+		this->IsSpringArmConfigured = true;
+		this->ConfigureSpringArm();
+		this->TryToFindBoundaryVolumeReference();
+	}
 
+	this->LastPanLocation = this->Root->GetComponentLocation();
+	this->PanVelocity = FVector::ZeroVector;
+	this->UpdateStreamingSourceRegistration();
+	this->ConditionallyReplicateSelection();
+
+	if (this->PlayerController == nullptr)
+	{
+		return;
+	}
+
+	this->ConditionallyEnableEdgeScrolling();
+	this->CheckForEnhancedInputComponent();
+
+	this->RequestInputAssets();
+	const auto InputAssetLoadTimeout = GetDefault<URTSCameraSettings>()->InputAssetLoadTimeout;
+	if (
+		this->InputAssetsHandle.IsValid()
+		&& this->InputAssetsHandle->IsLoadingInProgress()
+		&& InputAssetLoadTimeout > 0
+	)
+	{
+		this->InputAssetsHandle->WaitUntilComplete(InputAssetLoadTimeout);
+	}
+
+	if (this->InputAssetsHandle.IsValid() && this->InputAssetsHandle->IsLoadingInProgress())
+	{
+		UE_LOG(LogOpenRTSCamera, Verbose, TEXT("Input assets are still loading, input is bound once they arrive"));
+		this->IsInputBindingPending = true;
+	}
+	else
+	{
+		this->BindInputs();
+	}
+
+	UE_LOG(LogOpenRTSCamera, Verbose, TEXT("Camera input bound for %s"), *GetNameSafe(this->Owner));
+}
+
+void URTSCamera::DeactivateLocalCamera()
+{
+	if (this->InputAssetsHandle.IsValid())
+	{
+		this->InputAssetsHandle->CancelHandle();
+		this->InputAssetsHandle.Reset();
+	}
+	this->IsInputBindingPending = false;
+
+	this->UnbindInputs();
+
+	this->RemoveFollowTargetTickPrerequisites();
+	if (this->CameraSubsystem != nullptr)
+	{
+		this->CameraSubsystem->UnregisterCamera(this);
+		this->CameraSubsystem = nullptr;
+	}
+
+	this->IsLocalCamera = false;
+	this->RegisterComponentTickFunctions(false);
+	this->CancelJump();
+	this->SetCameraState(this->CameraState & ERTSCameraStateFlags::Following);
+
+	// Whoever controls the camera now is not ours to drive
+	this->PlayerController = nullptr;
+	this->HUD = nullptr;
+	this->LastViewReceiveTime = -1;
+	// The next player to drive the camera starts the mirrored selection over with a keyframe
+	this->SelectionSender.Reset();
+	UE_LOG(LogOpenRTSCamera, Verbose, TEXT("Camera deactivated for %s"), *GetNameSafe(this->GetOwner()));
+}
+
+void URTSCamera::TickComponent(
+	const float DeltaTime,
+	const ELevelTick TickType,
+	FActorComponentTickFunction* ThisTickFunction
+)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+	RTSCAMERA_TICK_SCOPE();
+	RTSCAMERA_LLM_SCOPE(Camera);
 
+	if (this->IsReceivingReplicatedView)
+	{
+		this->TickReplicatedView(DeltaTime);
+	}
+	else if (this->TickCamera(DeltaTime, false))
+	{
+		this->FinishCameraTick();
 	}
 	/*
 	APawn* ControlledPawn = this->PlayerController->GetPawn();
@@ -191,147 +427,1470 @@ void URTSCamera::TickComponent(
 
 }
 
+// Runs this frame's input and simulation, returns false if the camera is not in use.
+// When batched, URTSCameraSubsystem traces the ground and applies the bounds afterwards, for all of its cameras at once.
+bool URTSCamera::TickCamera(const float DeltaTime, const bool IsBatched)
+{
+	if (
+		!this->IsLocalCamera
+		|| (
+			!this->IsReplayingInput()
+			&& (this->PlayerController == nullptr || this->PlayerController->GetViewTarget() != this->Owner)
+		)
+	)
+	{
+		return false;
+	}
 
+	this->IsGroundAndBoundsBatched = IsBatched;
+	this->TickJump(DeltaTime);
+	this->TickSequence(DeltaTime);
+	this->UpdateFollowGroup(DeltaTime);
 
-//"RTSSelector.h"
-
-void URTSCamera::HandleSelectedActors_Implementation(const TArray<AActor*>& NewSelectedActors)//HandleSelectedActors_Implementation
-{
-	
-	// Convert NewSelectedActors to a set for efficient lookup 将新选定的演员转换为一个集合，以便高效查找。
-	TSet<AActor*> NewSelectedActorSet;
-	for (const auto& Actor : NewSelectedActors)
+	auto CameraDeltaTime = DeltaTime;
+	if (this->InputPlayer.IsValid())
+	{
+		CameraDeltaTime = this->ReplayRecordedFrame(DeltaTime);
+	}
+	else if (this->InputRecorder.IsValid())
 	{
-		NewSelectedActorSet.Add(Actor);
-		//UE_LOG(LogTemp, Warning, TEXT("NewSelectedActorSet"));
+		// Sample the cursor before closing the frame so that it is replayed ahead of the frame that used it
+		this->GetCursorSnapshot();
+		CameraDeltaTime = this->InputRecorder->RecordFrame(DeltaTime);
 	}
+	this->FrameDeltaSeconds = CameraDeltaTime;
 
-	// Iterate over currently selected actors 循环遍历当前选中的演员。 清除旧选新的才使用
-	for (const auto& Selected : SelectedActors)//SelectedActors
+	if (this->EnableFixedTimestep)
+	{
+		this->TickFixedTimestep(CameraDeltaTime);
+	}
+	else
 	{
-		// Check if the actor is not in the new selection 检查演员是否不在新选择中
-		if (!NewSelectedActorSet.Contains(Selected->GetOwner()))
+		this->HasSimulationState = false;
+		this->DeltaSeconds = CameraDeltaTime;
+		this->MoveCameraCommandScale = 1;
+		this->RunSimulationStep();
+		this->FollowTargetIfSet();
+
+		if (!IsBatched)
 		{
-			// Call OnDeselected for actors that are no longer selected 对不再被选中的演员调用取消选中
-			Selected->OnDeselected();
+			this->ConditionallyApplyCameraBounds();
 		}
 	}
 
-	// Clear the current selection 清除当前选择
-	ClearSelectedActors();
+	return true;
+}
 
-	// Add new selected actors and call OnSelected 添加新的选定演员并调用OnSelected
-	for (const auto& Actor : NewSelectedActors)
+void URTSCamera::FinishCameraTick()
+{
+	if (this->EnableFixedTimestep)
 	{
-		if (URTSSelectable* SelectableComponent = Actor->FindComponentByClass<URTSSelectable>())
-		{
-			this->SelectedActors.Add(SelectableComponent);
-			SelectableComponent->OnSelected();
-		}
+		this->RenderedSimulationState = this->CaptureSimulationState();
 	}
 
+	// Move commands are consumed by every simulation step run this frame, without a step they carry over to the next
+	if (!this->EnableFixedTimestep || this->HasConsumedMoveCameraCommands)
+	{
+		this->MoveCameraCommands.Reset();
+		this->NumWeightedMoveCameraCommands = 0;
+		this->PendingMoveCameraSeconds = 0;
+	}
+	this->HasConsumedMoveCameraCommands = false;
+
+	if (bIsMoveCameraYAxisCalled || bIsMoveCameraXAxisCalled)
+	{
+		// 方法被调用
+		IsMove = true;
+		IsKeyBoardMove = true;
+	}
+	else
+	{
+		// 方法未被调用
+		IsMove = false;
+		IsKeyBoardMove = false;
+		RTSKeyXMovement = 0;
+		RTSKeyYMovement = 0;
+	}
 
+	if (RTSMouseLeftMovement || RTSMouseRightMovement || RTSMouseUpMovement || RTSMouseDownMovement)
+	{
+		IsMove = true;
+		IsMouseMove = true;
+	}
+	else
+	{
+		// 方法未被调用
+		IsMove = false;
+		IsMouseMove = false;
+	}
 	
+	//UE_LOG(LogTemp, Warning, TEXT("IsMove: %s  IsKeyBoardMove: %s  IsMouseMove: %s"), IsMove ? TEXT("1") : TEXT("0"), IsKeyBoardMove ? TEXT("1") : TEXT("0"), IsMouseMove ? TEXT("1") : TEXT("0"));
+	//UE_LOG(LogTemp, Warning, TEXT("MouseLeft: %f  MouseRight: %f  MouseUp: %f  MouseDown: %f,KeyX: %f,KeyY: %f"), RTSMouseLeftMovement, RTSMouseRightMovement, RTSMouseUpMovement, RTSMouseDownMovement, RTSKeyXMovement, RTSKeyYMovement);
+	
+	//UE_LOG(LogTemp, Warning, TEXT("bIsDrawingSelectionBox: %s ,bIsPerformingSelection: %s "), HUD->bIsDrawingSelectionBox ? TEXT("1") : TEXT("0"), HUD->bIsPerformingSelection ? TEXT("1") : TEXT("0"));
+
+
+	this->UpdateViewFootprint();
+	this->UpdateCameraState();
+
+	// 重置标志
+	bIsMoveCameraYAxisCalled = false;
+	bIsMoveCameraXAxisCalled = false;
+	IsMove = false;
+	IsMouseMove = false;
+	this->IsDragMoveCalled = false;
+
+	this->UpdatePanVelocity(this->FrameDeltaSeconds);
+	this->UpdateStreamingSourceRegistration();
+	this->PublishViewSnapshot();
+	this->UpdateHoverPrefetch();
+	this->ConditionallyReplicateView();
 }
 
-void URTSCamera::ClearSelectedActors_Implementation()//ClearSelectedActors_Implementation
+URTSAssetPrefetchSubsystem* URTSCamera::GetAssetPrefetchSubsystem() const
 {
-	this->SelectedActors.Empty();
+	const auto GameInstance = this->GetWorld()->GetGameInstance();
+	return GameInstance != nullptr ? GameInstance->GetSubsystem<URTSAssetPrefetchSubsystem>() : nullptr;
 }
 
-void URTSCamera::SetupPlayerInputComponent(UInputComponent* PlayerInputComponent)
+void URTSCamera::UpdateHoverPrefetch()
 {
-	if (const auto InputComponent = Cast<UEnhancedInputComponent>(PlayerInputComponent))
+	const auto AssetPrefetch = this->GetAssetPrefetchSubsystem();
+	if (AssetPrefetch == nullptr || !this->IsLocalCamera || this->CameraSubsystem == nullptr)
 	{
-		InputComponent->BindAction(this->BeginSelection, ETriggerEvent::Started, this, &URTSCamera::OnSelectionStart);
-		InputComponent->BindAction(this->BeginSelection, ETriggerEvent::Completed, this, &URTSCamera::OnSelectionEnd);
+		return;
 	}
-}
-
-//"RTSSelector.h"
 
+	// Hovering only hints at what comes next, a few lookups a second while the cursor moves are plenty
+	const auto Now = this->GetWorld()->GetRealTimeSeconds();
+	const auto& Cursor = this->GetCursorSnapshot();
+	if (
+		Now - this->LastHoverPrefetchTime < GetDefault<URTSCameraSettings>()->HoverPrefetchInterval
+		|| Cursor.ViewportMousePosition.Equals(this->LastHoverCursorPosition, 1)
+	)
+	{
+		return;
+	}
 
+	FRTSCameraViewSnapshot Snapshot;
+	if (!this->ViewSnapshotBuffer->Read(Snapshot) || Cursor.ViewportSize.X <= 0 || Cursor.ViewportSize.Y <= 0)
+	{
+		return;
+	}
 
+	RTSCAMERA_STAGE_SCOPE(Prefetch);
 
+	this->LastHoverPrefetchTime = Now;
+	this->LastHoverCursorPosition = Cursor.ViewportMousePosition;
 
+	FRTSSelectionView View;
+	View.ViewProjectionMatrix = Snapshot.ViewProjectionMatrix;
+	View.ViewportSize = Cursor.ViewportSize;
+	this->HoveredActorsScratch.Reset();
+	this->CameraSubsystem->GetSelectableActorsInRectangle(
+		View,
+		FBox2D(Cursor.ViewportMousePosition - FVector2D(4), Cursor.ViewportMousePosition + FVector2D(4)),
+		this->HoveredActorsScratch
+	);
+	for (const auto Actor : this->HoveredActorsScratch)
+	{
+		AssetPrefetch->Prefetch(Actor->FindComponentByClass<URTSSelectable>());
+	}
+}
 
-void URTSCamera::FollowTarget(AActor* Target)
+double URTSCamera::GetViewAspectRatio() const
 {
-	this->CameraFollowTarget = Target;
+	// The viewport decides the aspect ratio unless the camera constrains it
+	const auto& ViewportSize = this->GetCursorSnapshot().ViewportSize;
+	return !this->Camera->bConstrainAspectRatio && ViewportSize.X > 0 && ViewportSize.Y > 0
+		? ViewportSize.X / ViewportSize.Y
+		: this->Camera->AspectRatio;
 }
 
-void URTSCamera::UnFollowTarget()
+void URTSCamera::UpdateViewFootprint()
 {
-	this->CameraFollowTarget = nullptr;
+	if (this->Camera == nullptr)
+	{
+		this->ViewFootprint.IsValid = false;
+		return;
+	}
+
+	const auto AspectRatio = this->GetViewAspectRatio();
+	const auto EyeLocation = this->Camera->GetComponentLocation();
+	const auto EyeRotation = this->Camera->GetComponentRotation();
+	this->ViewFootprint.Ground = RTSCameraKinematics::ComputeGroundFootprint(
+		ToKinematics(EyeLocation),
+		EyeRotation.Yaw,
+		EyeRotation.Pitch,
+		this->Camera->FieldOfView,
+		AspectRatio,
+		this->Root->GetComponentLocation().Z,
+		GetDefault<URTSCameraSettings>()->SignificanceMaxViewDistance
+	);
+	this->ViewFootprint.Bounds = FBox2D(
+		FVector2D(this->ViewFootprint.Ground.Min.X, this->ViewFootprint.Ground.Min.Y),
+		FVector2D(this->ViewFootprint.Ground.Max.X, this->ViewFootprint.Ground.Max.Y)
+	);
+	this->ViewFootprint.EyeLocation = EyeLocation;
+
+	const auto ZoomAlpha = this->GetZoomAlpha();
+	this->ViewFootprint.ZoomBand = ZoomAlpha < 1.0 / 3
+		? ERTSCameraZoomBand::Near
+		: ZoomAlpha < 2.0 / 3
+		? ERTSCameraZoomBand::Mid
+		: ERTSCameraZoomBand::Far;
+	this->ViewFootprint.IsValid = true;
 }
 
-void URTSCamera::OnZoomCamera(const FInputActionValue& Value)
-{	
-	this->ZoomSpeed = -20 - this->DesiredZoomLength / 20;
-	this->MoveSpeed = this->DesiredZoomLength * 2;
-	this->EdgeScrollSpeed = this->MoveSpeed;
+void URTSCamera::PublishViewSnapshot()
+{
+	if (!this->ViewFootprint.IsValid)
+	{
+		return;
+	}
 
-	this->DesiredZoomLength = FMath::Clamp(
-		this->DesiredZoomLength + Value.Get<float>() * this->ZoomSpeed,
-		this->MinimumZoomLength,
-		this->MaximumZoomLength
+	FRTSCameraViewSnapshot Snapshot;
+	Snapshot.FrameNumber = GFrameCounter;
+	Snapshot.WorldTimeSeconds = this->GetWorld()->GetTimeSeconds();
+	Snapshot.EyeLocation = this->ViewFootprint.EyeLocation;
+	Snapshot.EyeRotation = this->Camera->GetComponentRotation();
+	Snapshot.FieldOfView = this->Camera->FieldOfView;
+	Snapshot.AspectRatio = static_cast<float>(this->GetViewAspectRatio());
+	Snapshot.RootLocation = this->Root->GetComponentLocation();
+	Snapshot.ZoomLength = this->SpringArm->TargetArmLength;
+	Snapshot.ZoomBand = this->ViewFootprint.ZoomBand;
+	Snapshot.Ground = this->ViewFootprint.Ground;
+
+	FMinimalViewInfo ViewInfo;
+	ViewInfo.Location = Snapshot.EyeLocation;
+	ViewInfo.Rotation = Snapshot.EyeRotation;
+	ViewInfo.FOV = Snapshot.FieldOfView;
+	ViewInfo.AspectRatio = Snapshot.AspectRatio;
+	ViewInfo.ProjectionMode = ECameraProjectionMode::Perspective;
+	FMatrix ProjectionMatrix;
+	UGameplayStatics::GetViewProjectionMatrix(
+		ViewInfo,
+		Snapshot.ViewMatrix,
+		ProjectionMatrix,
+		Snapshot.ViewProjectionMatrix
 	);
-	UE_LOG(LogTemp, Warning, TEXT("ZoomSpeed: %f,MoveSpeed: %f,DesiredZoomLength: %f"), this->ZoomSpeed, this->MoveSpeed, this->DesiredZoomLength);
+
+	// Planes through the eye, their normals leaning out of the view by the half angles of the field of view
+	const auto RotationMatrix = FRotationMatrix(Snapshot.EyeRotation);
+	const auto Forward = RotationMatrix.GetUnitAxis(EAxis::X);
+	const auto Right = RotationMatrix.GetUnitAxis(EAxis::Y);
+	const auto Up = RotationMatrix.GetUnitAxis(EAxis::Z);
+	const auto TanHalfWidth = FMath::Tan(FMath::DegreesToRadians(Snapshot.FieldOfView * 0.5));
+	const auto TanHalfHeight = TanHalfWidth / Snapshot.AspectRatio;
+	const auto Eye = Snapshot.EyeLocation;
+	Snapshot.FrustumPlanes[0] = FPlane(Eye + Forward * GNearClippingPlane, -Forward);
+	Snapshot.FrustumPlanes[1] = FPlane(Eye, (-Right - Forward * TanHalfWidth).GetSafeNormal());
+	Snapshot.FrustumPlanes[2] = FPlane(Eye, (Right - Forward * TanHalfWidth).GetSafeNormal());
+	Snapshot.FrustumPlanes[3] = FPlane(Eye, (Up - Forward * TanHalfHeight).GetSafeNormal());
+	Snapshot.FrustumPlanes[4] = FPlane(Eye, (-Up - Forward * TanHalfHeight).GetSafeNormal());
+
+	this->ViewSnapshotBuffer->Publish(Snapshot);
 }
 
-void URTSCamera::OnRotateCamera(const FInputActionValue& Value)
+void URTSCamera::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
 {
-	const auto WorldRotation = this->Root->GetComponentRotation();
-	//const auto SpringArmRotation = this->SpringArm->GetComponentRotation();
-	//APlayerController* PlayerController = GetWorld()->GetFirstPlayerController();
-	if (this->PlayerController)
-	{
-		// 获取当前鼠标位置
-		float MouseX, MouseY, RotationRate;
-		RotationRate= this->DesiredZoomLength / 20000;
-		this->PlayerController->GetMousePosition(MouseX, MouseY);
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
-		// 比较当前帧和上一帧的鼠标位置
-		if (bIsFirstTick)
+	// The owning player produces the view, it never needs it back
+	DOREPLIFETIME_CONDITION(URTSCamera, ReplicatedView, COND_SkipOwner);
+}
+
+FBox URTSCamera::GetViewReplicationBounds() const
+{
+	// Sender and receivers quantize against the same box, both find the boundary volume by its tag
+	auto Origin = FVector::ZeroVector;
+	auto Extents = this->ViewReplicationExtents;
+	if (this->BoundaryVolume != nullptr)
+	{
+		FVector VolumeExtents;
+		if (this->CameraSubsystem != nullptr)
 		{
-			LastMouseX = MouseX;
-			LastMouseY = MouseY;
-			bIsFirstTick = false;
+			this->CameraSubsystem->GetBoundaryVolumeBounds(this->BoundaryVolume, Origin, VolumeExtents);
 		}
 		else
 		{
-			DeltaX = MouseX - LastMouseX;
-			DeltaY = MouseY - LastMouseY;
+			this->BoundaryVolume->GetActorBounds(false, Origin, VolumeExtents);
+		}
 
-			if (DeltaX > 0 or RTSMouseRightMovement)
-			{
-				RotationX =0.5 + RotationRate;// 1;//Value.Get<float>();
-				//UE_LOG(LogTemp, Log, TEXT("Mouse moved right"));
-			}
-			else if (DeltaX < 0 or RTSMouseLeftMovement)
-			{
-				RotationX = -(0.5 + RotationRate);// -Value.Get<float>();
-				//UE_LOG(LogTemp, Log, TEXT("Mouse moved left"));
+		// The ground the camera follows is rarely inside a volume's height
+		Extents.X = VolumeExtents.X;
+		Extents.Y = VolumeExtents.Y;
+	}
 
-			}
-			else
-			{
-				RotationX = 0;
-			}
+	return FBox::BuildAABB(Origin, Extents);
+}
 
-			if (DeltaY > 0 or RTSMouseDownMovement)
-			{
-				RotationY = 0.4 + RotationRate;//设置上下旋转速度
+FRTSCameraViewPose URTSCamera::CaptureViewPose() const
+{
+	FRTSCameraViewPose Pose;
+	Pose.RootLocation = this->Root->GetComponentLocation();
+	Pose.Yaw = static_cast<float>(this->Root->GetComponentRotation().Yaw);
+	Pose.Pitch = static_cast<float>(this->SpringArm->GetRelativeRotation().Pitch);
+	Pose.ZoomLength = this->DesiredZoomLength;
+	return Pose;
+}
 
-			}
-			else if (DeltaY < 0 or RTSMouseUpMovement)
-			{
-				RotationY = -(0.4 + RotationRate);
-			}
-			else
-			{
-				RotationY = 0;
-			}
+void URTSCamera::ApplyViewPose(const FRTSCameraViewPose& Pose)
+{
+	const auto RootRotation = this->Root->GetComponentRotation();
+	this->Root->SetWorldLocationAndRotation(
+		Pose.RootLocation,
+		FRotator(RootRotation.Pitch, Pose.Yaw, RootRotation.Roll)
+	);
+
+	auto SpringArmRotation = this->SpringArm->GetRelativeRotation();
+	SpringArmRotation.Pitch = Pose.Pitch;
+	this->SpringArm->SetRelativeRotation(SpringArmRotation);
+	this->SpringArm->TargetArmLength = Pose.ZoomLength;
+	this->DesiredZoomLength = Pose.ZoomLength;
+}
+
+void URTSCamera::ConditionallyReplicateView()
+{
+	RTSCAMERA_LLM_SCOPE(Replication);
+
+	if (!this->EnableViewReplication || this->GetNetMode() == NM_Standalone)
+	{
+		return;
+	}
+
+	const auto View = FRTSCameraReplicatedView::Quantize(
+		this->CaptureViewPose(),
+		this->GetViewReplicationBounds(),
+		this->MinimumZoomLength,
+		this->MaximumZoomLength
+	);
+	const auto Now = this->GetWorld()->GetTimeSeconds();
+	const auto SecondsSinceSend = Now - this->LastViewSendTime;
+	const auto StepDifference = FRTSCameraReplicatedView::GetLargestStepDifference(View, this->LastSentView);
+
+	if (StepDifference == 0)
+	{
+		if (!this->IsViewResendPending || SecondsSinceSend < 1 / this->ViewReplicationMinRate)
+		{
+			return;
+		}
+
+		this->IsViewResendPending = false;
+	}
+	else
+	{
+		// A view that jumps is sent at the maximum rate, one that drifts by a step or two at the minimum rate
+		const auto Urgency = FMath::Clamp(StepDifference / RTSCameraViewReplication::FastStepDifference, 0.0f, 1.0f);
+		const auto Interval = FMath::Lerp(1 / this->ViewReplicationMinRate, 1 / this->ViewReplicationMaxRate, Urgency);
+		if (SecondsSinceSend < Interval)
+		{
+			return;
+		}
+
+		this->IsViewResendPending = true;
+	}
+
+	this->LastSentView = View;
+	this->LastViewSendTime = Now;
+	RTSCAMERA_COUNTER_ADD(ViewUpdatesSent, 1);
+
+	if (this->GetOwner()->HasAuthority())
+	{
+		this->SetReplicatedView(View);
+	}
+	else
+	{
+		this->ServerSetReplicatedView(View);
+	}
+}
+
+void URTSCamera::ServerSetReplicatedView_Implementation(const FRTSCameraReplicatedView& View)
+{
+	this->SetReplicatedView(View);
+}
+
+void URTSCamera::SetReplicatedView(const FRTSCameraReplicatedView& View)
+{
+	this->ReplicatedView = View;
+
+	// A listen server host watching this camera gets no OnRep
+	if (this->GetNetMode() == NM_ListenServer && !this->IsLocalCamera)
+	{
+		this->ReceiveReplicatedView();
+	}
+}
+
+void URTSCamera::OnRep_ReplicatedView()
+{
+	RTSCAMERA_LLM_SCOPE(Replication);
+
+	if (!this->IsLocalCamera)
+	{
+		this->ReceiveReplicatedView();
+	}
+}
+
+void URTSCamera::ReceiveReplicatedView()
+{
+	// Remote cameras are never activated, they only need their own components and the bounds to place the view
+	if (this->Root == nullptr)
+	{
+		this->CollectOwnerComponentReferences();
+		this->TryToFindBoundaryVolumeReference();
+	}
+
+	if (this->Root == nullptr || this->SpringArm == nullptr)
+	{
+		return;
+	}
+
+	const auto Now = this->GetWorld()->GetTimeSeconds();
+	this->ReplicatedViewTo = this->ReplicatedView.Dequantize(
+		this->GetViewReplicationBounds(),
+		this->MinimumZoomLength,
+		this->MaximumZoomLength
+	);
+
+	if (this->LastViewReceiveTime < 0)
+	{
+		this->ApplyViewPose(this->ReplicatedViewTo);
+		this->ReplicatedViewAlpha = 1;
+	}
+	else
+	{
+		// Interpolate over the time the sender took to send this view, so consecutive views join up
+		this->ReplicatedViewFrom = this->CaptureViewPose();
+		this->ReplicatedViewAlpha = 0;
+		this->ReplicatedViewDuration = FMath::Clamp(
+			static_cast<float>(Now - this->LastViewReceiveTime),
+			1 / this->ViewReplicationMaxRate,
+			1 / this->ViewReplicationMinRate
+		);
+	}
+	this->LastViewReceiveTime = Now;
+
+	if (!this->IsReceivingReplicatedView)
+	{
+		this->IsReceivingReplicatedView = true;
+
+		// Views can arrive before BeginPlay, which registers the tick itself
+		if (this->HasBegunPlay())
+		{
+			this->RegisterComponentTickFunctions(true);
+		}
+	}
+
+	this->SetComponentTickEnabled(this->ReplicatedViewAlpha < 1);
+}
+
+void URTSCamera::TickReplicatedView(const float DeltaTime)
+{
+	this->ReplicatedViewAlpha = FMath::Min(this->ReplicatedViewAlpha + DeltaTime / this->ReplicatedViewDuration, 1.0f);
+	this->ApplyViewPose(
+		FRTSCameraViewPose::Lerp(this->ReplicatedViewFrom, this->ReplicatedViewTo, this->ReplicatedViewAlpha)
+	);
+
+	if (this->ReplicatedViewAlpha >= 1)
+	{
+		this->SetComponentTickEnabled(false);
+	}
+}
+
+void URTSCamera::TickFixedTimestep(const float DeltaTime)
+{
+	const auto StepSeconds = 1.0f / FMath::Max(this->FixedTimestepRate, 1.0f);
+
+	// Anything that moved the root since the last frame (JumpTo, blueprints, ...) becomes the new simulation origin
+	if (
+		!this->HasSimulationState
+		|| !this->Root->GetComponentLocation().Equals(this->RenderedSimulationState.RootLocation)
+	)
+	{
+		this->CurrentSimulationState = this->CaptureSimulationState();
+		this->PreviousSimulationState = this->CurrentSimulationState;
+		this->HasSimulationState = true;
+		this->FixedTimestepAccumulator = 0;
+	}
+
+	this->FixedTimestepAccumulator += DeltaTime;
+
+	// Each command moves the camera for as long as the frame it came with, spread over the steps that consume it
+	for (auto Index = this->NumWeightedMoveCameraCommands; Index < this->MoveCameraCommands.Num(); Index++)
+	{
+		this->MoveCameraCommands[Index].Scale *= DeltaTime;
+	}
+	this->NumWeightedMoveCameraCommands = this->MoveCameraCommands.Num();
+	this->PendingMoveCameraSeconds += DeltaTime;
+
+	if (this->FixedTimestepAccumulator >= StepSeconds)
+	{
+		// Continue simulating from the last simulated state, not from the interpolated one that was rendered
+		this->ApplySimulationState(this->CurrentSimulationState);
+		this->DeltaSeconds = StepSeconds;
+		this->MoveCameraCommandScale = 1 / FMath::Max(this->PendingMoveCameraSeconds, UE_SMALL_NUMBER);
+
+		auto Steps = 0;
+		while (this->FixedTimestepAccumulator >= StepSeconds && Steps < this->MaxFixedTimestepSteps)
+		{
+			this->PreviousSimulationState = this->CurrentSimulationState;
+			this->RunSimulationStep();
+			this->ConditionallyApplyCameraBounds();
+			this->CurrentSimulationState = this->CaptureSimulationState();
+			this->FixedTimestepAccumulator -= StepSeconds;
+			Steps++;
+		}
+
+		// Drop the time we could not catch up on instead of carrying it into the next frames
+		this->FixedTimestepAccumulator = FMath::Min(this->FixedTimestepAccumulator, StepSeconds);
+	}
+
+	const auto Alpha = this->FixedTimestepAccumulator / StepSeconds;
+	FRTSCameraSimulationState InterpolatedState;
+	InterpolatedState.RootLocation = FMath::Lerp(
+		this->PreviousSimulationState.RootLocation,
+		this->CurrentSimulationState.RootLocation,
+		Alpha
+	);
+	InterpolatedState.TargetArmLength = FMath::Lerp(
+		this->PreviousSimulationState.TargetArmLength,
+		this->CurrentSimulationState.TargetArmLength,
+		Alpha
+	);
+	this->ApplySimulationState(InterpolatedState);
+
+	// Following is resolved against the rendered frame so the camera does not trail the target by a step
+	if (this->HasFollowTarget())
+	{
+		this->FollowTargetIfSet();
+		this->ConditionallyApplyCameraBounds();
+		this->CurrentSimulationState.RootLocation = this->Root->GetComponentLocation();
+		this->PreviousSimulationState.RootLocation = this->CurrentSimulationState.RootLocation;
+	}
+
+	// RenderedSimulationState is captured in FinishCameraTick, after the ground and the bounds have been applied
+}
+
+// Runs the sub-steps of RTSCameraKinematics::Step on the camera's state, then the ground trace which needs the world.
+// The bounds are clamped after the ground trace by the caller, or by URTSCameraSubsystem when batched.
+void URTSCamera::RunSimulationStep()
+{
+	this->HasConsumedMoveCameraCommands = true;
+
+	RTSCameraKinematics::FStepInput Input;
+	Input.EnableEdgeScrolling = this->EnableEdgeScrolling;
+	Input.IsDragging = this->IsDragging;
+	Input.DeltaSeconds = this->DeltaSeconds;
+
+	RTSCameraKinematics::FStepSettings Settings;
+	Settings.ZoomCatchupSpeed = this->ZoomCatchupSpeed;
+
+	RTSCameraKinematics::FState State;
+	State.RootLocation = ToKinematics(this->Root->GetComponentLocation());
+	State.RootForward = ToKinematics(this->Root->GetForwardVector());
+	State.RootRight = ToKinematics(this->Root->GetRightVector());
+	State.TargetArmLength = this->SpringArm->TargetArmLength;
+	State.DesiredZoomLength = this->DesiredZoomLength;
+	State.MoveSpeed = this->MoveSpeed;
+	State.EdgeScrollSpeed = this->EdgeScrollSpeed;
+
+	{
+		RTSCAMERA_STAGE_SCOPE(MoveCommands);
+
+		auto& MoveCommands = this->KinematicsMoveCommandsScratch;
+		MoveCommands.Reset();
+		for (const auto& [X, Y, Scale] : this->MoveCameraCommands)
+		{
+			MoveCommands.Add({X, Y, Scale * this->MoveCameraCommandScale});
+		}
+
+		Input.MoveCommands = MoveCommands.GetData();
+		Input.NumMoveCommands = MoveCommands.Num();
+		RTSCameraKinematics::ApplyMoveCommands(State, Input);
+	}
+
+	{
+		RTSCAMERA_STAGE_SCOPE(EdgeScrolling);
+
+		if (this->EnableEdgeScrolling && !this->IsDragging)
+		{
+			// Only sampled when it is used so that recordings do not carry cursors nothing read
+			const auto& Cursor = this->GetCursorSnapshot();
+			Input.MousePosition = ToKinematics(Cursor.ViewportMousePosition);
+			Input.ViewportSize = ToKinematics(Cursor.ViewportSize);
+		}
+
+		const auto EdgeScroll = RTSCameraKinematics::ApplyEdgeScrolling(State, Input);
+		this->Root->SetWorldLocation(FromKinematics(State.RootLocation));
+
+		// Zero whenever edge scrolling was skipped, so that disabling it or starting a drag ends the edge scroll pan
+		RTSMouseLeftMovement = -1 * EdgeScroll.Left;
+		RTSMouseRightMovement = EdgeScroll.Right;
+		RTSMouseUpMovement = EdgeScroll.Up;
+		RTSMouseDownMovement = -1 * EdgeScroll.Down;
+	}
+
+	{
+		RTSCAMERA_STAGE_SCOPE(ZoomSmoothing);
+		RTSCameraKinematics::SmoothZoom(State, Input, Settings);
+		this->SpringArm->TargetArmLength = State.TargetArmLength;
+	}
+
+	if (!this->IsGroundAndBoundsBatched)
+	{
+		this->ConditionallyKeepCameraAtDesiredZoomAboveGround();
+	}
+}
+
+FRTSCameraSimulationState URTSCamera::CaptureSimulationState() const
+{
+	FRTSCameraSimulationState State;
+	State.RootLocation = this->Root->GetComponentLocation();
+	State.TargetArmLength = this->SpringArm->TargetArmLength;
+	return State;
+}
+
+void URTSCamera::ApplySimulationState(const FRTSCameraSimulationState& State) const
+{
+	this->Root->SetWorldLocation(State.RootLocation);
+	this->SpringArm->TargetArmLength = State.TargetArmLength;
+}
+
+
+
+//"RTSSelector.h"
+
+void URTSCamera::HandleSelectedActors_Implementation(const TArray<AActor*>& NewSelectedActors)//HandleSelectedActors_Implementation
+{
+	RTSCAMERA_LLM_SCOPE(Selection);
+
+	// Large drags are cut down to MaxSelectionCount before anything downstream sees them.
+	// Borrowed from the camera like DeselectedActors below
+	auto LimitedSelection = MoveTemp(this->LimitedSelectionScratch);
+	LimitedSelection.Reset();
+	this->NumDroppedFromLastSelection = 0;
+	const auto IsLimited = this->MaxSelectionCount > 0 && NewSelectedActors.Num() > this->MaxSelectionCount;
+	if (IsLimited)
+	{
+		this->LimitSelection(NewSelectedActors, LimitedSelection);
+	}
+	const auto& Selection = IsLimited ? LimitedSelection : NewSelectedActors;
+
+	// Work out who leaves the selection before touching it, events are dispatched in a separate pass.
+	// Borrowed from the camera so that repeated selections reuse its memory, a handler selecting again gets a new one
+	auto DeselectedActors = MoveTemp(this->DeselectedActorsScratch);
+	DeselectedActors.Reset();
+	{
+		RTSCAMERA_STAGE_SCOPE(SelectionDiff);
+
+		// Convert NewSelectedActors to a set for efficient lookup 将新选定的演员转换为一个集合，以便高效查找。
+		auto& NewSelectedActorSet = this->NewSelectedActorSetScratch;
+		NewSelectedActorSet.Reset();
+		NewSelectedActorSet.Reserve(Selection.Num());
+		for (const auto& Actor : Selection)
+		{
+			NewSelectedActorSet.Add(Actor);
+		}
+
+		// Iterate over currently selected actors 循环遍历当前选中的演员。 清除旧选新的才使用
+		for (const auto& Selected : SelectedActors)//SelectedActors
+		{
+			// Check if the actor is not in the new selection 检查演员是否不在新选择中
+			if (!NewSelectedActorSet.Contains(Selected->GetOwner()))
+			{
+				DeselectedActors.Add(Selected);
+			}
+		}
+	}
+
+	{
+		RTSCAMERA_STAGE_SCOPE(SelectionDispatch);
+
+		// Call OnDeselected for actors that are no longer selected 对不再被选中的演员调用取消选中
+		for (const auto& Deselected : DeselectedActors)
+		{
+			Deselected->OnDeselected();
+		}
+	}
+
+	{
+		RTSCAMERA_STAGE_SCOPE(SelectionDiff);
+
+		// Clear the current selection 清除当前选择
+		TGuardValue<bool> ReplacingSelectionGuard(this->IsReplacingSelection, true);
+		ClearSelectedActors();
+
+		// Add new selected actors 添加新的选定演员
+		for (const auto& Actor : Selection)
+		{
+			if (URTSSelectable* SelectableComponent = Actor->FindComponentByClass<URTSSelectable>())
+			{
+				this->SelectedActors.Add(SelectableComponent);
+			}
+		}
+	}
+
+	{
+		RTSCAMERA_STAGE_SCOPE(SelectionDispatch);
+
+		// Call OnSelected for the new selection 调用OnSelected
+		// Dispatched from a copy, handlers may select or deselect and change SelectedActors underneath
+		auto NewlySelectedActors = MoveTemp(this->NewlySelectedActorsScratch);
+		NewlySelectedActors.Reset();
+		NewlySelectedActors.Append(this->SelectedActors);
+		for (const auto& Selected : NewlySelectedActors)
+		{
+			Selected->OnSelected();
+		}
+		this->NewlySelectedActorsScratch = MoveTemp(NewlySelectedActors);
+	}
+
+	// The selection panel is about to show the selected types
+	if (const auto AssetPrefetch = this->GetAssetPrefetchSubsystem())
+	{
+		for (const auto& Selected : this->SelectedActors)
+		{
+			AssetPrefetch->Prefetch(Selected);
+		}
+	}
+
+	this->ConditionallyReplicateSelection();
+	this->DeselectedActorsScratch = MoveTemp(DeselectedActors);
+	this->LimitedSelectionScratch = MoveTemp(LimitedSelection);
+}
+
+void URTSCamera::LimitSelection(const TArray<AActor*>& Actors, TArray<AActor*>& OutSelection)
+{
+	RTSCAMERA_STAGE_SCOPE(SelectionDiff);
+
+	const auto Focus = this->GetSelectionFocus();
+	auto& Candidates = this->SelectionCandidatesScratch;
+	Candidates.Reset();
+	for (const auto Actor : Actors)
+	{
+		if (const auto Selectable = Actor != nullptr ? Actor->FindComponentByClass<URTSSelectable>() : nullptr)
+		{
+			const auto DistanceSquared = FVector::DistSquared2D(Actor->GetActorLocation(), Focus);
+			Candidates.Add({Actor, Selectable->SelectionPriority, DistanceSquared});
+		}
+	}
+
+	const auto IsByPriority = this->SelectionOrder == ERTSSelectionOrder::Priority;
+	const auto IsBefore = [IsByPriority](const FSelectionCandidate& A, const FSelectionCandidate& B)
+	{
+		if (IsByPriority && A.Priority != B.Priority)
+		{
+			return A.Priority > B.Priority;
+		}
+		return A.DistanceSquared < B.DistanceSquared;
+	};
+
+	// Only the kept units are sorted, best first for selection panels, the rest are just partitioned off
+	const auto NumKept = FMath::Min(this->MaxSelectionCount, Candidates.Num());
+	RTSSelectionTopK::SelectFirst(Candidates.GetData(), Candidates.Num(), NumKept, IsBefore);
+	TArrayView<FSelectionCandidate>(Candidates.GetData(), NumKept).Sort(IsBefore);
+
+	OutSelection.Reserve(NumKept);
+	for (auto Index = 0; Index < NumKept; Index++)
+	{
+		OutSelection.Add(Candidates[Index].Actor);
+	}
+
+	this->NumDroppedFromLastSelection = Candidates.Num() - NumKept;
+	UE_LOG(
+		LogOpenRTSCamera,
+		Verbose,
+		TEXT("Selection capped at %d units, %d dropped"),
+		NumKept,
+		this->NumDroppedFromLastSelection
+	);
+}
+
+FVector URTSCamera::GetSelectionFocus() const
+{
+	// The ground under the middle of the last selection box, or under the middle of the screen without one
+	const auto BoxCenter = (this->SelectionStart + this->SelectionEnd) * 0.5;
+	const auto GroundHeight = this->Root->GetComponentLocation().Z;
+	FVector WorldLocation;
+	FVector WorldDirection;
+	if (
+		this->PlayerController != nullptr
+		&& this->PlayerController->DeprojectScreenPositionToWorld(
+			BoxCenter.X,
+			BoxCenter.Y,
+			WorldLocation,
+			WorldDirection
+		)
+		&& WorldDirection.Z < -UE_KINDA_SMALL_NUMBER
+	)
+	{
+		return WorldLocation + WorldDirection * ((GroundHeight - WorldLocation.Z) / WorldDirection.Z);
+	}
+
+	return this->Root->GetComponentLocation();
+}
+
+int32 URTSCamera::GetNumDroppedFromLastSelection() const
+{
+	return this->NumDroppedFromLastSelection;
+}
+
+void URTSCamera::ClearSelectedActors_Implementation()//ClearSelectedActors_Implementation
+{
+	this->SelectedActors.Reset();
+
+	// Commands naming the latest selection must not act on units that were deselected
+	if (!this->IsReplacingSelection)
+	{
+		this->ConditionallyReplicateSelection();
+	}
+}
+
+void URTSCamera::GetSelectedUnits(TArray<AActor*>& OutUnits) const
+{
+	RTSCAMERA_LLM_SCOPE(Selection);
+
+	OutUnits.Reset();
+	for (const auto Selected : this->SelectedActors)
+	{
+		if (Selected != nullptr)
+		{
+			Selected->AppendUnits(OutUnits);
+		}
+	}
+}
+
+int32 URTSCamera::GetSelectionSequence() const
+{
+	return this->SelectionSender.Sequence;
+}
+
+float URTSCamera::GetZoomAlpha() const
+{
+	return UKismetMathLibrary::NormalizeToRange(
+		this->DesiredZoomLength,
+		this->MinimumZoomLength,
+		this->MaximumZoomLength
+	);
+}
+
+const FRTSCameraViewFootprint& URTSCamera::GetViewFootprint() const
+{
+	return this->ViewFootprint;
+}
+
+bool URTSCamera::GetViewSnapshot(FRTSCameraViewSnapshot& OutSnapshot) const
+{
+	return this->ViewSnapshotBuffer->Read(OutSnapshot);
+}
+
+TSharedRef<const FRTSCameraViewSnapshotBuffer, ESPMode::ThreadSafe> URTSCamera::GetViewSnapshotBuffer() const
+{
+	return this->ViewSnapshotBuffer.ToSharedRef();
+}
+
+bool URTSCamera::GetReplicatedSelection(const int32 Sequence, TArray<AActor*>& OutActors) const
+{
+	const auto UnitIds = this->SelectionReceiver.Find(Sequence);
+	const auto Subsystem = this->GetWorld()->GetSubsystem<URTSCameraSubsystem>();
+	if (UnitIds == nullptr || Subsystem == nullptr)
+	{
+		return false;
+	}
+
+	// Units that died since the selection was made are left out
+	OutActors.Reserve(OutActors.Num() + UnitIds->Num());
+	for (const auto UnitId : *UnitIds)
+	{
+		if (const auto Selectable = Subsystem->FindSelectableByUnitId(UnitId))
+		{
+			OutActors.Add(Selectable->GetOwner());
+		}
+	}
+
+	return true;
+}
+
+void URTSCamera::ConditionallyReplicateSelection()
+{
+	RTSCAMERA_LLM_SCOPE(Replication);
+
+	if (!this->EnableSelectionReplication || this->GetNetMode() == NM_Standalone)
+	{
+		return;
+	}
+
+	auto& UnitIds = this->SelectionUnitIdsScratch;
+	UnitIds.Reset();
+	for (const auto Selected : this->SelectedActors)
+	{
+		// Selectables the server does not know about cannot be named
+		if (Selected != nullptr && Selected->UnitId != 0)
+		{
+			UnitIds.Add(Selected->UnitId);
+		}
+	}
+	UnitIds.Sort();
+
+	int32 Sequence;
+	bool IsKeyframe;
+	TArray<uint8> SelectionDelta;
+	if (this->SelectionSender.MakeUpdate(UnitIds, Sequence, IsKeyframe, SelectionDelta))
+	{
+		// Reliable and ordered, so every delta applies to the selection before it
+		this->ServerUpdateSelection(Sequence, IsKeyframe, SelectionDelta);
+	}
+}
+
+void URTSCamera::ServerUpdateSelection_Implementation(
+	const int32 Sequence,
+	const bool IsKeyframe,
+	const TArray<uint8>& SelectionDelta
+)
+{
+	RTSCAMERA_LLM_SCOPE(Replication);
+
+	using RTSSelectionReplication::EReceiveResult;
+	if (this->SelectionReceiver.Receive(Sequence, IsKeyframe, SelectionDelta) == EReceiveResult::ResyncNeeded)
+	{
+		// Every delta after this one would be diffed against a selection the server does not have
+		UE_LOG(
+			LogOpenRTSCamera,
+			Warning,
+			TEXT("Rejected selection %d of %s, asking for a keyframe"),
+			Sequence,
+			*GetNameSafe(this->GetOwner())
+		);
+		this->ClientResetSelectionSync();
+	}
+}
+
+void URTSCamera::ClientResetSelectionSync_Implementation()
+{
+	this->SelectionSender.Reset();
+	this->ConditionallyReplicateSelection();
+}
+
+void URTSCamera::SetupPlayerInputComponent(UInputComponent* PlayerInputComponent)
+{
+	if (const auto InputComponent = Cast<UEnhancedInputComponent>(PlayerInputComponent))
+	{
+		InputComponent->BindAction(this->BeginSelection, ETriggerEvent::Started, this, &URTSCamera::OnSelectionStart);
+		InputComponent->BindAction(this->BeginSelection, ETriggerEvent::Completed, this, &URTSCamera::OnSelectionEnd);
+	}
+}
+
+//"RTSSelector.h"
+
+
+
+
+
+
+void URTSCamera::FollowTarget(AActor* Target)
+{
+	this->RemoveFollowTargetTickPrerequisites();
+	this->ClearFollowGroup();
+	this->CameraFollowTarget = Target;
+	this->AddFollowTargetTickPrerequisites();
+	this->SetCameraState(
+		Target != nullptr
+			? this->CameraState | ERTSCameraStateFlags::Following
+			: this->CameraState & ~ERTSCameraStateFlags::Following
+	);
+}
+
+void URTSCamera::FollowTargets(const TArray<AActor*>& Targets)
+{
+	RTSCAMERA_LLM_SCOPE(Camera);
+
+	this->RemoveFollowTargetTickPrerequisites();
+	this->CameraFollowTarget = nullptr;
+	this->ClearFollowGroup();
+
+	// Members report their own moves, the group never walks all of them to find out where it is
+	this->FollowGroup.OutlierScale = this->FollowGroupOutlierScale;
+	for (const auto Target : Targets)
+	{
+		const auto RootComponent = Target != nullptr ? Target->GetRootComponent() : nullptr;
+		if (RootComponent == nullptr)
+		{
+			continue;
+		}
+
+		const auto MemberId = this->FollowGroup.Add(ToKinematics(RootComponent->GetComponentLocation()));
+		if (MemberId >= this->FollowGroupMembers.Num())
+		{
+			this->FollowGroupMembers.SetNum(MemberId + 1);
+		}
+
+		auto& Member = this->FollowGroupMembers[MemberId];
+		Member.RootComponent = RootComponent;
+		Member.TransformUpdatedHandle = RootComponent->TransformUpdated.AddUObject(
+			this,
+			&URTSCamera::OnFollowGroupMemberMoved,
+			MemberId
+		);
+	}
+
+	this->SetCameraState(
+		this->HasFollowTarget()
+			? this->CameraState | ERTSCameraStateFlags::Following
+			: this->CameraState & ~ERTSCameraStateFlags::Following
+	);
+}
+
+void URTSCamera::FollowSelection()
+{
+	TArray<AActor*> Targets;
+	Targets.Reserve(this->SelectedActors.Num());
+	for (const auto Selectable : this->SelectedActors)
+	{
+		if (Selectable != nullptr)
+		{
+			Targets.Add(Selectable->GetOwner());
+		}
+	}
+
+	this->FollowTargets(Targets);
+}
+
+AActor* URTSCamera::GetFollowTarget() const
+{
+	return this->CameraFollowTarget;
+}
+
+bool URTSCamera::HasFollowTarget() const
+{
+	return this->CameraFollowTarget != nullptr || this->FollowGroup.Num() > 0;
+}
+
+void URTSCamera::ClearFollowGroup()
+{
+	for (const auto& Member : this->FollowGroupMembers)
+	{
+		if (const auto RootComponent = Member.RootComponent.Get())
+		{
+			RootComponent->TransformUpdated.Remove(Member.TransformUpdatedHandle);
+		}
+	}
+
+	this->FollowGroupMembers.Reset();
+	this->FollowGroup.Reset();
+	this->FollowGroupReclassifyCursor = 0;
+}
+
+void URTSCamera::OnFollowGroupMemberMoved(
+	USceneComponent* UpdatedComponent,
+	EUpdateTransformFlags UpdateTransformFlags,
+	ETeleportType Teleport,
+	const int32 MemberId
+)
+{
+	this->FollowGroup.Move(MemberId, ToKinematics(UpdatedComponent->GetComponentLocation()));
+}
+
+// Drops members that went away, checks a few members that stood still against where the group went, and frames the
+// group. Costs the same no matter how large the group is.
+void URTSCamera::UpdateFollowGroup(const float DeltaTime)
+{
+	if (this->FollowGroup.Num() == 0)
+	{
+		return;
+	}
+
+	RTSCAMERA_STAGE_SCOPE(Follow);
+
+	this->FollowGroup.OutlierScale = this->FollowGroupOutlierScale;
+	const auto NumReclassifications = FMath::Min(
+		this->FollowGroupReclassificationsPerTick,
+		this->FollowGroup.GetMaxId()
+	);
+	for (auto Index = 0; Index < NumReclassifications && this->FollowGroup.Num() > 0; Index++)
+	{
+		const auto MemberId = this->FollowGroupReclassifyCursor % this->FollowGroup.GetMaxId();
+		this->FollowGroupReclassifyCursor = MemberId + 1;
+
+		auto& Member = this->FollowGroupMembers[MemberId];
+		if (Member.RootComponent.IsValid())
+		{
+			this->FollowGroup.Reclassify(MemberId);
+		}
+		else if (this->FollowGroup.IsValid(MemberId))
+		{
+			this->FollowGroup.Remove(MemberId);
+			Member = FFollowGroupMember();
+		}
+	}
+
+	if (this->FollowGroup.Num() == 0)
+	{
+		this->ClearFollowGroup();
+		return;
+	}
+
+	if (!this->EnableFollowGroupFraming || this->Camera == nullptr)
+	{
+		return;
+	}
+
+	// The framed circle has to fit the narrower of the two view angles
+	const auto TanHalfFieldOfView = FMath::Tan(FMath::DegreesToRadians(this->Camera->FieldOfView) * 0.5);
+	const auto TanHalfViewAngle = FMath::Min(TanHalfFieldOfView, TanHalfFieldOfView / this->GetViewAspectRatio());
+	const auto FramedRadius = this->FollowGroup.GetRadius() * this->FollowGroupFramingScale;
+	const auto FramedZoomLength = FMath::Clamp(
+		FramedRadius / FMath::Max(TanHalfViewAngle, UE_KINDA_SMALL_NUMBER),
+		this->MinimumZoomLength,
+		this->MaximumZoomLength
+	);
+	this->DesiredZoomLength = RTSCameraKinematics::InterpTo(
+		this->DesiredZoomLength,
+		FramedZoomLength,
+		DeltaTime,
+		this->FollowGroupFramingSpeed
+	);
+}
+
+void URTSCamera::UnFollowTarget()
+{
+	this->FollowTarget(nullptr);
+}
+
+// Make sure the target (and whatever moves it) has ticked before the camera copies its location, otherwise the
+// camera trails the target by a frame.
+void URTSCamera::AddFollowTargetTickPrerequisites()
+{
+	if (this->CameraSubsystem != nullptr)
+	{
+		this->CameraSubsystem->RefreshTickPrerequisites();
+		return;
+	}
+
+	if (this->CameraFollowTarget != nullptr)
+	{
+		this->AddTickPrerequisiteActor(this->CameraFollowTarget);
+
+		if (const auto MovementComponent = this->CameraFollowTarget->FindComponentByClass<UMovementComponent>())
+		{
+			this->AddTickPrerequisiteComponent(MovementComponent);
+		}
+	}
+}
+
+void URTSCamera::RemoveFollowTargetTickPrerequisites()
+{
+	if (this->CameraSubsystem == nullptr && this->CameraFollowTarget != nullptr)
+	{
+		this->RemoveTickPrerequisiteActor(this->CameraFollowTarget);
+
+		if (const auto MovementComponent = this->CameraFollowTarget->FindComponentByClass<UMovementComponent>())
+		{
+			this->RemoveTickPrerequisiteComponent(MovementComponent);
+		}
+	}
+}
+
+void URTSCamera::StartInputRecording()
+{
+	RTSCAMERA_LLM_SCOPE(InputRecording);
+
+	this->InputRecorder = MakeUnique<FRTSCameraInputRecorder>(this->CaptureRecordingStart());
+
+	// Force the first frame to write a full cursor snapshot, an override is not sampled again so it goes in right away
+	this->CursorSnapshotFrame = MAX_uint64;
+	if (this->HasCursorOverride)
+	{
+		this->InputRecorder->RecordCursor(this->CursorSnapshot);
+	}
+	this->bIsFirstTick = true;
+}
+
+TArray<uint8> URTSCamera::StopInputRecording()
+{
+	TArray<uint8> Recording;
+	if (this->InputRecorder.IsValid())
+	{
+		Recording = this->InputRecorder->GetData();
+		this->InputRecorder.Reset();
+	}
+
+	return Recording;
+}
+
+bool URTSCamera::StopInputRecordingToFile(const FString& FilePath)
+{
+	return this->IsRecordingInput() && FFileHelper::SaveArrayToFile(this->StopInputRecording(), *FilePath);
+}
+
+bool URTSCamera::StartInputReplay(const TArray<uint8>& Recording)
+{
+	RTSCAMERA_LLM_SCOPE(InputRecording);
+
+	auto Player = MakeUnique<FRTSCameraInputPlayer>(Recording);
+	if (!Player->IsValid())
+	{
+		UE_LOG(LogOpenRTSCamera, Error, TEXT("The camera input recording is not valid and cannot be replayed."));
+		return false;
+	}
+
+	const auto& Start = Player->GetStart();
+	this->Root->SetWorldLocationAndRotation(Start.RootLocation, Start.RootRotation);
+	this->SpringArm->SetRelativeRotation(Start.SpringArmRotation);
+	this->SpringArm->TargetArmLength = Start.TargetArmLength;
+	this->DesiredZoomLength = Start.DesiredZoomLength;
+	this->ZoomSpeed = Start.ZoomSpeed;
+	this->MoveSpeed = Start.MoveSpeed;
+	this->EdgeScrollSpeed = Start.EdgeScrollSpeed;
+	this->SpringArmLocalRotation = Start.SpringArmRotation;
+	this->bIsFirstTick = true;
+	this->IsDragging = false;
+	this->HasSimulationState = false;
+	this->MoveCameraCommands.Reset();
+	this->NumWeightedMoveCameraCommands = 0;
+	this->PendingMoveCameraSeconds = 0;
+
+	this->InputRecorder.Reset();
+	this->InputPlayer = MoveTemp(Player);
+	return true;
+}
+
+bool URTSCamera::StartInputReplayFromFile(const FString& FilePath)
+{
+	TArray<uint8> Recording;
+	if (!FFileHelper::LoadFileToArray(Recording, *FilePath))
+	{
+		UE_LOG(LogOpenRTSCamera, Error, TEXT("Could not read camera input recording %s."), *FilePath);
+		return false;
+	}
+
+	return this->StartInputReplay(Recording);
+}
+
+void URTSCamera::StopInputReplay()
+{
+	this->InputPlayer.Reset();
+	this->CursorSnapshotFrame = MAX_uint64;
+}
+
+bool URTSCamera::IsRecordingInput() const
+{
+	return this->InputRecorder.IsValid();
+}
+
+bool URTSCamera::IsReplayingInput() const
+{
+	return this->InputPlayer.IsValid();
+}
+
+void URTSCamera::InjectInput(const ERTSCameraInputEvent Event, const FInputActionValue& Value)
+{
+	this->DispatchInput(Event, Value);
+}
+
+void URTSCamera::SetCursorOverride(const FRTSCameraCursorSnapshot& Cursor)
+{
+	this->HasCursorOverride = true;
+	this->CursorSnapshot = Cursor;
+
+	if (this->InputRecorder.IsValid())
+	{
+		this->InputRecorder->RecordCursor(this->CursorSnapshot);
+	}
+}
+
+void URTSCamera::ClearCursorOverride()
+{
+	this->HasCursorOverride = false;
+	this->CursorSnapshotFrame = MAX_uint64;
+}
+
+// Every input handler goes through here first, so that the input can be recorded and so that live input is ignored
+// while a recording is being replayed.
+bool URTSCamera::ShouldHandleInput(const ERTSCameraInputEvent Event, const FInputActionValue& Value)
+{
+	if (this->InputPlayer.IsValid() && !this->IsDispatchingReplayedInput)
+	{
+		return false;
+	}
+
+	if (this->InputRecorder.IsValid())
+	{
+		// The handler is about to read the cursor, make sure it is in the stream before the input is
+		this->GetCursorSnapshot();
+		this->InputRecorder->RecordInput(Event, Value);
+	}
+
+	return true;
+}
+
+const FRTSCameraCursorSnapshot& URTSCamera::GetCursorSnapshot() const
+{
+	if (this->InputPlayer.IsValid() || this->HasCursorOverride || this->CursorSnapshotFrame == GFrameCounter)
+	{
+		return this->CursorSnapshot;
+	}
+
+	this->CursorSnapshotFrame = GFrameCounter;
+	this->CursorSnapshot.ViewportMousePosition = UWidgetLayoutLibrary::GetMousePositionOnViewport(this->GetWorld());
+	this->CursorSnapshot.ViewportSize = UWidgetLayoutLibrary::GetViewportWidgetGeometry(this->GetWorld()).GetLocalSize();
+	if (this->PlayerController)
+	{
+		this->PlayerController->GetMousePosition(
+			this->CursorSnapshot.PlayerMousePosition.X,
+			this->CursorSnapshot.PlayerMousePosition.Y
+		);
+	}
+
+	if (this->InputRecorder.IsValid())
+	{
+		this->InputRecorder->RecordCursor(this->CursorSnapshot);
+	}
+
+	return this->CursorSnapshot;
+}
+
+FRTSCameraRecordingStart URTSCamera::CaptureRecordingStart() const
+{
+	FRTSCameraRecordingStart Start;
+	Start.RootLocation = this->Root->GetComponentLocation();
+	Start.RootRotation = this->Root->GetComponentRotation();
+	Start.SpringArmRotation = this->SpringArm->GetRelativeRotation();
+	Start.TargetArmLength = this->SpringArm->TargetArmLength;
+	Start.DesiredZoomLength = this->DesiredZoomLength;
+	Start.ZoomSpeed = this->ZoomSpeed;
+	Start.MoveSpeed = this->MoveSpeed;
+	Start.EdgeScrollSpeed = this->EdgeScrollSpeed;
+	return Start;
+}
+
+// Feeds the recorded input of one frame through the handlers and returns the delta time that frame was simulated with.
+float URTSCamera::ReplayRecordedFrame(const float DeltaTime)
+{
+	FRTSCameraInputPlayer::FRecord Record;
+	while (this->InputPlayer->ReadNext(Record))
+	{
+		switch (Record.Event)
+		{
+		case ERTSCameraInputEvent::Frame:
+			return Record.DeltaSeconds;
+		case ERTSCameraInputEvent::Cursor:
+			this->CursorSnapshot = Record.Cursor;
+			break;
+		default:
+			{
+				TGuardValue<bool> DispatchGuard(this->IsDispatchingReplayedInput, true);
+				this->DispatchInput(Record.Event, Record.Value);
+			}
+			break;
+		}
+	}
+
+	this->StopInputReplay();
+	this->OnInputReplayFinished.Broadcast();
+	return DeltaTime;
+}
+
+void URTSCamera::DispatchInput(const ERTSCameraInputEvent Event, const FInputActionValue& Value)
+{
+	switch (Event)
+	{
+	case ERTSCameraInputEvent::ZoomCamera:
+		this->OnZoomCamera(Value);
+		break;
+	case ERTSCameraInputEvent::RotateCamera:
+		this->OnRotateCamera(Value);
+		break;
+	case ERTSCameraInputEvent::TurnCameraLeft:
+		this->OnTurnCameraLeft(Value);
+		break;
+	case ERTSCameraInputEvent::TurnCameraRight:
+		this->OnTurnCameraRight(Value);
+		break;
+	case ERTSCameraInputEvent::MoveCameraYAxis:
+		this->OnMoveCameraYAxis(Value);
+		break;
+	case ERTSCameraInputEvent::MoveCameraXAxis:
+		this->OnMoveCameraXAxis(Value);
+		break;
+	case ERTSCameraInputEvent::DragCamera:
+		this->OnDragCamera(Value);
+		break;
+	case ERTSCameraInputEvent::SelectionStart:
+		this->OnSelectionStart(Value);
+		break;
+	case ERTSCameraInputEvent::UpdateSelection:
+		this->OnUpdateSelection(Value);
+		break;
+	case ERTSCameraInputEvent::SelectionEnd:
+		this->OnSelectionEnd(Value);
+		break;
+	default:
+		break;
+	}
+}
+
+void URTSCamera::OnZoomCamera(const FInputActionValue& Value)
+{	
+	if (!this->ShouldHandleInput(ERTSCameraInputEvent::ZoomCamera, Value))
+	{
+		return;
+	}
+
+	const auto Zoom = RTSCameraKinematics::ApplyZoomInput(
+		this->DesiredZoomLength,
+		Value.Get<float>(),
+		this->MinimumZoomLength,
+		this->MaximumZoomLength
+	);
+	this->ZoomSpeed = Zoom.ZoomSpeed;
+	this->MoveSpeed = Zoom.MoveSpeed;
+	this->EdgeScrollSpeed = Zoom.EdgeScrollSpeed;
+	this->DesiredZoomLength = Zoom.DesiredZoomLength;
+	UE_LOG(LogOpenRTSCamera, VeryVerbose, TEXT("ZoomSpeed: %f,MoveSpeed: %f,DesiredZoomLength: %f"), this->ZoomSpeed, this->MoveSpeed, this->DesiredZoomLength);
+}
+
+void URTSCamera::OnRotateCamera(const FInputActionValue& Value)
+{
+	if (!this->ShouldHandleInput(ERTSCameraInputEvent::RotateCamera, Value))
+	{
+		return;
+	}
+
+	const auto WorldRotation = this->Root->GetComponentRotation();
+	//const auto SpringArmRotation = this->SpringArm->GetComponentRotation();
+	//APlayerController* PlayerController = GetWorld()->GetFirstPlayerController();
+	if (this->PlayerController || this->IsReplayingInput())
+	{
+		// 获取当前鼠标位置
+		const auto& Cursor = this->GetCursorSnapshot();
+		const float MouseX = Cursor.PlayerMousePosition.X;
+		const float MouseY = Cursor.PlayerMousePosition.Y;
+
+		// 比较当前帧和上一帧的鼠标位置
+		if (bIsFirstTick)
+		{
+			LastMouseX = MouseX;
+			LastMouseY = MouseY;
+			bIsFirstTick = false;
+		}
+		else
+		{
+			DeltaX = MouseX - LastMouseX;
+			DeltaY = MouseY - LastMouseY;
+
+			RTSCameraKinematics::FEdgeScroll EdgeScroll;
+			EdgeScroll.Left = RTSMouseLeftMovement;
+			EdgeScroll.Right = RTSMouseRightMovement;
+			EdgeScroll.Up = RTSMouseUpMovement;
+			EdgeScroll.Down = RTSMouseDownMovement;
+
+			const auto Rotation = RTSCameraKinematics::RotationFromCursor(
+				{static_cast<double>(DeltaX), static_cast<double>(DeltaY)},
+				EdgeScroll,
+				this->DesiredZoomLength
+			);
+			RotationX = Rotation.X;
+			RotationY = Rotation.Y;
 
 			// 更新上一帧的鼠标位置
 			LastMouseX = MouseX;
@@ -341,7 +1900,7 @@ void URTSCamera::OnRotateCamera(const FInputActionValue& Value)
 
 
 	SpringArmLocalRotation = this->SpringArm->GetRelativeRotation();
-	UE_LOG(LogTemp, Warning, TEXT("Spring Arm Local Rotation: Pitch: %f, Yaw: %f, Roll: %f"),
+	UE_LOG(LogOpenRTSCamera, VeryVerbose, TEXT("Spring Arm Local Rotation: Pitch: %f, Yaw: %f, Roll: %f"),
 		SpringArmLocalRotation.Pitch, SpringArmLocalRotation.Yaw, SpringArmLocalRotation.Roll);
 
 
@@ -381,8 +1940,13 @@ void URTSCamera::OnRotateCamera(const FInputActionValue& Value)
 	//UE_LOG(LogTemp, Warning, TEXT("Z: %f, Value: %f, DeltaX:%d, DeltaY: %d  "), WorldRotation.Euler().Z, Value.Get<float>(), DeltaX, DeltaY);
 }
 
-void URTSCamera::OnTurnCameraLeft(const FInputActionValue&)
+void URTSCamera::OnTurnCameraLeft(const FInputActionValue& Value)
 {
+	if (!this->ShouldHandleInput(ERTSCameraInputEvent::TurnCameraLeft, Value))
+	{
+		return;
+	}
+
 	const auto WorldRotation = this->Root->GetRelativeRotation();
 	this->Root->SetRelativeRotation(
 		FRotator::MakeFromEuler(
@@ -395,8 +1959,13 @@ void URTSCamera::OnTurnCameraLeft(const FInputActionValue&)
 	);
 }
 
-void URTSCamera::OnTurnCameraRight(const FInputActionValue&)
+void URTSCamera::OnTurnCameraRight(const FInputActionValue& Value)
 {
+	if (!this->ShouldHandleInput(ERTSCameraInputEvent::TurnCameraRight, Value))
+	{
+		return;
+	}
+
 	const auto WorldRotation = this->Root->GetRelativeRotation();
 	this->Root->SetRelativeRotation(
 		FRotator::MakeFromEuler(
@@ -411,6 +1980,11 @@ void URTSCamera::OnTurnCameraRight(const FInputActionValue&)
 
 void URTSCamera::OnMoveCameraYAxis(const FInputActionValue& Value)
 {
+	if (!this->ShouldHandleInput(ERTSCameraInputEvent::MoveCameraYAxis, Value))
+	{
+		return;
+	}
+
 	float YAxisValue = Value.Get<float>();
 	//SpringArmLocalRotation = this->SpringArm->GetRelativeRotation();
 	if (SpringArmLocalRotation.Yaw >= 179.0 || SpringArmLocalRotation.Yaw <= -179.0)
@@ -434,6 +2008,11 @@ void URTSCamera::OnMoveCameraYAxis(const FInputActionValue& Value)
 
 void URTSCamera::OnMoveCameraXAxis(const FInputActionValue& Value)
 {
+	if (!this->ShouldHandleInput(ERTSCameraInputEvent::MoveCameraXAxis, Value))
+	{
+		return;
+	}
+
 	this->RequestMoveCamera(
 		this->SpringArm->GetRightVector().X,
 		this->SpringArm->GetRightVector().Y,
@@ -448,33 +2027,40 @@ void URTSCamera::OnMoveCameraXAxis(const FInputActionValue& Value)
 
 void URTSCamera::OnDragCamera(const FInputActionValue& Value)
 {
+	if (!this->ShouldHandleInput(ERTSCameraInputEvent::DragCamera, Value))
+	{
+		return;
+	}
+
 	if (!this->IsDragging && Value.Get<bool>())
 	{
 		this->IsDragging = true;
-		this->DragStartLocation = UWidgetLayoutLibrary::GetMousePositionOnViewport(this->GetWorld());
+		this->DragStartLocation = this->GetCursorSnapshot().ViewportMousePosition;
 	}
 
 	else if (this->IsDragging && Value.Get<bool>())
 	{
-		const auto MousePosition = UWidgetLayoutLibrary::GetMousePositionOnViewport(this->GetWorld());
-		auto DragExtents = UWidgetLayoutLibrary::GetViewportWidgetGeometry(this->GetWorld()).GetLocalSize();
-		DragExtents *= DragExtent;
-
-		auto Delta = MousePosition - this->DragStartLocation;
-		Delta.X = FMath::Clamp(Delta.X, -DragExtents.X, DragExtents.X) / DragExtents.X;
-		Delta.Y = FMath::Clamp(Delta.Y, -DragExtents.Y, DragExtents.Y) / DragExtents.Y;
+		const auto& Cursor = this->GetCursorSnapshot();
+		const auto Drag = RTSCameraKinematics::DragScale(
+			ToKinematics(Cursor.ViewportMousePosition),
+			ToKinematics(this->DragStartLocation),
+			ToKinematics(Cursor.ViewportSize),
+			this->DragExtent
+		);
 
 		this->RequestMoveCamera(
 			this->SpringArm->GetRightVector().X,
 			this->SpringArm->GetRightVector().Y,
-			Delta.X
+			Drag.X
 		);
 
 		this->RequestMoveCamera(
 			this->SpringArm->GetForwardVector().X,
 			this->SpringArm->GetForwardVector().Y,
-			Delta.Y * -1
+			Drag.Y
 		);
+
+		this->IsDragMoveCalled = Drag.X != 0 || Drag.Y != 0;
 	}
 
 	else if (this->IsDragging && !Value.Get<bool>())
@@ -486,6 +2072,8 @@ void URTSCamera::OnDragCamera(const FInputActionValue& Value)
 
 void URTSCamera::RequestMoveCamera(const float X, const float Y, const float Scale)
 {
+	RTSCAMERA_LLM_SCOPE(Commands);
+
 	FMoveCameraCommand MoveCameraCommand;
 	MoveCameraCommand.X = X;
 	MoveCameraCommand.Y = Y;
@@ -494,49 +2082,40 @@ void URTSCamera::RequestMoveCamera(const float X, const float Y, const float Sca
 	//UE_LOG(LogTemp, Warning, TEXT("RequestMoveCamera: %f,%f,%f"), MoveCameraCommand.X, MoveCameraCommand.Y, MoveCameraCommand.Scale);//方向
 }
 
-void URTSCamera::ApplyMoveCameraCommands()
-{
-	for (const auto& [X, Y, Scale] : this->MoveCameraCommands)
-	{
-		auto Movement = FVector2D(X, Y);
-		Movement.Normalize();
-		Movement *= this->MoveSpeed * Scale * this->DeltaSeconds;
-		this->Root->SetWorldLocation(
-			this->Root->GetComponentLocation() + FVector(Movement.X, Movement.Y, 0.0f)
-		);
-		//UE_LOG(LogTemp, Warning, TEXT("Movement: %f,%f"), Movement.X, Movement.Y);
-	}
-	
-	this->MoveCameraCommands.Empty();
-}
-
 void URTSCamera::CollectComponentDependencyReferences()
 {
 	//初始化的情况
-	this->Owner = this->GetOwner();
-	this->Root = this->Owner->GetRootComponent();
-	this->Camera = Cast<UCameraComponent>(this->Owner->GetComponentByClass(UCameraComponent::StaticClass()));
-	this->SpringArm = Cast<USpringArmComponent>(this->Owner->GetComponentByClass(USpringArmComponent::StaticClass()));
-	this->PlayerController = UGameplayStatics::GetPlayerController(this->GetWorld(), 0);
+	this->CollectOwnerComponentReferences();
+	// With several local players every camera is bound to its own player controller
+	this->PlayerController = this->CameraSubsystem != nullptr
+		? this->CameraSubsystem->FindPlayerControllerForCamera(this)
+		: UGameplayStatics::GetPlayerController(this->GetWorld(), 0);
 
 
 	//this->HUD = Cast<ARTSHUD>(this->PlayerController->GetHUD());
 
 	//"RTSSelector.h"
 	
-	if (const auto PlayerControllerRef = UGameplayStatics::GetPlayerController(this->GetWorld(), 0))
+	if (const auto PlayerControllerRef = this->PlayerController)
 	{
-		this->PlayerController = PlayerControllerRef;
 		this->HUD = Cast<ARTSHUD>(PlayerControllerRef->GetHUD());
 		//UE_LOG(LogTemp, Error, TEXT("USelector!!!!!!!!!"));
 	}
 	else
 	{
-		UE_LOG(LogTemp, Error, TEXT("USelector is not attached to a PlayerController!!!!!!!!!"));
+		UE_LOG(LogOpenRTSCamera, Error, TEXT("USelector is not attached to a PlayerController!!!!!!!!!"));
 	}
 	
 }
 
+void URTSCamera::CollectOwnerComponentReferences()
+{
+	this->Owner = this->GetOwner();
+	this->Root = this->Owner->GetRootComponent();
+	this->Camera = Cast<UCameraComponent>(this->Owner->GetComponentByClass(UCameraComponent::StaticClass()));
+	this->SpringArm = Cast<USpringArmComponent>(this->Owner->GetComponentByClass(USpringArmComponent::StaticClass()));
+}
+
 void URTSCamera::ConfigureSpringArm()
 {
 	this->DesiredZoomLength = this->MaximumZoomLength;
@@ -613,303 +2192,864 @@ void URTSCamera::BindInputMappingContext() const
 {
 	if (PlayerController && PlayerController->GetLocalPlayer())
 	{
-		if (const auto Input = PlayerController->GetLocalPlayer()->GetSubsystem<UEnhancedInputLocalPlayerSubsystem>())
+		if (const auto Input = PlayerController->GetLocalPlayer()->GetSubsystem<UEnhancedInputLocalPlayerSubsystem>())
+		{
+			PlayerController->bShowMouseCursor = true;
+
+			// Check if the context is already bound to prevent double binding
+			if (!Input->HasMappingContext(this->InputMappingContext))
+			{
+				Input->ClearAllMappings();
+				Input->AddMappingContext(this->InputMappingContext, 0);
+			}
+		}
+	}
+}
+
+void URTSCamera::BindInputActions()
+{
+	if (const auto EnhancedInputComponent = Cast<UEnhancedInputComponent>(this->PlayerController->InputComponent))
+	{
+		EnhancedInputComponent->BindAction(
+			this->ZoomCamera,
+			ETriggerEvent::Triggered,
+			this,
+			&URTSCamera::OnZoomCamera
+		);
+
+		EnhancedInputComponent->BindAction(
+			this->RotateCameraAxis,
+			ETriggerEvent::Triggered,
+			this,
+			&URTSCamera::OnRotateCamera
+		);
+
+		EnhancedInputComponent->BindAction(
+			this->TurnCameraLeft,
+			ETriggerEvent::Triggered,
+			this,
+			&URTSCamera::OnTurnCameraLeft
+		);
+
+		EnhancedInputComponent->BindAction(
+			this->TurnCameraRight,
+			ETriggerEvent::Triggered,
+			this,
+			&URTSCamera::OnTurnCameraRight
+		);
+
+		EnhancedInputComponent->BindAction(
+			this->MoveCameraXAxis,
+			ETriggerEvent::Triggered,
+			this,
+			&URTSCamera::OnMoveCameraXAxis
+		);
+
+		EnhancedInputComponent->BindAction(
+			this->MoveCameraYAxis,
+			ETriggerEvent::Triggered,
+			this,
+			&URTSCamera::OnMoveCameraYAxis
+		);
+
+		EnhancedInputComponent->BindAction(
+			this->DragCamera,
+			ETriggerEvent::Triggered,
+			this,
+			&URTSCamera::OnDragCamera
+		);
+
+
+
+		//"RTSSelector.h"
+
+		EnhancedInputComponent->BindAction(
+			this->BeginSelection,
+			ETriggerEvent::Started,
+			this,
+			&URTSCamera::OnSelectionStart
+		);
+
+		EnhancedInputComponent->BindAction(
+			this->BeginSelection,
+			ETriggerEvent::Triggered,
+			this,
+			&URTSCamera::OnUpdateSelection
+		);
+
+		EnhancedInputComponent->BindAction(
+			this->BeginSelection,
+			ETriggerEvent::Completed,
+			this,
+			&URTSCamera::OnSelectionEnd
+		);
+
+	}
+}
+
+void URTSCamera::RequestInputAssets()
+{
+	if (this->InputAssetsHandle.IsValid())
+	{
+		return;
+	}
+
+	// Only inputs the camera does not set itself fall back to the project defaults
+	const auto Settings = GetDefault<URTSCameraSettings>();
+	TArray<FSoftObjectPath> AssetsToLoad;
+	const auto AddIfUnset = [&AssetsToLoad](const UObject* Current, const auto& Default)
+	{
+		if (Current == nullptr && !Default.IsNull())
+		{
+			AssetsToLoad.AddUnique(Default.ToSoftObjectPath());
+		}
+	};
+
+	AddIfUnset(this->InputMappingContext, Settings->InputMappingContext);
+	AddIfUnset(this->RotateCameraAxis, Settings->RotateCameraAxis);
+	AddIfUnset(this->TurnCameraLeft, Settings->TurnCameraLeft);
+	AddIfUnset(this->TurnCameraRight, Settings->TurnCameraRight);
+	AddIfUnset(this->MoveCameraYAxis, Settings->MoveCameraYAxis);
+	AddIfUnset(this->MoveCameraXAxis, Settings->MoveCameraXAxis);
+	AddIfUnset(this->DragCamera, Settings->DragCamera);
+	AddIfUnset(this->ZoomCamera, Settings->ZoomCamera);
+	AddIfUnset(this->BeginSelection, Settings->BeginSelection);
+
+	if (AssetsToLoad.Num() > 0)
+	{
+		this->InputAssetsHandle = UAssetManager::GetStreamableManager().RequestAsyncLoad(
+			AssetsToLoad,
+			FStreamableDelegate::CreateUObject(this, &URTSCamera::OnInputAssetsLoaded),
+			FStreamableManager::AsyncLoadHighPriority
+		);
+	}
+}
+
+void URTSCamera::OnInputAssetsLoaded()
+{
+	if (this->IsInputBindingPending)
+	{
+		this->IsInputBindingPending = false;
+		this->BindInputs();
+	}
+}
+
+void URTSCamera::ApplyDefaultInputAssets()
+{
+	const auto Settings = GetDefault<URTSCameraSettings>();
+	const auto ApplyIfUnset = [](auto*& Current, const auto& Default)
+	{
+		if (Current == nullptr)
+		{
+			Current = Default.Get();
+		}
+	};
+
+	ApplyIfUnset(this->InputMappingContext, Settings->InputMappingContext);
+	ApplyIfUnset(this->RotateCameraAxis, Settings->RotateCameraAxis);
+	ApplyIfUnset(this->TurnCameraLeft, Settings->TurnCameraLeft);
+	ApplyIfUnset(this->TurnCameraRight, Settings->TurnCameraRight);
+	ApplyIfUnset(this->MoveCameraYAxis, Settings->MoveCameraYAxis);
+	ApplyIfUnset(this->MoveCameraXAxis, Settings->MoveCameraXAxis);
+	ApplyIfUnset(this->DragCamera, Settings->DragCamera);
+	ApplyIfUnset(this->ZoomCamera, Settings->ZoomCamera);
+	ApplyIfUnset(this->BeginSelection, Settings->BeginSelection);
+
+	// The properties keep the assets alive from here on
+	if (this->InputAssetsHandle.IsValid())
+	{
+		this->InputAssetsHandle->ReleaseHandle();
+		this->InputAssetsHandle.Reset();
+	}
+}
+
+void URTSCamera::BindInputs()
+{
+	this->ApplyDefaultInputAssets();
+
+	if (this->PlayerController == nullptr)
+	{
+		return;
+	}
+
+	this->BindInputMappingContext();
+	this->BindInputActions();
+}
+
+void URTSCamera::UnbindInputs()
+{
+	if (this->PlayerController == nullptr)
+	{
+		return;
+	}
+
+	if (const auto EnhancedInputComponent = Cast<UEnhancedInputComponent>(this->PlayerController->InputComponent))
+	{
+		EnhancedInputComponent->ClearBindingsForObject(this);
+	}
+
+	const auto LocalPlayer = this->PlayerController->GetLocalPlayer();
+	if (LocalPlayer != nullptr && this->InputMappingContext != nullptr)
+	{
+		if (const auto Input = LocalPlayer->GetSubsystem<UEnhancedInputLocalPlayerSubsystem>())
+		{
+			Input->RemoveMappingContext(this->InputMappingContext);
+		}
+	}
+}
+
+void URTSCamera::SetActiveCamera() const
+{
+	this->PlayerController->SetViewTarget(this->GetOwner());
+}
+
+void URTSCamera::JumpTo(const FVector Position) const
+{
+	this->Root->SetWorldLocation(Position);
+}
+
+void URTSCamera::JumpToWithPrewarm(const FVector Position)
+{
+	if (!this->IsLocalCamera)
+	{
+		this->JumpTo(Position);
+		return;
+	}
+
+	this->JumpPhase = EJumpPhase::Prewarming;
+	this->JumpDestination = Position;
+	this->JumpElapsedTime = 0;
+	this->UpdateStreamingSourceRegistration();
+
+	// Texture streaming looks from where the eye will be, for as long as the jump may take
+	const auto EyeOffset = this->Camera != nullptr
+		? this->Camera->GetComponentLocation() - this->Root->GetComponentLocation()
+		: FVector::ZeroVector;
+	const auto ScreenSize = FMath::Max(this->GetCursorSnapshot().ViewportSize.X, 1.0);
+	const auto FieldOfView = this->Camera != nullptr ? this->Camera->FieldOfView : 90.f;
+	IStreamingManager::Get().AddViewLocation(
+		Position + EyeOffset,
+		static_cast<float>(ScreenSize),
+		static_cast<float>(ScreenSize / FMath::Tan(FMath::DegreesToRadians(FieldOfView * 0.5))),
+		1.f,
+		false,
+		this->JumpPrewarmTimeout + this->JumpTransitionDuration
+	);
+}
+
+void URTSCamera::CancelJump()
+{
+	this->JumpPhase = EJumpPhase::None;
+	this->UpdateStreamingSourceRegistration();
+}
+
+bool URTSCamera::IsJumpPending() const
+{
+	return this->JumpPhase != EJumpPhase::None;
+}
+
+ERTSCameraStateFlags URTSCamera::GetCameraState() const
+{
+	return this->CameraState;
+}
+
+bool URTSCamera::HasCameraState(const ERTSCameraStateFlags Flag) const
+{
+	return EnumHasAnyFlags(this->CameraState, Flag);
+}
+
+bool URTSCamera::IsPanning() const
+{
+	return EnumHasAnyFlags(this->CameraState, RTSCameraState::PanFlags);
+}
+
+// Gathers what the camera did this tick from the per-tick input flags, before they are reset
+void URTSCamera::UpdateCameraState()
+{
+	auto NewState = ERTSCameraStateFlags::None;
+	if (this->bIsMoveCameraXAxisCalled || this->bIsMoveCameraYAxisCalled)
+	{
+		NewState |= ERTSCameraStateFlags::KeyboardPan;
+	}
+	if (
+		this->RTSMouseLeftMovement != 0
+		|| this->RTSMouseRightMovement != 0
+		|| this->RTSMouseUpMovement != 0
+		|| this->RTSMouseDownMovement != 0
+	)
+	{
+		NewState |= ERTSCameraStateFlags::EdgeScrollPan;
+	}
+	if (this->IsDragMoveCalled)
+	{
+		NewState |= ERTSCameraStateFlags::DragPan;
+	}
+	if (this->IsDragging)
+	{
+		NewState |= ERTSCameraStateFlags::Dragging;
+	}
+	if (this->HasFollowTarget())
+	{
+		NewState |= ERTSCameraStateFlags::Following;
+	}
+	if (this->IsJumpPending())
+	{
+		NewState |= ERTSCameraStateFlags::Jumping;
+	}
+	this->SetCameraState(NewState);
+
+	if (this->ViewFootprint.IsValid)
+	{
+		const auto OldZoomBand = this->BroadcastZoomBand;
+		const auto HadZoomBand = this->HasBroadcastZoomBand;
+		this->BroadcastZoomBand = this->ViewFootprint.ZoomBand;
+		this->HasBroadcastZoomBand = true;
+
+		if (HadZoomBand && OldZoomBand != this->BroadcastZoomBand)
+		{
+			this->OnZoomBandChanged.Broadcast(this->BroadcastZoomBand, OldZoomBand);
+		}
+	}
+}
+
+// Broadcasts the transitions from the current state, only ever fires when something changed
+void URTSCamera::SetCameraState(const ERTSCameraStateFlags NewState)
+{
+	const auto OldState = this->CameraState;
+	const auto NewFollowTarget = EnumHasAnyFlags(NewState, ERTSCameraStateFlags::Following)
+		? this->CameraFollowTarget
+		: nullptr;
+	const auto IsFollowTargetChanged = NewFollowTarget != nullptr && this->BroadcastFollowTarget.Get() != NewFollowTarget;
+	if (NewState == OldState && !IsFollowTargetChanged)
+	{
+		return;
+	}
+
+	// Updated before broadcasting, handlers may change the state again
+	this->CameraState = NewState;
+	this->BroadcastFollowTarget = NewFollowTarget;
+
+	const auto ChangedState = OldState ^ NewState;
+	if (ChangedState != ERTSCameraStateFlags::None)
+	{
+		this->OnCameraStateChanged.Broadcast(static_cast<int32>(NewState), static_cast<int32>(OldState));
+	}
+
+	const auto OldPan = OldState & RTSCameraState::PanFlags;
+	const auto NewPan = NewState & RTSCameraState::PanFlags;
+	if (OldPan == ERTSCameraStateFlags::None && NewPan != ERTSCameraStateFlags::None)
+	{
+		this->OnPanStarted.Broadcast(static_cast<int32>(NewPan));
+	}
+	else if (OldPan != ERTSCameraStateFlags::None && NewPan == ERTSCameraStateFlags::None)
+	{
+		this->OnPanStopped.Broadcast();
+	}
+
+	if (EnumHasAnyFlags(ChangedState, ERTSCameraStateFlags::Dragging))
+	{
+		if (EnumHasAnyFlags(NewState, ERTSCameraStateFlags::Dragging))
+		{
+			this->OnDragStarted.Broadcast();
+		}
+		else
+		{
+			this->OnDragEnded.Broadcast();
+		}
+	}
+
+	if (IsFollowTargetChanged)
+	{
+		this->OnFollowStarted.Broadcast(NewFollowTarget);
+	}
+	else if (EnumHasAnyFlags(ChangedState, ERTSCameraStateFlags::Following))
+	{
+		if (EnumHasAnyFlags(NewState, ERTSCameraStateFlags::Following))
 		{
-			PlayerController->bShowMouseCursor = true;
-
-			// Check if the context is already bound to prevent double binding
-			if (!Input->HasMappingContext(this->InputMappingContext))
-			{
-				Input->ClearAllMappings();
-				Input->AddMappingContext(this->InputMappingContext, 0);
-			}
+			// Following a group, there is no single target to name
+			this->OnFollowStarted.Broadcast(nullptr);
+		}
+		else
+		{
+			this->OnFollowStopped.Broadcast();
 		}
 	}
 }
 
-void URTSCamera::BindInputActions()
+void URTSCamera::TickJump(const float DeltaTime)
 {
-	if (const auto EnhancedInputComponent = Cast<UEnhancedInputComponent>(this->PlayerController->InputComponent))
+	if (this->JumpPhase == EJumpPhase::None)
 	{
-		EnhancedInputComponent->BindAction(
-			this->ZoomCamera,
-			ETriggerEvent::Triggered,
-			this,
-			&URTSCamera::OnZoomCamera
-		);
+		return;
+	}
 
-		EnhancedInputComponent->BindAction(
-			this->RotateCameraAxis,
-			ETriggerEvent::Triggered,
-			this,
-			&URTSCamera::OnRotateCamera
-		);
+	this->JumpElapsedTime += DeltaTime;
+	if (this->JumpPhase == EJumpPhase::Prewarming)
+	{
+		if (
+			this->JumpElapsedTime < this->JumpPrewarmMinimumTime
+			|| (this->JumpElapsedTime < this->JumpPrewarmTimeout && !this->IsJumpDestinationStreamed())
+		)
+		{
+			return;
+		}
 
-		EnhancedInputComponent->BindAction(
-			this->TurnCameraLeft,
-			ETriggerEvent::Triggered,
-			this,
-			&URTSCamera::OnTurnCameraLeft
+		UE_LOG(
+			LogOpenRTSCamera,
+			Verbose,
+			TEXT("Jump prewarmed for %.2fs, streaming %s"),
+			this->JumpElapsedTime,
+			this->IsJumpDestinationStreamed() ? TEXT("settled") : TEXT("timed out")
 		);
+		this->JumpPhase = EJumpPhase::Moving;
+		this->JumpOrigin = this->Root->GetComponentLocation();
+		this->JumpElapsedTime = 0;
+	}
 
-		EnhancedInputComponent->BindAction(
-			this->TurnCameraRight,
-			ETriggerEvent::Triggered,
-			this,
-			&URTSCamera::OnTurnCameraRight
-		);
+	const auto Alpha = this->JumpTransitionDuration > 0
+		? FMath::Clamp(this->JumpElapsedTime / this->JumpTransitionDuration, 0.f, 1.f)
+		: 1.f;
+	this->Root->SetWorldLocation(FMath::InterpEaseInOut(this->JumpOrigin, this->JumpDestination, Alpha, 2.f));
 
-		EnhancedInputComponent->BindAction(
-			this->MoveCameraXAxis,
-			ETriggerEvent::Triggered,
-			this,
-			&URTSCamera::OnMoveCameraXAxis
-		);
+	if (Alpha >= 1)
+	{
+		this->CancelJump();
+		this->OnJumpFinished.Broadcast();
+	}
+}
 
-		EnhancedInputComponent->BindAction(
-			this->MoveCameraYAxis,
-			ETriggerEvent::Triggered,
-			this,
-			&URTSCamera::OnMoveCameraYAxis
-		);
+// Only asks about the destination, anything streaming elsewhere on the map would keep every jump waiting
+bool URTSCamera::IsJumpDestinationStreamed() const
+{
+	const auto World = this->GetWorld();
+	if (World->IsPartitionedWorld())
+	{
+		const auto WorldPartitionSubsystem = World->GetSubsystem<UWorldPartitionSubsystem>();
+		FWorldPartitionStreamingQuerySource QuerySource;
+		QuerySource.Location = this->JumpDestination;
+		QuerySource.bUseGridLoadingRange = true;
+		return WorldPartitionSubsystem == nullptr
+			|| WorldPartitionSubsystem->IsStreamingCompleted(
+				EWorldPartitionRuntimeCellState::Activated,
+				{QuerySource},
+				false
+			);
+	}
 
-		EnhancedInputComponent->BindAction(
-			this->DragCamera,
-			ETriggerEvent::Triggered,
-			this,
-			&URTSCamera::OnDragCamera
-		);
+	// Without World Partition, levels are streamed by the game and not by location, wait for those it asked for
+	for (const auto StreamingLevel : World->GetStreamingLevels())
+	{
+		if (StreamingLevel != nullptr && StreamingLevel->ShouldBeVisible() && !StreamingLevel->IsLevelVisible())
+		{
+			return false;
+		}
+	}
 
+	return true;
+}
 
+void URTSCamera::QueueCameraOperation(FRTSCameraOperation&& Operation)
+{
+	RTSCAMERA_LLM_SCOPE(Commands);
 
-		//"RTSSelector.h"
+	this->CameraOperations.Add(MoveTemp(Operation));
+}
 
-		EnhancedInputComponent->BindAction(
-			this->BeginSelection,
-			ETriggerEvent::Started,
-			this,
-			&URTSCamera::OnSelectionStart
-		);
+TFuture<bool> URTSCamera::QueueCameraOperationAsync(FRTSCameraOperation&& Operation)
+{
+	TPromise<bool> Promise;
+	auto Future = Promise.GetFuture();
+	Operation.OnFinished = [Promise = MoveTemp(Promise)](const bool IsFinished) mutable
+	{
+		Promise.SetValue(IsFinished);
+	};
+	this->QueueCameraOperation(MoveTemp(Operation));
+	return Future;
+}
 
-		EnhancedInputComponent->BindAction(
-			this->BeginSelection,
-			ETriggerEvent::Triggered,
-			this,
-			&URTSCamera::OnUpdateSelection
-		);
+void URTSCamera::CancelSequence()
+{
+	if (this->CameraOperations.Num() == 0)
+	{
+		return;
+	}
 
-		EnhancedInputComponent->BindAction(
-			this->BeginSelection,
-			ETriggerEvent::Completed,
-			this,
-			&URTSCamera::OnSelectionEnd
-		);
+	// A follow the sequence started ends with it
+	const auto& Current = this->CameraOperations[0];
+	if (
+		this->IsCameraOperationStarted
+		&& Current.Type == ERTSCameraOperationType::Follow
+		&& Current.Target.IsValid()
+		&& this->CameraFollowTarget == Current.Target.Get()
+	)
+	{
+		this->UnFollowTarget();
+	}
 
+	// Callbacks may queue a new sequence, which then runs
+	auto CancelledOperations = MoveTemp(this->CameraOperations);
+	this->CameraOperations.Reset();
+	this->IsCameraOperationStarted = false;
+	for (auto& Operation : CancelledOperations)
+	{
+		if (Operation.OnFinished)
+		{
+			Operation.OnFinished(false);
+		}
 	}
 }
 
-void URTSCamera::SetActiveCamera() const
+bool URTSCamera::IsSequenceRunning() const
 {
-	this->PlayerController->SetViewTarget(this->GetOwner());
+	return this->CameraOperations.Num() > 0;
 }
 
-void URTSCamera::JumpTo(const FVector Position) const
+bool URTSCamera::IsSettled() const
 {
-	this->Root->SetWorldLocation(Position);
+	return !this->IsJumpPending()
+		&& !this->IsPanning()
+		&& FMath::IsNearlyEqual(this->SpringArm->TargetArmLength, this->DesiredZoomLength, 1.f)
+		&& this->PanVelocity.SizeSquared() < 1;
 }
 
-void URTSCamera::ConditionallyPerformEdgeScrolling()
+void URTSCamera::TickSequence(const float DeltaTime)
 {
-	if (this->EnableEdgeScrolling && !this->IsDragging)
+	if (this->CameraOperations.Num() == 0)
 	{
-		//this->EdgeScrollLeft();
-		//this->EdgeScrollRight();
-		//this->EdgeScrollUp();
-		//this->EdgeScrollDown();
-		//获取屏幕是否拖拽及拖拽值
-		RTSMouseLeftMovement = this->EdgeScrollLeft();
-		RTSMouseRightMovement = this->EdgeScrollRight();
-		RTSMouseUpMovement = this->EdgeScrollUp();
-		RTSMouseDownMovement = this->EdgeScrollDown();
+		return;
+	}
 
-		RTSMouseLeftMovement = -1 * RTSMouseLeftMovement;
-		RTSMouseDownMovement = -1 * RTSMouseDownMovement;
+	if (!this->IsCameraOperationStarted)
+	{
+		this->StartCameraOperation(this->CameraOperations[0]);
+		this->IsCameraOperationStarted = true;
+	}
 
-		//UE_LOG(LogTemp, Warning, TEXT("RTSMouseRightMovement: %f"), RTSMouseRightMovement);
+	this->CameraOperationElapsedTime += DeltaTime;
+	if (!this->UpdateCameraOperation(this->CameraOperations[0]))
+	{
+		return;
+	}
 
+	// Out of the queue before the callback, which may queue the next step or cancel the sequence
+	auto FinishedOperation = MoveTemp(this->CameraOperations[0]);
+	this->CameraOperations.RemoveAt(0, 1, false);
+	this->IsCameraOperationStarted = false;
+	if (FinishedOperation.OnFinished)
+	{
+		FinishedOperation.OnFinished(true);
 	}
 }
 
-double URTSCamera::EdgeScrollLeft() const
+void URTSCamera::StartCameraOperation(FRTSCameraOperation& Operation)
 {
-	const auto MousePosition = UWidgetLayoutLibrary::GetMousePositionOnViewport(this->GetWorld());
-	const auto ViewportSize = UWidgetLayoutLibrary::GetViewportWidgetGeometry(this->GetWorld()).GetLocalSize();
-	const auto NormalizedMousePosition = 1 - UKismetMathLibrary::NormalizeToRange(
-		MousePosition.X,
-		0.0f,
-		ViewportSize.X * 0.05f
-	);
+	this->CameraOperationElapsedTime = 0;
+	this->CameraOperationStartLocation = this->Root->GetComponentLocation();
+	this->CameraOperationStartZoomLength = this->DesiredZoomLength;
+	this->CameraOperationStartYaw = this->Root->GetRelativeRotation().Yaw;
+
+	switch (Operation.Type)
+	{
+	case ERTSCameraOperationType::MoveTo:
+		// The move owns the camera's location until it arrived
+		if (this->HasFollowTarget())
+		{
+			this->UnFollowTarget();
+		}
+		if (this->IsJumpPending())
+		{
+			this->CancelJump();
+		}
+		break;
+	case ERTSCameraOperationType::Follow:
+		if (Operation.Target.IsValid())
+		{
+			this->FollowTarget(Operation.Target.Get());
+		}
+		break;
+	default:
+		break;
+	}
+}
 
-	const auto Movement = UKismetMathLibrary::FClamp(NormalizedMousePosition, 0.0, 1.0);
+bool URTSCamera::UpdateCameraOperation(const FRTSCameraOperation& Operation)
+{
+	const auto Alpha = Operation.Duration > 0
+		? FMath::Clamp(this->CameraOperationElapsedTime / Operation.Duration, 0.f, 1.f)
+		: 1.f;
+	const auto EasedAlpha = FMath::InterpEaseInOut(0.f, 1.f, Alpha, 2.f);
 
-	this->Root->AddRelativeLocation(
-		-1 * this->Root->GetRightVector() * Movement * this->EdgeScrollSpeed * this->DeltaSeconds
-	);
-	//UE_LOG(LogTemp, Warning, TEXT("Movement: %f"), Movement);
-	return Movement;
+	switch (Operation.Type)
+	{
+	case ERTSCameraOperationType::MoveTo:
+		this->Root->SetWorldLocation(FMath::Lerp(this->CameraOperationStartLocation, Operation.Location, EasedAlpha));
+		return Alpha >= 1;
+	case ERTSCameraOperationType::ZoomTo:
+		this->DesiredZoomLength = FMath::Lerp(
+			this->CameraOperationStartZoomLength,
+			FMath::Clamp(Operation.ZoomLength, this->MinimumZoomLength, this->MaximumZoomLength),
+			EasedAlpha
+		);
+		return Alpha >= 1;
+	case ERTSCameraOperationType::RotateTo:
+		{
+			// The short way around
+			const auto Rotation = this->Root->GetRelativeRotation();
+			const auto DeltaYaw = FMath::FindDeltaAngleDegrees(this->CameraOperationStartYaw, Operation.Yaw);
+			const auto Yaw = this->CameraOperationStartYaw + DeltaYaw * EasedAlpha;
+			this->Root->SetRelativeRotation(FRotator(Rotation.Pitch, Yaw, Rotation.Roll));
+			return Alpha >= 1;
+		}
+	case ERTSCameraOperationType::Follow:
+		{
+			// Also over once the target is gone or something else took the camera over
+			const auto IsFollowingTarget = Operation.Target.IsValid()
+				&& this->CameraFollowTarget == Operation.Target.Get();
+			if (Operation.Duration <= 0 || !IsFollowingTarget)
+			{
+				return true;
+			}
+
+			if (Alpha < 1)
+			{
+				return false;
+			}
+
+			this->UnFollowTarget();
+			return true;
+		}
+	case ERTSCameraOperationType::WaitUntilSettled:
+		return this->IsSettled() || (Operation.Duration > 0 && Alpha >= 1);
+	default:
+		return true;
+	}
 }
 
-double URTSCamera::EdgeScrollRight() const
+void URTSCamera::UpdatePanVelocity(const float DeltaTime)
 {
-	const auto MousePosition = UWidgetLayoutLibrary::GetMousePositionOnViewport(this->GetWorld());
-	const auto ViewportSize = UWidgetLayoutLibrary::GetViewportWidgetGeometry(this->GetWorld()).GetLocalSize();
-	const auto NormalizedMousePosition = UKismetMathLibrary::NormalizeToRange(
-		MousePosition.X,
-		ViewportSize.X * 0.95f,
-		ViewportSize.X
-	);
+	const auto Location = this->Root->GetComponentLocation();
+	const auto Velocity = DeltaTime > 0
+		? FVector(Location.X - this->LastPanLocation.X, Location.Y - this->LastPanLocation.Y, 0) / DeltaTime
+		: FVector::ZeroVector;
+	this->LastPanLocation = Location;
+
+	// Far faster than any pan, the camera was placed somewhere else
+	if (Velocity.SizeSquared() > FMath::Square(this->MoveSpeed * RTSCameraStreaming::TeleportSpeedScale))
+	{
+		this->PanVelocity = FVector::ZeroVector;
+		return;
+	}
 
-	const auto Movement = UKismetMathLibrary::FClamp(NormalizedMousePosition, 0.0, 1.0);
-	auto RightLocation = this->Root->GetRightVector() * Movement * this->EdgeScrollSpeed * this->DeltaSeconds;
-	this->Root->AddRelativeLocation(
-		RightLocation
-	);
-	//UE_LOG(LogTemp, Warning, TEXT("RightLocation: %s"), *RightLocation.ToString());
-	//UE_LOG(LogTemp, Warning, TEXT("DeltaSeconds: %f"), DeltaSeconds);
-	return Movement;
+	const auto Alpha = FMath::Min(DeltaTime / RTSCameraStreaming::PanVelocitySmoothingTime, 1.f);
+	this->PanVelocity = FMath::Lerp(this->PanVelocity, Velocity, Alpha);
 }
 
-double URTSCamera::EdgeScrollUp() const
+void URTSCamera::UpdateStreamingSourceRegistration()
 {
-	const auto MousePosition = UWidgetLayoutLibrary::GetMousePositionOnViewport(this->GetWorld());
-	const auto ViewportSize = UWidgetLayoutLibrary::GetViewportWidgetGeometry(this->GetWorld()).GetLocalSize();
-	const auto NormalizedMousePosition = UKismetMathLibrary::NormalizeToRange(
-		MousePosition.Y,
-		0.0f,
-		ViewportSize.Y * 0.05f
-	);
+	const auto IsRegistered = this->IsJumpPending() || (this->IsLocalCamera && this->EnableStreamingSource);
+	if (this->IsStreamingSourceRegistered == IsRegistered)
+	{
+		return;
+	}
 
-	const auto Movement = 1 - UKismetMathLibrary::FClamp(NormalizedMousePosition, 0.0, 1.0);
-	this->Root->AddRelativeLocation(
-		this->Root->GetForwardVector() * Movement * this->EdgeScrollSpeed * this->DeltaSeconds
-	);
-	return Movement;
+	if (this->ViewStreamingSourceName.IsNone())
+	{
+		const auto PathName = this->GetPathName();
+		this->JumpStreamingSourceName = FName(*FString::Printf(TEXT("%s_Jump"), *PathName));
+		this->ViewStreamingSourceName = FName(*FString::Printf(TEXT("%s_View"), *PathName));
+		this->LookaheadStreamingSourceName = FName(*FString::Printf(TEXT("%s_Lookahead"), *PathName));
+	}
+
+	if (const auto WorldPartitionSubsystem = this->GetWorld()->GetSubsystem<UWorldPartitionSubsystem>())
+	{
+		if (IsRegistered)
+		{
+			WorldPartitionSubsystem->RegisterStreamingSourceProvider(this);
+		}
+		else
+		{
+			WorldPartitionSubsystem->UnregisterStreamingSourceProvider(this);
+		}
+	}
+	this->IsStreamingSourceRegistered = IsRegistered;
 }
 
-double URTSCamera::EdgeScrollDown() const
+bool URTSCamera::GetStreamingSources(TArray<FWorldPartitionStreamingSource>& OutStreamingSources) const
 {
-	const auto MousePosition = UWidgetLayoutLibrary::GetMousePositionOnViewport(this->GetWorld());
-	const auto ViewportSize = UWidgetLayoutLibrary::GetViewportWidgetGeometry(this->GetWorld()).GetLocalSize();
-	const auto NormalizedMousePosition = UKismetMathLibrary::NormalizeToRange(
-		MousePosition.Y,
-		ViewportSize.Y * 0.95f,
-		ViewportSize.Y
-	);
+	auto HasStreamingSources = false;
+	if (this->JumpPhase != EJumpPhase::None)
+	{
+		// Loads and activates the destination as if the player already stood there
+		FWorldPartitionStreamingSource JumpSource;
+		JumpSource.Name = this->JumpStreamingSourceName;
+		JumpSource.Location = this->JumpDestination;
+		JumpSource.Rotation = this->Root->GetComponentRotation();
+		JumpSource.TargetState = EStreamingSourceTargetState::Activated;
+		JumpSource.Priority = EStreamingSourcePriority::High;
+		OutStreamingSources.Add(JumpSource);
+		HasStreamingSources = true;
+	}
 
-	const auto Movement = UKismetMathLibrary::FClamp(NormalizedMousePosition, 0.0, 1.0);
-	this->Root->AddRelativeLocation(
-		-1 * this->Root->GetForwardVector() * Movement * this->EdgeScrollSpeed * this->DeltaSeconds
+	if (!this->IsLocalCamera || !this->EnableStreamingSource || !this->ViewFootprint.IsValid)
+	{
+		return HasStreamingSources;
+	}
 
-	);
-	return Movement;
+	// One circle around all the ground the camera sees, it grows as the camera zooms out
+	FStreamingSourceShape Shape;
+	Shape.bUseGridLoadingRange = false;
+	Shape.Radius = static_cast<float>(this->ViewFootprint.Bounds.GetExtent().Size() * this->StreamingRadiusScale);
+
+	FWorldPartitionStreamingSource ViewSource;
+	ViewSource.Name = this->ViewStreamingSourceName;
+	ViewSource.Location = FVector(this->ViewFootprint.Bounds.GetCenter(), this->Root->GetComponentLocation().Z);
+	ViewSource.Rotation = this->Root->GetComponentRotation();
+	ViewSource.TargetState = EStreamingSourceTargetState::Activated;
+	ViewSource.Priority = EStreamingSourcePriority::Normal;
+	ViewSource.Shapes.Add(Shape);
+	OutStreamingSources.Add(ViewSource);
+
+	// The same circle pushed ahead of a pan, it loads before the ground the camera leaves behind
+	const auto Lookahead = this->PanVelocity * this->StreamingLookaheadTime;
+	if (Lookahead.SizeSquared() > FMath::Square(Shape.Radius * RTSCameraStreaming::MinimumLookaheadFraction))
+	{
+		auto LookaheadSource = ViewSource;
+		LookaheadSource.Name = this->LookaheadStreamingSourceName;
+		LookaheadSource.Location += Lookahead;
+		LookaheadSource.Rotation = Lookahead.Rotation();
+		LookaheadSource.Priority = EStreamingSourcePriority::High;
+		OutStreamingSources.Add(LookaheadSource);
+	}
+
+	return true;
 }
 
 void URTSCamera::FollowTargetIfSet() const
 {
+	RTSCAMERA_STAGE_SCOPE(Follow);
+
 	if (this->CameraFollowTarget != nullptr)
 	{
 		this->Root->SetWorldLocation(this->CameraFollowTarget->GetActorLocation());
 	}
-}
-
-void URTSCamera::SmoothTargetArmLengthToDesiredZoom() const
-{
-	this->SpringArm->TargetArmLength = FMath::FInterpTo(
-		this->SpringArm->TargetArmLength,
-		this->DesiredZoomLength,
-		this->DeltaSeconds,
-		this->ZoomCatchupSpeed
-	);
+	else if (this->FollowGroup.Num() > 0)
+	{
+		this->Root->SetWorldLocation(FromKinematics(this->FollowGroup.GetCentroid()));
+	}
 }
 
 void URTSCamera::ConditionallyKeepCameraAtDesiredZoomAboveGround()
 {
-	if (this->EnableDynamicCameraHeight)
+	RTSCAMERA_STAGE_SCOPE(GroundHeight);
+
+	FVector Start;
+	FVector End;
+	if (this->GetGroundTrace(Start, End))
 	{
-		const auto RootWorldLocation = this->Root->GetComponentLocation();
-		const TArray<AActor*> ActorsToIgnore;
+		RTSCAMERA_COUNTER_ADD(Traces, 1);
 
 		auto HitResult = FHitResult();
-		auto DidHit = UKismetSystemLibrary::LineTraceSingle(
-			this->GetWorld(),
-			FVector(RootWorldLocation.X, RootWorldLocation.Y, RootWorldLocation.Z + this->FindGroundTraceLength),
-			FVector(RootWorldLocation.X, RootWorldLocation.Y, RootWorldLocation.Z - this->FindGroundTraceLength),
-			UEngineTypes::ConvertToTraceType(this->CollisionChannel),
-			true,
-			ActorsToIgnore,
-			EDrawDebugTrace::Type::None,
+		const auto DidHit = this->GetWorld()->LineTraceSingleByChannel(
 			HitResult,
-			true
+			Start,
+			End,
+			this->CollisionChannel,
+			GetGroundTraceQueryParams()
 		);
 
-		if (DidHit)
-		{
-			this->Root->SetWorldLocation(
-				FVector(
-					HitResult.Location.X,
-					HitResult.Location.Y,
-					HitResult.Location.Z
-				)
-			);
-		}
+		this->ApplyGroundTrace(DidHit, HitResult);
+	}
+}
 
-		else if (!this->IsCameraOutOfBoundsErrorAlreadyDisplayed)
-		{
-			this->IsCameraOutOfBoundsErrorAlreadyDisplayed = true;
+bool URTSCamera::GetGroundTrace(FVector& OutStart, FVector& OutEnd) const
+{
+	if (!this->EnableDynamicCameraHeight)
+	{
+		return false;
+	}
 
-			UKismetSystemLibrary::PrintString(
-				this->GetWorld(),
-				"Or add a `RTSCameraBoundsVolume` actor to the scene.",
-				true,
-				true,
-				FLinearColor::Red,
-				100
-			);
+	const auto RootWorldLocation = this->Root->GetComponentLocation();
+	OutStart = FVector(RootWorldLocation.X, RootWorldLocation.Y, RootWorldLocation.Z + this->FindGroundTraceLength);
+	OutEnd = FVector(RootWorldLocation.X, RootWorldLocation.Y, RootWorldLocation.Z - this->FindGroundTraceLength);
+	return true;
+}
 
-			UKismetSystemLibrary::PrintString(
-				this->GetWorld(),
-				"Increase trace length or change the starting position of the parent actor for the spring arm.",
-				true,
-				true,
-				FLinearColor::Red,
-				100
-			);
+FCollisionQueryParams URTSCamera::GetGroundTraceQueryParams()
+{
+	// Complex collision, like the kismet line trace this used to be
+	return FCollisionQueryParams(SCENE_QUERY_STAT(RTSCameraGround), true);
+}
 
-			UKismetSystemLibrary::PrintString(
-				this->GetWorld(),
-				"Error: AC_RTSCamera needs to be placed on the ground!",
-				true,
-				true,
-				FLinearColor::Red,
-				100
-			);
-		}
+void URTSCamera::ApplyGroundTrace(const bool DidHit, const FHitResult& HitResult)
+{
+	if (DidHit)
+	{
+		this->Root->SetWorldLocation(
+			FVector(
+				HitResult.Location.X,
+				HitResult.Location.Y,
+				HitResult.Location.Z
+			)
+		);
+	}
+
+	else if (!this->IsCameraOutOfBoundsErrorAlreadyDisplayed)
+	{
+		this->IsCameraOutOfBoundsErrorAlreadyDisplayed = true;
+
+		UKismetSystemLibrary::PrintString(
+			this->GetWorld(),
+			"Or add a `RTSCameraBoundsVolume` actor to the scene.",
+			true,
+			true,
+			FLinearColor::Red,
+			100
+		);
+
+		UKismetSystemLibrary::PrintString(
+			this->GetWorld(),
+			"Increase trace length or change the starting position of the parent actor for the spring arm.",
+			true,
+			true,
+			FLinearColor::Red,
+			100
+		);
+
+		UKismetSystemLibrary::PrintString(
+			this->GetWorld(),
+			"Error: AC_RTSCamera needs to be placed on the ground!",
+			true,
+			true,
+			FLinearColor::Red,
+			100
+		);
 	}
 }
 
 void URTSCamera::ConditionallyApplyCameraBounds() const
 {
+	RTSCAMERA_STAGE_SCOPE(Bounds);
+
 	if (this->BoundaryVolume != nullptr)
 	{
-		const auto RootWorldLocation = this->Root->GetComponentLocation();
 		FVector Origin;
 		FVector Extents;
-		this->BoundaryVolume->GetActorBounds(false, Origin, Extents);
+		if (this->CameraSubsystem != nullptr)
+		{
+			this->CameraSubsystem->GetBoundaryVolumeBounds(this->BoundaryVolume, Origin, Extents);
+		}
+		else
+		{
+			this->BoundaryVolume->GetActorBounds(false, Origin, Extents);
+		}
+
 		this->Root->SetWorldLocation(
-			FVector(
-				UKismetMathLibrary::Clamp(RootWorldLocation.X, Origin.X - Extents.X, Origin.X + Extents.X),
-				UKismetMathLibrary::Clamp(RootWorldLocation.Y, Origin.Y - Extents.Y, Origin.Y + Extents.Y),
-				RootWorldLocation.Z
+			FromKinematics(
+				RTSCameraKinematics::ClampToBounds(
+					ToKinematics(this->Root->GetComponentLocation()),
+					ToKinematics(Origin),
+					ToKinematics(Extents)
+				)
 			)
 		);
 	}
@@ -921,13 +3061,18 @@ void URTSCamera::ConditionallyApplyCameraBounds() const
 
 void URTSCamera::OnSelectionStart(const FInputActionValue& Value)
 {
+	if (!this->ShouldHandleInput(ERTSCameraInputEvent::SelectionStart, Value))
+	{
+		return;
+	}
+
 	FVector2D MousePosition;
 	double MouseX = MousePosition.X;
 	double MouseY = MousePosition.Y;
 
 	//MousePosition.X= MousePosition.X+500;
 	//RTSCamera.MoveSpeed
-	PlayerController->GetMousePosition(MousePosition.X, MousePosition.Y);
+	MousePosition = this->GetCursorSnapshot().PlayerMousePosition;
 
 	//PlayerController->GetMousePosition(MouseX, MouseY);//此处修改框选起始位置
 
@@ -935,18 +3080,26 @@ void URTSCamera::OnSelectionStart(const FInputActionValue& Value)
 	
 	//MousePosition.X = MousePosition.X - 5;//RTSMouseLefti
 
-	HUD->BeginSelection(MousePosition);//MousePosition
+	if (HUD)
+	{
+		HUD->BeginSelection(MousePosition);//MousePosition
+	}
 }
 
 
 
 void URTSCamera::OnUpdateSelection(const FInputActionValue& Value)
 {
+	if (!this->ShouldHandleInput(ERTSCameraInputEvent::UpdateSelection, Value))
+	{
+		return;
+	}
+
 	FVector2D MousePosition;
 
 	RTSMouseSelectRate = -0.0002 * this->EdgeScrollSpeed + 24;// -0.0003 * this->EdgeScrollSpeed + 25;//-12 * FMath::LogX(10.0f, this->DesiredZoomLength) + 65;
 
-	PlayerController->GetMousePosition(MousePosition.X, MousePosition.Y);
+	MousePosition = this->GetCursorSnapshot().PlayerMousePosition;
 
 	SelectionEnd = MousePosition;
 	
@@ -959,8 +3112,11 @@ void URTSCamera::OnUpdateSelection(const FInputActionValue& Value)
 	SelectionStart.X = SelectionStart.X - (RTSMouseLeftMovement + RTSMouseRightMovement + RTSKeyXMovement) * RTSMouseSelectRate;// 然后乘以一个距离系数 RTSMouseLefti
 	SelectionStart.Y = SelectionStart.Y + (RTSMouseUpMovement + RTSMouseDownMovement + RTSKeyYMovement) * RTSMouseSelectRate*0.5625;//1080/1920 或试试角度
 
-	HUD->BeginSelection(SelectionStart);
-	HUD->UpdateSelection(SelectionEnd);
+	if (HUD)
+	{
+		HUD->BeginSelection(SelectionStart);
+		HUD->UpdateSelection(SelectionEnd);
+	}
 	//UE_LOG(LogTemp, Warning, TEXT("SelectionStart: %f , %f   DesiredZoomLength: %f , Rate: %f, EdgeScrollSpeed: %f"), SelectionStart.X, SelectionStart.Y, this->DesiredZoomLength, RTSMouseSelectRate, this->EdgeScrollSpeed);
 	
 	//3700 22.4 15 + this->DesiredZoomLength / 500
@@ -971,8 +3127,16 @@ void URTSCamera::OnUpdateSelection(const FInputActionValue& Value)
 
 void URTSCamera::OnSelectionEnd(const FInputActionValue& Value)
 {
+	if (!this->ShouldHandleInput(ERTSCameraInputEvent::SelectionEnd, Value))
+	{
+		return;
+	}
+
 	// Call PerformSelection on the HUD to execute selection logic
-	HUD->EndSelection();
+	if (HUD)
+	{
+		HUD->EndSelection();
+	}
 }
 
 //"RTSSelector.h"
\ No newline at end of file
@@ -0,0 +1,510 @@
+// Copyright 2024 Jesus Bracho All Rights Reserved.
+
+#include "RTSCameraFlythrough.h"
+#include "OpenRTSCamera.h"
+#include "RTSCamera.h"
+#include "RTSSelectable.h"
+#include "RenderCore.h"
+#include "Blueprint/WidgetLayoutLibrary.h"
+#include "Dom/JsonObject.h"
+#include "Engine/World.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+#include "Interfaces/IPluginManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+#include "UObject/UObjectIterator.h"
+
+#if !UE_BUILD_SHIPPING
+
+CSV_DEFINE_CATEGORY(OpenRTSCamera, true);
+
+namespace RTSCameraFlythrough
+{
+	static TUniquePtr<FRTSCameraFlythrough> ActiveFlythrough;
+	static TWeakObjectPtr<UWorld> ActiveFlythroughWorld;
+	static FDelegateHandle WorldCleanupHandle;
+
+	static constexpr float BoxSelectionPeriod = 1.0f;
+
+	// The flythrough ticks with the engine, it has to go with the world it drives instead of at static deinit
+	static void StopFlythrough()
+	{
+		ActiveFlythrough.Reset();
+		ActiveFlythroughWorld.Reset();
+		FWorldDelegates::OnWorldCleanup.Remove(WorldCleanupHandle);
+		WorldCleanupHandle.Reset();
+	}
+
+	static void OnWorldCleanup(UWorld* World, bool bSessionEnded, bool bCleanupResources)
+	{
+		if (World == ActiveFlythroughWorld.Get())
+		{
+			StopFlythrough();
+		}
+	}
+
+	/** The checked-in summary runs are compared against unless another one is given. */
+	static FString GetDefaultBaselinePath()
+	{
+		const auto Plugin = IPluginManager::Get().FindPlugin(TEXT("OpenRTSCamera"));
+		return Plugin.IsValid()
+			? FPaths::Combine(Plugin->GetBaseDir(), TEXT("Tests"), TEXT("Flythrough"), TEXT("Baseline.json"))
+			: FString();
+	}
+
+	static URTSCamera* FindCameraToDrive(UWorld* World)
+	{
+		const auto PlayerController = World != nullptr ? World->GetFirstPlayerController() : nullptr;
+		if (PlayerController == nullptr)
+		{
+			return nullptr;
+		}
+
+		if (const auto Pawn = PlayerController->GetPawn())
+		{
+			if (const auto Camera = Pawn->FindComponentByClass<URTSCamera>())
+			{
+				return Camera;
+			}
+		}
+
+		// Take over the first pawn in the world that has a camera
+		for (TObjectIterator<URTSCamera> It; It; ++It)
+		{
+			if (It->GetWorld() == World && !It->IsTemplate())
+			{
+				if (const auto Pawn = Cast<APawn>(It->GetOwner()))
+				{
+					PlayerController->Possess(Pawn);
+					It->SetActiveCamera();
+					return *It;
+				}
+			}
+		}
+
+		return nullptr;
+	}
+
+	static void StartFlythrough(const TArray<FString>& Args, UWorld* World)
+	{
+		const auto Camera = FindCameraToDrive(World);
+		if (Camera == nullptr)
+		{
+			UE_LOG(LogOpenRTSCamera, Error, TEXT("RTSCamera.Flythrough: no pawn with an RTSCamera component to take over."));
+			return;
+		}
+
+		const auto Arguments = FString::Join(Args, TEXT(" "));
+		FRTSCameraFlythrough::FSettings Settings;
+		FParse::Value(*Arguments, TEXT("StepDuration="), Settings.StepDuration);
+		FParse::Value(*Arguments, TEXT("Tolerance="), Settings.Tolerance);
+		FParse::Value(*Arguments, TEXT("Baseline="), Settings.BaselinePath);
+		FParse::Value(*Arguments, TEXT("Output="), Settings.OutputPath);
+		Settings.bQuitWhenDone = FParse::Param(*Arguments, TEXT("Quit")) || Args.Contains(TEXT("Quit"));
+		Settings.bUpdateBaseline = Args.Contains(TEXT("UpdateBaseline"));
+
+		if (Settings.OutputPath.IsEmpty())
+		{
+			Settings.OutputPath = FPaths::Combine(FPaths::ProfilingDir(), TEXT("OpenRTSCamera"), TEXT("Flythrough.json"));
+		}
+
+		if (Args.Contains(TEXT("NoBaseline")))
+		{
+			Settings.BaselinePath.Reset();
+		}
+		else if (Settings.BaselinePath.IsEmpty())
+		{
+			Settings.BaselinePath = GetDefaultBaselinePath();
+		}
+
+		StopFlythrough();
+		ActiveFlythrough = MakeUnique<FRTSCameraFlythrough>(Camera, Settings);
+		ActiveFlythroughWorld = World;
+		WorldCleanupHandle = FWorldDelegates::OnWorldCleanup.AddStatic(&OnWorldCleanup);
+	}
+
+	static FAutoConsoleCommandWithWorldAndArgs StartFlythroughCommand(
+		TEXT("RTSCamera.Flythrough"),
+		TEXT(
+			"Plays a scripted path through the local RTS camera and records per-frame costs. "
+			"Fails if a p95 regressed against the plugin's Tests/Flythrough/Baseline.json or the given baseline. "
+			"Arguments: StepDuration=<Seconds> Output=<Path> Baseline=<Path> Tolerance=<Fraction> NoBaseline "
+			"UpdateBaseline Quit"
+		),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&StartFlythrough)
+	);
+}
+
+FRTSCameraFlythrough::FRTSCameraFlythrough(URTSCamera* InCamera, const FSettings& InSettings)
+	: Camera(InCamera),
+	  Settings(InSettings),
+	  ElapsedTime(0),
+	  bIsFinished(false),
+	  bIsSelecting(false),
+	  bIsCapturingCsv(false),
+	  ClusterIndex(0),
+	  MapName(InCamera->GetWorld()->GetMapName())
+{
+	FMemory::Memzero(this->FrameStageCycles);
+	FMemory::Memzero(this->FrameCounters);
+	RTSCameraProfiling::SetStageSink(this);
+
+#if CSV_PROFILER
+	if (!FCsvProfiler::Get()->IsCapturing())
+	{
+		FCsvProfiler::Get()->BeginCapture();
+		this->bIsCapturingCsv = true;
+	}
+#endif
+}
+
+FRTSCameraFlythrough::~FRTSCameraFlythrough()
+{
+	if (RTSCameraProfiling::StageSink == this)
+	{
+		RTSCameraProfiling::SetStageSink(nullptr);
+	}
+
+	this->EndCsvCapture();
+}
+
+TStatId FRTSCameraFlythrough::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(FRTSCameraFlythrough, STATGROUP_Tickables);
+}
+
+void FRTSCameraFlythrough::AddStageSample(const ERTSCameraStage Stage, const uint64 Cycles)
+{
+	this->FrameStageCycles[static_cast<int32>(Stage)] += Cycles;
+}
+
+void FRTSCameraFlythrough::AddCounterSample(const ERTSCameraCounter Counter, const int32 Amount)
+{
+	this->FrameCounters[static_cast<int32>(Counter)] += Amount;
+}
+
+// Ticks after the world, so everything the camera did this frame has been reported by now
+void FRTSCameraFlythrough::Tick(const float DeltaTime)
+{
+	if (!this->Camera.IsValid())
+	{
+		UE_LOG(LogOpenRTSCamera, Error, TEXT("RTSCamera.Flythrough: the camera went away, stopping."));
+		this->Finish();
+		return;
+	}
+
+	this->RecordFrame();
+
+	this->ElapsedTime += DeltaTime;
+	const auto StepIndex = FMath::FloorToInt32(this->ElapsedTime / this->Settings.StepDuration);
+	if (StepIndex >= static_cast<int32>(EStep::Num))
+	{
+		this->Finish();
+		return;
+	}
+
+	const auto StepTime = this->ElapsedTime - StepIndex * this->Settings.StepDuration;
+	this->DriveStep(static_cast<EStep>(StepIndex), StepTime, DeltaTime);
+}
+
+void FRTSCameraFlythrough::RecordFrame()
+{
+	uint64 CameraTickCycles = 0;
+	for (auto Stage = static_cast<int32>(ERTSCameraStage::MoveCommands);
+	     Stage <= static_cast<int32>(ERTSCameraStage::Bounds); Stage++)
+	{
+		CameraTickCycles += this->FrameStageCycles[Stage];
+	}
+
+	uint64 SelectionCycles = 0;
+	for (auto Stage = static_cast<int32>(ERTSCameraStage::SelectionQuery);
+	     Stage <= static_cast<int32>(ERTSCameraStage::SelectionDispatch); Stage++)
+	{
+		SelectionCycles += this->FrameStageCycles[Stage];
+	}
+
+	const double Values[static_cast<int32>(EMetric::Num)] = {
+		FPlatformTime::ToMilliseconds(GGameThreadTime),
+		FPlatformTime::ToMilliseconds64(CameraTickCycles) * 1000.0,
+		FPlatformTime::ToMilliseconds64(SelectionCycles) * 1000.0,
+		static_cast<double>(this->FrameCounters[static_cast<int32>(ERTSCameraCounter::Traces)]),
+		static_cast<double>(this->FrameCounters[static_cast<int32>(ERTSCameraCounter::UnitsTested)]),
+	};
+
+	for (auto Metric = 0; Metric < static_cast<int32>(EMetric::Num); Metric++)
+	{
+		this->Samples[Metric].Add(Values[Metric]);
+	}
+
+	CSV_CUSTOM_STAT(OpenRTSCamera, CameraTickUs, Values[1], ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(OpenRTSCamera, SelectionUs, Values[2], ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(OpenRTSCamera, Traces, Values[3], ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(OpenRTSCamera, UnitsTested, Values[4], ECsvCustomStatOp::Set);
+
+	FMemory::Memzero(this->FrameStageCycles);
+	FMemory::Memzero(this->FrameCounters);
+}
+
+void FRTSCameraFlythrough::DriveStep(const EStep Step, const float StepTime, const float DeltaTime)
+{
+	const auto RTSCamera = this->Camera.Get();
+	const auto StepProgress = StepTime / this->Settings.StepDuration;
+
+	// Park the cursor in the middle of the screen unless the step is about the cursor
+	if (Step != EStep::Rotate && Step != EStep::EdgeScroll && Step != EStep::BoxSelect)
+	{
+		this->SetNormalizedCursor(FVector2D(0.5, 0.5));
+	}
+
+	switch (Step)
+	{
+	case EStep::PanForward:
+		RTSCamera->InjectInput(ERTSCameraInputEvent::MoveCameraYAxis, FInputActionValue(StepProgress < 0.5f ? 1.0f : -1.0f));
+		break;
+	case EStep::PanRight:
+		RTSCamera->InjectInput(ERTSCameraInputEvent::MoveCameraXAxis, FInputActionValue(StepProgress < 0.5f ? 1.0f : -1.0f));
+		break;
+	case EStep::ZoomIn:
+		// Every zoom input moves a fraction of the current zoom, this reaches MinimumZoomLength well within a step
+		RTSCamera->InjectInput(ERTSCameraInputEvent::ZoomCamera, FInputActionValue(1.0f));
+		break;
+	case EStep::ZoomOut:
+		RTSCamera->InjectInput(ERTSCameraInputEvent::ZoomCamera, FInputActionValue(-1.0f));
+		break;
+	case EStep::Rotate:
+		this->SetNormalizedCursor(FVector2D(0.3 + 0.4 * StepProgress, 0.5));
+		RTSCamera->InjectInput(ERTSCameraInputEvent::RotateCamera, FInputActionValue(1.0f));
+		break;
+	case EStep::EdgeScroll:
+		this->SetNormalizedCursor(StepProgress < 0.5f ? FVector2D(0.995, 0.5) : FVector2D(0.5, 0.995));
+		break;
+	case EStep::BoxSelect:
+		this->DriveBoxSelection(StepTime);
+		break;
+	default:
+		break;
+	}
+}
+
+// Jumps to a unit cluster once per period and drags a box over the middle of the screen
+void FRTSCameraFlythrough::DriveBoxSelection(const float StepTime)
+{
+	using RTSCameraFlythrough::BoxSelectionPeriod;
+
+	const auto RTSCamera = this->Camera.Get();
+	const auto PeriodTime = FMath::Fmod(StepTime, BoxSelectionPeriod) / BoxSelectionPeriod;
+
+	if (!this->bIsSelecting && PeriodTime < 0.5f)
+	{
+		auto Index = 0;
+		for (TObjectIterator<URTSSelectable> It; It; ++It)
+		{
+			if (It->GetWorld() == RTSCamera->GetWorld() && It->GetOwner() != nullptr && Index++ == this->ClusterIndex)
+			{
+				RTSCamera->JumpTo(It->GetOwner()->GetActorLocation());
+				break;
+			}
+		}
+		this->ClusterIndex = Index > this->ClusterIndex ? this->ClusterIndex + 97 : 0;
+
+		this->SetNormalizedCursor(FVector2D(0.35, 0.35));
+		RTSCamera->InjectInput(ERTSCameraInputEvent::SelectionStart, FInputActionValue(true));
+		this->bIsSelecting = true;
+	}
+	else if (this->bIsSelecting && PeriodTime < 0.5f)
+	{
+		const auto Progress = PeriodTime * 2;
+		this->SetNormalizedCursor(FVector2D(0.35 + 0.3 * Progress, 0.35 + 0.3 * Progress));
+		RTSCamera->InjectInput(ERTSCameraInputEvent::UpdateSelection, FInputActionValue(true));
+	}
+	else if (this->bIsSelecting)
+	{
+		RTSCamera->InjectInput(ERTSCameraInputEvent::SelectionEnd, FInputActionValue(false));
+		this->bIsSelecting = false;
+	}
+}
+
+void FRTSCameraFlythrough::SetNormalizedCursor(const FVector2D& NormalizedPosition) const
+{
+	const auto RTSCamera = this->Camera.Get();
+	const auto World = RTSCamera->GetWorld();
+	const auto ViewportScale = FMath::Max(UWidgetLayoutLibrary::GetViewportScale(World), UE_SMALL_NUMBER);
+
+	FRTSCameraCursorSnapshot Cursor;
+	Cursor.ViewportSize = UWidgetLayoutLibrary::GetViewportSize(World) / ViewportScale;
+	Cursor.ViewportMousePosition = Cursor.ViewportSize * NormalizedPosition;
+	Cursor.PlayerMousePosition = Cursor.ViewportMousePosition * ViewportScale;
+	RTSCamera->SetCursorOverride(Cursor);
+}
+
+void FRTSCameraFlythrough::Finish()
+{
+	this->bIsFinished = true;
+
+	if (this->Camera.IsValid())
+	{
+		this->Camera->ClearCursorOverride();
+	}
+
+	RTSCameraProfiling::SetStageSink(nullptr);
+	this->EndCsvCapture();
+
+	const auto bPassed = this->WriteSummaryAndCompare();
+	UE_LOG(LogOpenRTSCamera, Display, TEXT("RTSCamera.Flythrough finished: %s"), bPassed ? TEXT("passed") : TEXT("FAILED"));
+
+	if (this->Settings.bQuitWhenDone)
+	{
+		FPlatformMisc::RequestExitWithStatus(false, bPassed ? 0 : 1);
+	}
+}
+
+// Only ends a capture the flythrough started, one started from the command line is left to whoever started it
+void FRTSCameraFlythrough::EndCsvCapture()
+{
+#if CSV_PROFILER
+	if (this->bIsCapturingCsv && FCsvProfiler::Get()->IsCapturing())
+	{
+		FCsvProfiler::Get()->EndCapture();
+	}
+#endif
+	this->bIsCapturingCsv = false;
+}
+
+// Writes the per-frame samples as CSV and their percentiles as JSON, then compares against the baseline if there is one
+bool FRTSCameraFlythrough::WriteSummaryAndCompare() const
+{
+	const auto NumMetrics = static_cast<int32>(EMetric::Num);
+
+	FString FramesCsv;
+	for (auto Metric = 0; Metric < NumMetrics; Metric++)
+	{
+		FramesCsv += GetMetricName(static_cast<EMetric>(Metric));
+		FramesCsv += Metric + 1 < NumMetrics ? TEXT(",") : TEXT("\n");
+	}
+	for (auto Frame = 0; Frame < this->Samples[0].Num(); Frame++)
+	{
+		for (auto Metric = 0; Metric < NumMetrics; Metric++)
+		{
+			FramesCsv += FString::Printf(TEXT("%.3f"), this->Samples[Metric][Frame]);
+			FramesCsv += Metric + 1 < NumMetrics ? TEXT(",") : TEXT("\n");
+		}
+	}
+	FFileHelper::SaveStringToFile(FramesCsv, *FPaths::ChangeExtension(this->Settings.OutputPath, TEXT("csv")));
+
+	const auto Summary = MakeShared<FJsonObject>();
+	const auto Metrics = MakeShared<FJsonObject>();
+	Summary->SetStringField(TEXT("Machine"), FPlatformMisc::GetCPUBrand().TrimStartAndEnd());
+	Summary->SetStringField(TEXT("Map"), this->MapName);
+	Summary->SetNumberField(TEXT("Frames"), this->Samples[0].Num());
+	Summary->SetObjectField(TEXT("Metrics"), Metrics);
+
+	double CurrentP95[static_cast<int32>(EMetric::Num)];
+	for (auto Metric = 0; Metric < NumMetrics; Metric++)
+	{
+		auto Sorted = this->Samples[Metric];
+		const auto Percentiles = MakeShared<FJsonObject>();
+		Percentiles->SetNumberField(TEXT("P50"), RTSCameraProfiling::Percentile(Sorted, 50));
+		Percentiles->SetNumberField(TEXT("P95"), CurrentP95[Metric] = RTSCameraProfiling::Percentile(Sorted, 95));
+		Percentiles->SetNumberField(TEXT("P99"), RTSCameraProfiling::Percentile(Sorted, 99));
+		Metrics->SetObjectField(GetMetricName(static_cast<EMetric>(Metric)), Percentiles);
+	}
+
+	FString SummaryJson;
+	FJsonSerializer::Serialize(Summary, TJsonWriterFactory<>::Create(&SummaryJson));
+	FFileHelper::SaveStringToFile(SummaryJson, *this->Settings.OutputPath);
+	UE_LOG(LogOpenRTSCamera, Display, TEXT("RTSCamera.Flythrough summary written to %s"), *this->Settings.OutputPath);
+
+	if (this->Settings.BaselinePath.IsEmpty())
+	{
+		return true;
+	}
+
+	if (this->Settings.bUpdateBaseline)
+	{
+		FFileHelper::SaveStringToFile(SummaryJson, *this->Settings.BaselinePath);
+		UE_LOG(LogOpenRTSCamera, Display, TEXT("RTSCamera.Flythrough baseline updated at %s"), *this->Settings.BaselinePath);
+		return true;
+	}
+
+	FString BaselineJson;
+	TSharedPtr<FJsonObject> Baseline;
+	const TSharedPtr<FJsonObject>* BaselineMetrics = nullptr;
+	if (
+		!FFileHelper::LoadFileToString(BaselineJson, *this->Settings.BaselinePath)
+		|| !FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(BaselineJson), Baseline)
+		|| !Baseline.IsValid()
+		|| !Baseline->TryGetObjectField(TEXT("Metrics"), BaselineMetrics)
+	)
+	{
+		UE_LOG(LogOpenRTSCamera, Error, TEXT("RTSCamera.Flythrough: could not read baseline %s"), *this->Settings.BaselinePath);
+		return false;
+	}
+
+	if ((*BaselineMetrics)->Values.Num() == 0)
+	{
+		UE_LOG(
+			LogOpenRTSCamera,
+			Warning,
+			TEXT("RTSCamera.Flythrough: baseline %s has no measurements yet, not comparing. Record one with UpdateBaseline."),
+			*this->Settings.BaselinePath
+		);
+		return true;
+	}
+
+	auto bPassed = true;
+	for (auto Metric = 0; Metric < NumMetrics; Metric++)
+	{
+		const auto MetricName = GetMetricName(static_cast<EMetric>(Metric));
+		const TSharedPtr<FJsonObject>* BaselineMetric = nullptr;
+		double BaselineP95;
+		if (
+			!(*BaselineMetrics)->TryGetObjectField(MetricName, BaselineMetric)
+			|| !(*BaselineMetric)->TryGetNumberField(TEXT("P95"), BaselineP95)
+		)
+		{
+			continue;
+		}
+
+		if (CurrentP95[Metric] > BaselineP95 * (1 + this->Settings.Tolerance))
+		{
+			UE_LOG(
+				LogOpenRTSCamera,
+				Error,
+				TEXT("RTSCamera.Flythrough: %s p95 regressed from %.3f to %.3f"),
+				MetricName,
+				BaselineP95,
+				CurrentP95[Metric]
+			);
+			bPassed = false;
+		}
+	}
+
+	return bPassed;
+}
+
+const TCHAR* FRTSCameraFlythrough::GetMetricName(const EMetric Metric)
+{
+	switch (Metric)
+	{
+	case EMetric::GameThreadMs:
+		return TEXT("GameThreadMs");
+	case EMetric::CameraTickUs:
+		return TEXT("CameraTickUs");
+	case EMetric::SelectionUs:
+		return TEXT("SelectionUs");
+	case EMetric::Traces:
+		return TEXT("Traces");
+	case EMetric::UnitsTested:
+		return TEXT("UnitsTested");
+	default:
+		return TEXT("Unknown");
+	}
+}
+
+#endif
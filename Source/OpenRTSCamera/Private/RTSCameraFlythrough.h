@@ -0,0 +1,106 @@
+// Copyright 2024 Jesus Bracho All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RTSCameraProfiling.h"
+#include "Tickable.h"
+
+#if !UE_BUILD_SHIPPING
+
+class URTSCamera;
+
+/**
+ * Plays a scripted path through a URTSCamera (pans, zoom sweeps, rotations, edge scrolls and box selections over
+ * unit clusters) by injecting input into the camera's own handlers, while recording per-frame costs.
+ *
+ * Started with the `RTSCamera.Flythrough` console command, usually from the command line:
+ *	UnrealEditor-Cmd <Project> <Map> -game -ExecCmds="RTSCamera.Flythrough Baseline=<Path> Quit"
+ *
+ * Per-frame game thread time, camera tick cost, trace counts and selection cost are written to the CSV profiler when
+ * it is compiled in, and a p50/p95/p99 summary is written as JSON. Any metric whose p95 regressed by more than the
+ * tolerance against the baseline summary fails the run. The baseline is the plugin's Tests/Flythrough/Baseline.json
+ * unless another one is given, `UpdateBaseline` overwrites it with the run's summary. A baseline without measurements
+ * only reports. Like the profiling scopes, none of this is compiled into Shipping.
+ */
+class FRTSCameraFlythrough final : public FTickableGameObject, public IRTSCameraStageSink
+{
+public:
+	struct FSettings
+	{
+		// Seconds spent in each step of the script
+		float StepDuration = 4;
+		// How much worse than the baseline a p95 may get before the run fails, 0.1 is 10%
+		float Tolerance = 0.1f;
+		FString OutputPath;
+		FString BaselinePath;
+		// Writes the summary to BaselinePath instead of comparing against it
+		bool bUpdateBaseline = false;
+		bool bQuitWhenDone = false;
+	};
+
+	FRTSCameraFlythrough(URTSCamera* InCamera, const FSettings& InSettings);
+	virtual ~FRTSCameraFlythrough() override;
+
+	bool IsFinished() const { return this->bIsFinished; }
+
+	// FTickableGameObject
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override { return !this->bIsFinished; }
+	virtual ETickableTickType GetTickableTickType() const override { return ETickableTickType::Conditional; }
+	virtual TStatId GetStatId() const override;
+
+	// IRTSCameraStageSink
+	virtual void AddStageSample(ERTSCameraStage Stage, uint64 Cycles) override;
+	virtual void AddCounterSample(ERTSCameraCounter Counter, int32 Amount) override;
+
+private:
+	enum class EStep : uint8
+	{
+		PanForward,
+		PanRight,
+		ZoomIn,
+		ZoomOut,
+		Rotate,
+		EdgeScroll,
+		BoxSelect,
+		Num
+	};
+
+	enum class EMetric : uint8
+	{
+		GameThreadMs,
+		CameraTickUs,
+		SelectionUs,
+		Traces,
+		UnitsTested,
+		Num
+	};
+
+	void RecordFrame();
+	void DriveStep(EStep Step, float StepTime, float DeltaTime);
+	void DriveBoxSelection(float StepTime);
+	void SetNormalizedCursor(const FVector2D& NormalizedPosition) const;
+	void Finish();
+	void EndCsvCapture();
+	bool WriteSummaryAndCompare() const;
+
+	static const TCHAR* GetMetricName(EMetric Metric);
+
+	TWeakObjectPtr<URTSCamera> Camera;
+	FSettings Settings;
+	float ElapsedTime;
+	bool bIsFinished;
+	bool bIsSelecting;
+	// Set while a CSV capture this run started is going, a world torn down mid-run must not leave it open
+	bool bIsCapturingCsv;
+	int32 ClusterIndex;
+	// Stored with the summary so that a baseline says where it was measured
+	FString MapName;
+
+	uint64 FrameStageCycles[static_cast<int32>(ERTSCameraStage::Num)];
+	int32 FrameCounters[static_cast<int32>(ERTSCameraCounter::Num)];
+	TArray<double> Samples[static_cast<int32>(EMetric::Num)];
+};
+
+#endif
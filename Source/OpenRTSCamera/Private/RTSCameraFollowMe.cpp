@@ -0,0 +1,49 @@
+// Copyright 2024 Jesus Bracho All Rights Reserved.
+
+#include "RTSCameraFollowMe.h"
+#include "RTSCamera.h"
+#include "RTSCameraSystemLibrary.h"
+
+URTSCameraFollowMe::URTSCameraFollowMe()
+{
+	PrimaryComponentTick.bCanEverTick = false;
+	PlayerIndex = 0;
+	EnableFollowOnBeginPlay = false;
+}
+
+void URTSCameraFollowMe::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (this->EnableFollowOnBeginPlay)
+	{
+		this->FollowMe();
+	}
+}
+
+void URTSCameraFollowMe::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	// Leave the camera where the actor was instead of following a destroyed one
+	this->StopFollowingMe();
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void URTSCameraFollowMe::FollowMe()
+{
+	URTSCameraSystemLibrary::FollowActor(this, this->GetOwner(), this->PlayerIndex);
+}
+
+void URTSCameraFollowMe::StopFollowingMe()
+{
+	if (this->IsFollowingMe())
+	{
+		URTSCameraSystemLibrary::StopFollowing(this, this->PlayerIndex);
+	}
+}
+
+bool URTSCameraFollowMe::IsFollowingMe() const
+{
+	const auto Camera = URTSCameraSystemLibrary::GetRTSCamera(this, this->PlayerIndex);
+	return Camera != nullptr && this->GetOwner() != nullptr && Camera->GetFollowTarget() == this->GetOwner();
+}
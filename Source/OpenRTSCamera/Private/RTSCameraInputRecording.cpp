@@ -0,0 +1,417 @@
+// Copyright 2024 Jesus Bracho All Rights Reserved.
+
+#include "RTSCameraInputRecording.h"
+#include "RTSCameraProfiling.h"
+
+namespace RTSCameraInputRecording
+{
+	static constexpr uint8 Magic[4] = {'O', 'R', 'C', 'I'};
+	static constexpr uint8 Version = 1;
+
+	// Cursor positions are stored in sixteenths of a pixel
+	static constexpr double CursorScale = 16.0;
+	// Lossless fixed point axis values are stored in 256ths
+	static constexpr double AxisScale = 256.0;
+	static constexpr int64 MaxFixedAxisValue = 1 << 23;
+
+	static constexpr uint8 EventMask = 0x0F;
+	static constexpr uint8 BooleanValueFlag = 0x40;
+
+	static uint64 ZigZagEncode(const int64 Value)
+	{
+		return (static_cast<uint64>(Value) << 1) ^ static_cast<uint64>(Value >> 63);
+	}
+
+	static int64 ZigZagDecode(const uint64 Value)
+	{
+		return static_cast<int64>(Value >> 1) ^ -static_cast<int64>(Value & 1);
+	}
+
+	static void QuantizeCursor(FRTSCameraCursorSnapshot& Snapshot, int64 (&OutQuantized)[6])
+	{
+		FVector2D* Components[3] = {
+			&Snapshot.ViewportMousePosition,
+			&Snapshot.ViewportSize,
+			&Snapshot.PlayerMousePosition
+		};
+
+		for (auto Index = 0; Index < 3; Index++)
+		{
+			OutQuantized[Index * 2] = FMath::RoundToInt64(Components[Index]->X * CursorScale);
+			OutQuantized[Index * 2 + 1] = FMath::RoundToInt64(Components[Index]->Y * CursorScale);
+			Components[Index]->X = OutQuantized[Index * 2] / CursorScale;
+			Components[Index]->Y = OutQuantized[Index * 2 + 1] / CursorScale;
+		}
+	}
+}
+
+using namespace RTSCameraInputRecording;
+
+FRTSCameraInputRecorder::FRTSCameraInputRecorder(const FRTSCameraRecordingStart& Start)
+	: LastCursor{0, 0, 0, 0, 0, 0},
+	  LastFrameMicroseconds(0)
+{
+	// Roughly a minute of typical input, the array grows from there
+	this->Data.Reserve(32 * 1024);
+	this->Data.Append(Magic, UE_ARRAY_COUNT(Magic));
+	this->Data.Add(Version);
+
+	this->WriteDouble(Start.RootLocation.X);
+	this->WriteDouble(Start.RootLocation.Y);
+	this->WriteDouble(Start.RootLocation.Z);
+	this->WriteDouble(Start.RootRotation.Pitch);
+	this->WriteDouble(Start.RootRotation.Yaw);
+	this->WriteDouble(Start.RootRotation.Roll);
+	this->WriteDouble(Start.SpringArmRotation.Pitch);
+	this->WriteDouble(Start.SpringArmRotation.Yaw);
+	this->WriteDouble(Start.SpringArmRotation.Roll);
+	this->WriteFloat(Start.TargetArmLength);
+	this->WriteFloat(Start.DesiredZoomLength);
+	this->WriteFloat(Start.ZoomSpeed);
+	this->WriteFloat(Start.MoveSpeed);
+	this->WriteFloat(Start.EdgeScrollSpeed);
+}
+
+void FRTSCameraInputRecorder::RecordCursor(FRTSCameraCursorSnapshot& Snapshot)
+{
+	RTSCAMERA_LLM_SCOPE(InputRecording);
+
+	int64 Quantized[6];
+	QuantizeCursor(Snapshot, Quantized);
+
+	uint8 ChangedMask = 0;
+	for (auto Index = 0; Index < 6; Index++)
+	{
+		if (Quantized[Index] != this->LastCursor[Index])
+		{
+			ChangedMask |= 1 << Index;
+		}
+	}
+
+	if (ChangedMask == 0)
+	{
+		return;
+	}
+
+	this->WriteTag(ERTSCameraInputEvent::Cursor);
+	this->Data.Add(ChangedMask);
+	for (auto Index = 0; Index < 6; Index++)
+	{
+		if (ChangedMask & (1 << Index))
+		{
+			this->WriteVarInt(Quantized[Index] - this->LastCursor[Index]);
+			this->LastCursor[Index] = Quantized[Index];
+		}
+	}
+}
+
+void FRTSCameraInputRecorder::RecordInput(const ERTSCameraInputEvent Event, const FInputActionValue& Value)
+{
+	RTSCAMERA_LLM_SCOPE(InputRecording);
+
+	const auto ValueType = Value.GetValueType();
+	if (ValueType == EInputActionValueType::Boolean)
+	{
+		const uint8 Flags = static_cast<uint8>(ValueType) << 4 | (Value.Get<bool>() ? BooleanValueFlag : 0);
+		this->WriteTag(Event, Flags);
+		return;
+	}
+
+	this->WriteTag(Event, static_cast<uint8>(static_cast<uint8>(ValueType) << 4));
+
+	const auto Axis = Value.Get<FVector>();
+	const auto NumComponents = static_cast<int32>(ValueType);
+	for (auto Index = 0; Index < NumComponents; Index++)
+	{
+		this->WriteAxisValue(Axis[Index]);
+	}
+}
+
+float FRTSCameraInputRecorder::RecordFrame(const float DeltaSeconds)
+{
+	RTSCAMERA_LLM_SCOPE(InputRecording);
+
+	const auto Microseconds = FMath::RoundToInt64(static_cast<double>(DeltaSeconds) * 1000000.0);
+	this->WriteTag(ERTSCameraInputEvent::Frame);
+	this->WriteVarInt(Microseconds - this->LastFrameMicroseconds);
+	this->LastFrameMicroseconds = Microseconds;
+	return Microseconds / 1000000.0f;
+}
+
+void FRTSCameraInputRecorder::WriteTag(const ERTSCameraInputEvent Event, const uint8 Flags)
+{
+	this->Data.Add(static_cast<uint8>(Event) | Flags);
+}
+
+void FRTSCameraInputRecorder::WriteVarUInt(uint64 Value)
+{
+	while (Value >= 0x80)
+	{
+		this->Data.Add(static_cast<uint8>(Value) | 0x80);
+		Value >>= 7;
+	}
+	this->Data.Add(static_cast<uint8>(Value));
+}
+
+void FRTSCameraInputRecorder::WriteVarInt(const int64 Value)
+{
+	this->WriteVarUInt(ZigZagEncode(Value));
+}
+
+void FRTSCameraInputRecorder::WriteFloat(const float Value)
+{
+	uint32 Bits;
+	FMemory::Memcpy(&Bits, &Value, sizeof(Bits));
+	for (auto Byte = 0; Byte < 4; Byte++)
+	{
+		this->Data.Add(static_cast<uint8>(Bits >> (Byte * 8)));
+	}
+}
+
+void FRTSCameraInputRecorder::WriteDouble(const double Value)
+{
+	uint64 Bits;
+	FMemory::Memcpy(&Bits, &Value, sizeof(Bits));
+	for (auto Byte = 0; Byte < 8; Byte++)
+	{
+		this->Data.Add(static_cast<uint8>(Bits >> (Byte * 8)));
+	}
+}
+
+// Axis values are almost always -1, 0 or 1 (or another simple fraction), those are stored as a fixed point varint
+// with the low bit clear. Anything else is stored as a raw float behind a varint with the low bit set.
+void FRTSCameraInputRecorder::WriteAxisValue(const float Value)
+{
+	const auto Scaled = static_cast<double>(Value) * AxisScale;
+	const auto Fixed = static_cast<int64>(Scaled);
+	if (static_cast<double>(Fixed) == Scaled && FMath::Abs(Fixed) < MaxFixedAxisValue)
+	{
+		this->WriteVarUInt(ZigZagEncode(Fixed) << 1);
+	}
+	else
+	{
+		this->WriteVarUInt(1);
+		this->WriteFloat(Value);
+	}
+}
+
+FRTSCameraInputPlayer::FRTSCameraInputPlayer(TArray<uint8> InData)
+	: Data(MoveTemp(InData)),
+	  Offset(0),
+	  bIsValid(false),
+	  LastCursor{0, 0, 0, 0, 0, 0},
+	  LastFrameMicroseconds(0)
+{
+	if (this->Data.Num() < UE_ARRAY_COUNT(Magic) + 1)
+	{
+		return;
+	}
+
+	if (FMemory::Memcmp(this->Data.GetData(), Magic, UE_ARRAY_COUNT(Magic)) != 0)
+	{
+		return;
+	}
+
+	this->Offset = UE_ARRAY_COUNT(Magic);
+	uint8 StreamVersion;
+	if (!this->ReadByte(StreamVersion) || StreamVersion != Version)
+	{
+		return;
+	}
+
+	double Values[9];
+	for (auto& Value : Values)
+	{
+		if (!this->ReadDouble(Value))
+		{
+			return;
+		}
+	}
+
+	this->Start.RootLocation = FVector(Values[0], Values[1], Values[2]);
+	this->Start.RootRotation = FRotator(Values[3], Values[4], Values[5]);
+	this->Start.SpringArmRotation = FRotator(Values[6], Values[7], Values[8]);
+
+	this->bIsValid =
+		this->ReadFloat(this->Start.TargetArmLength)
+		&& this->ReadFloat(this->Start.DesiredZoomLength)
+		&& this->ReadFloat(this->Start.ZoomSpeed)
+		&& this->ReadFloat(this->Start.MoveSpeed)
+		&& this->ReadFloat(this->Start.EdgeScrollSpeed);
+}
+
+bool FRTSCameraInputPlayer::ReadNext(FRecord& OutRecord)
+{
+	uint8 Tag;
+	if (!this->bIsValid || !this->ReadByte(Tag))
+	{
+		return false;
+	}
+
+	OutRecord.Event = static_cast<ERTSCameraInputEvent>(Tag & EventMask);
+	switch (OutRecord.Event)
+	{
+	case ERTSCameraInputEvent::Frame:
+		{
+			int64 Delta;
+			if (!this->ReadVarInt(Delta))
+			{
+				return false;
+			}
+			this->LastFrameMicroseconds += Delta;
+			OutRecord.DeltaSeconds = this->LastFrameMicroseconds / 1000000.0f;
+			return true;
+		}
+
+	case ERTSCameraInputEvent::Cursor:
+		{
+			uint8 ChangedMask;
+			if (!this->ReadByte(ChangedMask))
+			{
+				return false;
+			}
+
+			for (auto Index = 0; Index < 6; Index++)
+			{
+				int64 Delta;
+				if (ChangedMask & (1 << Index))
+				{
+					if (!this->ReadVarInt(Delta))
+					{
+						return false;
+					}
+					this->LastCursor[Index] += Delta;
+				}
+			}
+
+			this->Cursor.ViewportMousePosition = FVector2D(this->LastCursor[0], this->LastCursor[1]) / CursorScale;
+			this->Cursor.ViewportSize = FVector2D(this->LastCursor[2], this->LastCursor[3]) / CursorScale;
+			this->Cursor.PlayerMousePosition = FVector2D(this->LastCursor[4], this->LastCursor[5]) / CursorScale;
+			OutRecord.Cursor = this->Cursor;
+			return true;
+		}
+
+	default:
+		{
+			if (OutRecord.Event >= ERTSCameraInputEvent::Num)
+			{
+				return false;
+			}
+
+			const auto ValueType = static_cast<EInputActionValueType>((Tag >> 4) & 0x03);
+			if (ValueType == EInputActionValueType::Boolean)
+			{
+				OutRecord.Value = FInputActionValue((Tag & BooleanValueFlag) != 0);
+				return true;
+			}
+
+			FVector Axis = FVector::ZeroVector;
+			const auto NumComponents = static_cast<int32>(ValueType);
+			for (auto Index = 0; Index < NumComponents; Index++)
+			{
+				float Component;
+				if (!this->ReadAxisValue(Component))
+				{
+					return false;
+				}
+				Axis[Index] = Component;
+			}
+
+			OutRecord.Value = FInputActionValue(ValueType, Axis);
+			return true;
+		}
+	}
+}
+
+bool FRTSCameraInputPlayer::ReadByte(uint8& OutValue)
+{
+	if (this->Offset >= this->Data.Num())
+	{
+		return false;
+	}
+
+	OutValue = this->Data[this->Offset++];
+	return true;
+}
+
+bool FRTSCameraInputPlayer::ReadVarUInt(uint64& OutValue)
+{
+	OutValue = 0;
+	for (auto Shift = 0; Shift < 64; Shift += 7)
+	{
+		uint8 Byte;
+		if (!this->ReadByte(Byte))
+		{
+			return false;
+		}
+
+		OutValue |= static_cast<uint64>(Byte & 0x7F) << Shift;
+		if ((Byte & 0x80) == 0)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool FRTSCameraInputPlayer::ReadVarInt(int64& OutValue)
+{
+	uint64 Encoded;
+	if (!this->ReadVarUInt(Encoded))
+	{
+		return false;
+	}
+
+	OutValue = ZigZagDecode(Encoded);
+	return true;
+}
+
+bool FRTSCameraInputPlayer::ReadFloat(float& OutValue)
+{
+	if (this->Offset + 4 > this->Data.Num())
+	{
+		return false;
+	}
+
+	uint32 Bits = 0;
+	for (auto Byte = 0; Byte < 4; Byte++)
+	{
+		Bits |= static_cast<uint32>(this->Data[this->Offset++]) << (Byte * 8);
+	}
+	FMemory::Memcpy(&OutValue, &Bits, sizeof(Bits));
+	return true;
+}
+
+bool FRTSCameraInputPlayer::ReadDouble(double& OutValue)
+{
+	if (this->Offset + 8 > this->Data.Num())
+	{
+		return false;
+	}
+
+	uint64 Bits = 0;
+	for (auto Byte = 0; Byte < 8; Byte++)
+	{
+		Bits |= static_cast<uint64>(this->Data[this->Offset++]) << (Byte * 8);
+	}
+	FMemory::Memcpy(&OutValue, &Bits, sizeof(Bits));
+	return true;
+}
+
+bool FRTSCameraInputPlayer::ReadAxisValue(float& OutValue)
+{
+	uint64 Encoded;
+	if (!this->ReadVarUInt(Encoded))
+	{
+		return false;
+	}
+
+	if (Encoded & 1)
+	{
+		return this->ReadFloat(OutValue);
+	}
+
+	OutValue = static_cast<float>(ZigZagDecode(Encoded >> 1) / AxisScale);
+	return true;
+}
@@ -0,0 +1,97 @@
+// Copyright 2024 Jesus Bracho All Rights Reserved.
+
+#include "RTSCameraProfiling.h"
+
+DEFINE_STAT(STAT_RTSCamera_Tick);
+DEFINE_STAT(STAT_RTSCamera_MoveCommands);
+DEFINE_STAT(STAT_RTSCamera_EdgeScrolling);
+DEFINE_STAT(STAT_RTSCamera_GroundHeight);
+DEFINE_STAT(STAT_RTSCamera_ZoomSmoothing);
+DEFINE_STAT(STAT_RTSCamera_Follow);
+DEFINE_STAT(STAT_RTSCamera_Bounds);
+DEFINE_STAT(STAT_RTSCamera_SelectionQuery);
+DEFINE_STAT(STAT_RTSCamera_SelectionDiff);
+DEFINE_STAT(STAT_RTSCamera_SelectionDispatch);
+DEFINE_STAT(STAT_RTSCamera_Significance);
+DEFINE_STAT(STAT_RTSCamera_Prefetch);
+DEFINE_STAT(STAT_RTSCamera_Traces);
+DEFINE_STAT(STAT_RTSCamera_UnitsTested);
+DEFINE_STAT(STAT_RTSCamera_ViewUpdatesSent);
+
+UE_TRACE_CHANNEL_DEFINE(OpenRTSCameraChannel);
+
+LLM_DEFINE_TAG(OpenRTSCamera);
+LLM_DEFINE_TAG(OpenRTSCamera_Camera, TEXT("Camera"), TEXT("OpenRTSCamera"));
+LLM_DEFINE_TAG(OpenRTSCamera_Commands, TEXT("Commands"), TEXT("OpenRTSCamera"));
+LLM_DEFINE_TAG(OpenRTSCamera_Selection, TEXT("Selection"), TEXT("OpenRTSCamera"));
+LLM_DEFINE_TAG(OpenRTSCamera_SpatialIndex, TEXT("Spatial Index"), TEXT("OpenRTSCamera"));
+LLM_DEFINE_TAG(OpenRTSCamera_Replication, TEXT("Replication"), TEXT("OpenRTSCamera"));
+LLM_DEFINE_TAG(OpenRTSCamera_InputRecording, TEXT("Input Recording"), TEXT("OpenRTSCamera"));
+
+IRTSCameraStageSink* RTSCameraProfiling::StageSink = nullptr;
+
+void RTSCameraProfiling::SetStageSink(IRTSCameraStageSink* Sink)
+{
+	check(IsInGameThread());
+	StageSink = Sink;
+}
+
+const TCHAR* RTSCameraProfiling::GetStageName(const ERTSCameraStage Stage)
+{
+	switch (Stage)
+	{
+	case ERTSCameraStage::MoveCommands:
+		return TEXT("MoveCommands");
+	case ERTSCameraStage::EdgeScrolling:
+		return TEXT("EdgeScrolling");
+	case ERTSCameraStage::GroundHeight:
+		return TEXT("GroundHeight");
+	case ERTSCameraStage::ZoomSmoothing:
+		return TEXT("ZoomSmoothing");
+	case ERTSCameraStage::Follow:
+		return TEXT("Follow");
+	case ERTSCameraStage::Bounds:
+		return TEXT("Bounds");
+	case ERTSCameraStage::SelectionQuery:
+		return TEXT("SelectionQuery");
+	case ERTSCameraStage::SelectionDiff:
+		return TEXT("SelectionDiff");
+	case ERTSCameraStage::SelectionDispatch:
+		return TEXT("SelectionDispatch");
+	case ERTSCameraStage::Significance:
+		return TEXT("Significance");
+	case ERTSCameraStage::Prefetch:
+		return TEXT("Prefetch");
+	default:
+		return TEXT("Unknown");
+	}
+}
+
+const TCHAR* RTSCameraProfiling::GetCounterName(const ERTSCameraCounter Counter)
+{
+	switch (Counter)
+	{
+	case ERTSCameraCounter::Traces:
+		return TEXT("Traces");
+	case ERTSCameraCounter::UnitsTested:
+		return TEXT("UnitsTested");
+	case ERTSCameraCounter::ViewUpdatesSent:
+		return TEXT("ViewUpdatesSent");
+	default:
+		return TEXT("Unknown");
+	}
+}
+
+double RTSCameraProfiling::Percentile(TArray<double>& Samples, const double Percent)
+{
+	if (Samples.Num() == 0)
+	{
+		return 0;
+	}
+
+	Samples.Sort();
+	const auto Rank = FMath::Clamp(Percent / 100.0, 0.0, 1.0) * (Samples.Num() - 1);
+	const auto Lower = FMath::FloorToInt32(Rank);
+	const auto Upper = FMath::Min(Lower + 1, Samples.Num() - 1);
+	return FMath::Lerp(Samples[Lower], Samples[Upper], Rank - Lower);
+}
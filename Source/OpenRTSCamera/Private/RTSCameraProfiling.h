@@ -0,0 +1,164 @@
+// Copyright 2024 Jesus Bracho All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/LowLevelMemTracker.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "Stats/Stats.h"
+#include "Trace/Trace.h"
+
+/**
+ * `stat OpenRTSCamera` shows these, and every stage is a CPU event on the OpenRTSCamera trace channel so Insights can
+ * show camera cost with `-trace=cpu,OpenRTSCamera`.
+ */
+DECLARE_STATS_GROUP(TEXT("OpenRTSCamera"), STATGROUP_OpenRTSCamera, STATCAT_Advanced);
+
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Camera Tick"), STAT_RTSCamera_Tick, STATGROUP_OpenRTSCamera, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Move Commands"), STAT_RTSCamera_MoveCommands, STATGROUP_OpenRTSCamera, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Edge Scrolling"), STAT_RTSCamera_EdgeScrolling, STATGROUP_OpenRTSCamera, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Ground Height"), STAT_RTSCamera_GroundHeight, STATGROUP_OpenRTSCamera, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Zoom Smoothing"), STAT_RTSCamera_ZoomSmoothing, STATGROUP_OpenRTSCamera, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Follow"), STAT_RTSCamera_Follow, STATGROUP_OpenRTSCamera, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Bounds"), STAT_RTSCamera_Bounds, STATGROUP_OpenRTSCamera, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Selection Query"), STAT_RTSCamera_SelectionQuery, STATGROUP_OpenRTSCamera, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Selection Diff"), STAT_RTSCamera_SelectionDiff, STATGROUP_OpenRTSCamera, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Selection Dispatch"), STAT_RTSCamera_SelectionDispatch, STATGROUP_OpenRTSCamera, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Significance"), STAT_RTSCamera_Significance, STATGROUP_OpenRTSCamera, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Prefetch"), STAT_RTSCamera_Prefetch, STATGROUP_OpenRTSCamera, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Traces"), STAT_RTSCamera_Traces, STATGROUP_OpenRTSCamera, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Units Tested"), STAT_RTSCamera_UnitsTested, STATGROUP_OpenRTSCamera, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("View Updates Sent"), STAT_RTSCamera_ViewUpdatesSent, STATGROUP_OpenRTSCamera, );
+
+UE_TRACE_CHANNEL_EXTERN(OpenRTSCameraChannel);
+
+/**
+ * Everything the plugin allocates is tagged below OpenRTSCamera, see `-llm` captures or `stat LLMFULL`.
+ * Use RTSCAMERA_LLM_SCOPE at every entry point that may allocate.
+ */
+LLM_DECLARE_TAG(OpenRTSCamera);
+LLM_DECLARE_TAG(OpenRTSCamera_Camera);
+LLM_DECLARE_TAG(OpenRTSCamera_Commands);
+LLM_DECLARE_TAG(OpenRTSCamera_Selection);
+LLM_DECLARE_TAG(OpenRTSCamera_SpatialIndex);
+LLM_DECLARE_TAG(OpenRTSCamera_Replication);
+LLM_DECLARE_TAG(OpenRTSCamera_InputRecording);
+
+/** Tag is the part after OpenRTSCamera_, e.g. RTSCAMERA_LLM_SCOPE(Selection). */
+#define RTSCAMERA_LLM_SCOPE(Tag) LLM_SCOPE_BYTAG(OpenRTSCamera_##Tag)
+
+/**
+ * The stages of the camera tick and of a selection that can be timed individually.
+ */
+enum class ERTSCameraStage : uint8
+{
+	MoveCommands,
+	EdgeScrolling,
+	GroundHeight,
+	ZoomSmoothing,
+	Follow,
+	Bounds,
+	SelectionQuery,
+	SelectionDiff,
+	SelectionDispatch,
+	Significance,
+	// The hover query of asset prefetching, kept apart from box selection
+	Prefetch,
+	Num
+};
+
+/**
+ * Amounts of work the camera does that are worth counting next to the stage timings.
+ */
+enum class ERTSCameraCounter : uint8
+{
+	Traces,
+	UnitsTested,
+	ViewUpdatesSent,
+	Num
+};
+
+/**
+ * Receives the time spent in each camera stage.
+ * Benchmarks and performance runs install one with RTSCameraProfiling::SetStageSink, nothing is timed otherwise.
+ */
+class IRTSCameraStageSink
+{
+public:
+	virtual ~IRTSCameraStageSink() = default;
+	virtual void AddStageSample(ERTSCameraStage Stage, uint64 Cycles) = 0;
+	virtual void AddCounterSample(ERTSCameraCounter Counter, int32 Amount) {}
+};
+
+namespace RTSCameraProfiling
+{
+	extern IRTSCameraStageSink* StageSink;
+
+	/** Installs the sink that receives stage timings, pass nullptr to stop timing. Game thread only. */
+	void SetStageSink(IRTSCameraStageSink* Sink);
+
+	const TCHAR* GetStageName(ERTSCameraStage Stage);
+
+	const TCHAR* GetCounterName(ERTSCameraCounter Counter);
+
+	inline void AddCounter(const ERTSCameraCounter Counter, const int32 Amount)
+	{
+		if (StageSink != nullptr)
+		{
+			StageSink->AddCounterSample(Counter, Amount);
+		}
+	}
+
+	/** Returns the given percentile (0 to 100) of the samples, sorting them in place. */
+	double Percentile(TArray<double>& Samples, double Percent);
+}
+
+/**
+ * Times the enclosing scope and reports it to the installed stage sink.
+ */
+class FRTSCameraStageScope
+{
+public:
+	explicit FRTSCameraStageScope(const ERTSCameraStage InStage)
+		: Stage(InStage),
+		  StartCycles(RTSCameraProfiling::StageSink != nullptr ? FPlatformTime::Cycles64() : 0)
+	{
+	}
+
+	~FRTSCameraStageScope()
+	{
+		if (RTSCameraProfiling::StageSink != nullptr && this->StartCycles != 0)
+		{
+			RTSCameraProfiling::StageSink->AddStageSample(this->Stage, FPlatformTime::Cycles64() - this->StartCycles);
+		}
+	}
+
+private:
+	ERTSCameraStage Stage;
+	uint64 StartCycles;
+};
+
+/**
+ * Stage scopes feed the stat system, Insights and the installed stage sink at once.
+ * Stage and Counter are the enumerator names, e.g. RTSCAMERA_STAGE_SCOPE(Bounds).
+ */
+#if !UE_BUILD_SHIPPING
+#define RTSCAMERA_TICK_SCOPE() \
+	SCOPE_CYCLE_COUNTER(STAT_RTSCamera_Tick); \
+	TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(RTSCamera_Tick, OpenRTSCameraChannel)
+#define RTSCAMERA_STAGE_SCOPE(Stage) \
+	SCOPE_CYCLE_COUNTER(STAT_RTSCamera_##Stage); \
+	TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(RTSCamera_##Stage, OpenRTSCameraChannel); \
+	const FRTSCameraStageScope ANONYMOUS_VARIABLE(RTSCameraStageScope)(ERTSCameraStage::Stage)
+#define RTSCAMERA_COUNTER_ADD(Counter, Amount) \
+	do \
+	{ \
+		INC_DWORD_STAT_BY(STAT_RTSCamera_##Counter, Amount); \
+		RTSCameraProfiling::AddCounter(ERTSCameraCounter::Counter, Amount); \
+	} \
+	while (0)
+#else
+#define RTSCAMERA_TICK_SCOPE()
+#define RTSCAMERA_STAGE_SCOPE(Stage)
+#define RTSCAMERA_COUNTER_ADD(Counter, Amount)
+#endif
@@ -0,0 +1,87 @@
+// Copyright 2024 Jesus Bracho All Rights Reserved.
+
+#include "RTSCameraReplicatedView.h"
+#include "RTSCameraKinematics.h"
+
+using namespace RTSCameraKinematics;
+
+FRTSCameraViewPose FRTSCameraViewPose::Lerp(
+	const FRTSCameraViewPose& From,
+	const FRTSCameraViewPose& To,
+	const float Alpha
+)
+{
+	FRTSCameraViewPose Pose;
+	Pose.RootLocation = FMath::Lerp(From.RootLocation, To.RootLocation, Alpha);
+	Pose.Yaw = static_cast<float>(LerpAngle(From.Yaw, To.Yaw, Alpha));
+	Pose.Pitch = static_cast<float>(LerpAngle(From.Pitch, To.Pitch, Alpha));
+	Pose.ZoomLength = FMath::Lerp(From.ZoomLength, To.ZoomLength, Alpha);
+	return Pose;
+}
+
+FRTSCameraReplicatedView FRTSCameraReplicatedView::Quantize(
+	const FRTSCameraViewPose& Pose,
+	const FBox& Bounds,
+	const float MinimumZoomLength,
+	const float MaximumZoomLength
+)
+{
+	FRTSCameraReplicatedView View;
+	View.X = QuantizeToUint16(Pose.RootLocation.X, Bounds.Min.X, Bounds.Max.X);
+	View.Y = QuantizeToUint16(Pose.RootLocation.Y, Bounds.Min.Y, Bounds.Max.Y);
+	View.Z = QuantizeToUint16(Pose.RootLocation.Z, Bounds.Min.Z, Bounds.Max.Z);
+	View.Yaw = QuantizeAngleToUint16(Pose.Yaw);
+	View.Pitch = QuantizeAngleToUint16(Pose.Pitch);
+	View.Zoom = QuantizeToUint16(Pose.ZoomLength, MinimumZoomLength, MaximumZoomLength);
+	return View;
+}
+
+FRTSCameraViewPose FRTSCameraReplicatedView::Dequantize(
+	const FBox& Bounds,
+	const float MinimumZoomLength,
+	const float MaximumZoomLength
+) const
+{
+	FRTSCameraViewPose Pose;
+	Pose.RootLocation = FVector(
+		DequantizeFromUint16(this->X, Bounds.Min.X, Bounds.Max.X),
+		DequantizeFromUint16(this->Y, Bounds.Min.Y, Bounds.Max.Y),
+		DequantizeFromUint16(this->Z, Bounds.Min.Z, Bounds.Max.Z)
+	);
+	// Back into (-180, 180] so that the pitch reads like the one the sender set
+	Pose.Yaw = FRotator::NormalizeAxis(static_cast<float>(DequantizeAngleFromUint16(this->Yaw)));
+	Pose.Pitch = FRotator::NormalizeAxis(static_cast<float>(DequantizeAngleFromUint16(this->Pitch)));
+	Pose.ZoomLength = static_cast<float>(DequantizeFromUint16(this->Zoom, MinimumZoomLength, MaximumZoomLength));
+	return Pose;
+}
+
+int32 FRTSCameraReplicatedView::GetLargestStepDifference(
+	const FRTSCameraReplicatedView& A,
+	const FRTSCameraReplicatedView& B
+)
+{
+	// Angles wrap around, one step past the last one is the first one
+	const auto AngleDifference = [](const uint16 First, const uint16 Second)
+	{
+		const auto Difference = FMath::Abs(First - Second);
+		return FMath::Min(Difference, 65536 - Difference);
+	};
+
+	return FMath::Max(
+		FMath::Max3(FMath::Abs(A.X - B.X), FMath::Abs(A.Y - B.Y), FMath::Abs(A.Z - B.Z)),
+		FMath::Max3(AngleDifference(A.Yaw, B.Yaw), AngleDifference(A.Pitch, B.Pitch), FMath::Abs(A.Zoom - B.Zoom))
+	);
+}
+
+bool FRTSCameraReplicatedView::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	Ar << this->X;
+	Ar << this->Y;
+	Ar << this->Z;
+	Ar << this->Yaw;
+	Ar << this->Pitch;
+	Ar << this->Zoom;
+
+	bOutSuccess = true;
+	return true;
+}
@@ -0,0 +1,86 @@
+// Copyright 2024 Jesus Bracho All Rights Reserved.
+
+#include "RTSCameraSequenceAction.h"
+#include "RTSCamera.h"
+
+URTSCameraSequenceAction* URTSCameraSequenceAction::MoveCameraTo(
+	URTSCamera* Camera,
+	const FVector Location,
+	const float Duration
+)
+{
+	return Create(Camera, FRTSCameraOperation::MoveTo(Location, Duration));
+}
+
+URTSCameraSequenceAction* URTSCameraSequenceAction::ZoomCameraTo(
+	URTSCamera* Camera,
+	const float ZoomLength,
+	const float Duration
+)
+{
+	return Create(Camera, FRTSCameraOperation::ZoomTo(ZoomLength, Duration));
+}
+
+URTSCameraSequenceAction* URTSCameraSequenceAction::RotateCameraTo(
+	URTSCamera* Camera,
+	const float Yaw,
+	const float Duration
+)
+{
+	return Create(Camera, FRTSCameraOperation::RotateTo(Yaw, Duration));
+}
+
+URTSCameraSequenceAction* URTSCameraSequenceAction::FollowWithCamera(
+	URTSCamera* Camera,
+	AActor* Target,
+	const float Duration
+)
+{
+	return Create(Camera, FRTSCameraOperation::Follow(Target, Duration));
+}
+
+URTSCameraSequenceAction* URTSCameraSequenceAction::WaitForCameraToSettle(URTSCamera* Camera, const float Timeout)
+{
+	return Create(Camera, FRTSCameraOperation::WaitUntilSettled(Timeout));
+}
+
+URTSCameraSequenceAction* URTSCameraSequenceAction::Create(URTSCamera* Camera, FRTSCameraOperation&& Operation)
+{
+	const auto Action = NewObject<URTSCameraSequenceAction>();
+	Action->Camera = Camera;
+	Action->Operation = MoveTemp(Operation);
+	Action->RegisterWithGameInstance(Camera);
+	return Action;
+}
+
+void URTSCameraSequenceAction::Activate()
+{
+	if (this->Camera == nullptr)
+	{
+		this->OnOperationFinished(false);
+		return;
+	}
+
+	// Registered with the game instance, the action stays alive until the camera calls back
+	this->Operation.OnFinished = [WeakThis = TWeakObjectPtr<URTSCameraSequenceAction>(this)](const bool IsFinished)
+	{
+		if (WeakThis.IsValid())
+		{
+			WeakThis->OnOperationFinished(IsFinished);
+		}
+	};
+	this->Camera->QueueCameraOperation(MoveTemp(this->Operation));
+}
+
+void URTSCameraSequenceAction::OnOperationFinished(const bool IsFinished)
+{
+	if (IsFinished)
+	{
+		this->Finished.Broadcast();
+	}
+	else
+	{
+		this->Cancelled.Broadcast();
+	}
+	this->SetReadyToDestroy();
+}
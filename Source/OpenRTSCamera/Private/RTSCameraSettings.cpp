@@ -0,0 +1,48 @@
+// Copyright 2024 Jesus Bracho All Rights Reserved.
+
+#include "RTSCameraSettings.h"
+#include "InputAction.h"
+#include "InputMappingContext.h"
+
+URTSCameraSettings::URTSCameraSettings()
+{
+	// Mirrors Config/DefaultOpenRTSCamera.ini so that the plugin works even if the config file is missing
+	this->InputMappingContext = TSoftObjectPtr<UInputMappingContext>(
+		FSoftObjectPath(TEXT("/OpenRTSCamera/Inputs/OpenRTSCameraInputs.OpenRTSCameraInputs"))
+	);
+	this->RotateCameraAxis = TSoftObjectPtr<UInputAction>(
+		FSoftObjectPath(TEXT("/OpenRTSCamera/Inputs/RotateCameraAxis.RotateCameraAxis"))
+	);
+	this->TurnCameraLeft = TSoftObjectPtr<UInputAction>(
+		FSoftObjectPath(TEXT("/OpenRTSCamera/Inputs/TurnCameraLeft.TurnCameraLeft"))
+	);
+	this->TurnCameraRight = TSoftObjectPtr<UInputAction>(
+		FSoftObjectPath(TEXT("/OpenRTSCamera/Inputs/TurnCameraRight.TurnCameraRight"))
+	);
+	this->MoveCameraYAxis = TSoftObjectPtr<UInputAction>(
+		FSoftObjectPath(TEXT("/OpenRTSCamera/Inputs/MoveCameraYAxis.MoveCameraYAxis"))
+	);
+	this->MoveCameraXAxis = TSoftObjectPtr<UInputAction>(
+		FSoftObjectPath(TEXT("/OpenRTSCamera/Inputs/MoveCameraXAxis.MoveCameraXAxis"))
+	);
+	this->ZoomCamera = TSoftObjectPtr<UInputAction>(
+		FSoftObjectPath(TEXT("/OpenRTSCamera/Inputs/ZoomCamera.ZoomCamera"))
+	);
+	this->BeginSelection = TSoftObjectPtr<UInputAction>(
+		FSoftObjectPath(TEXT("/OpenRTSCamera/Inputs/BeginSelection.BeginSelection"))
+	);
+	this->InputAssetLoadTimeout = 0.5f;
+	this->EnableSignificance = true;
+	this->SignificanceCloseDistance = 5000.f;
+	this->SignificanceHysteresis = 500.f;
+	this->SignificanceMaxViewDistance = 50000.f;
+	this->EnableAssetPrefetch = false;
+	this->AssetPrefetchBudgetMB = 256.f;
+	this->AssetPrefetchMaxTypes = 64;
+	this->HoverPrefetchInterval = 0.1f;
+}
+
+FName URTSCameraSettings::GetCategoryName() const
+{
+	return FName("Plugins");
+}
@@ -0,0 +1,678 @@
+// Copyright 2024 Jesus Bracho All Rights Reserved.
+
+#include "RTSCameraSubsystem.h"
+#include "RTSCamera.h"
+#include "RTSCameraProfiling.h"
+#include "RTSCameraSettings.h"
+#include "RTSHUD.h"
+#include "RTSSelectable.h"
+#include "Engine/World.h"
+#include "GameFramework/MovementComponent.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+
+namespace RTSCameraSubsystem
+{
+	// Edge length of a selectable grid cell, a few units wide at typical unit spacing
+	static constexpr double CellSize = 2000;
+}
+
+void FRTSCameraSubsystemTickFunction::ExecuteTick(
+	const float DeltaTime,
+	ELevelTick TickType,
+	ENamedThreads::Type CurrentThread,
+	const FGraphEventRef& MyCompletionGraphEvent
+)
+{
+	if (this->Subsystem != nullptr)
+	{
+		this->Subsystem->TickCameras(DeltaTime);
+	}
+}
+
+FString FRTSCameraSubsystemTickFunction::DiagnosticMessage()
+{
+	return TEXT("URTSCameraSubsystem::TickCameras");
+}
+
+bool URTSCameraSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void URTSCameraSubsystem::Deinitialize()
+{
+	if (this->TickFunction.IsTickFunctionRegistered())
+	{
+		this->TickFunction.UnRegisterTickFunction();
+	}
+
+	this->Cameras.Empty();
+	this->SelectableCells.Empty();
+	this->SelectableCellCoordinates.Empty();
+	this->SelectablesByUnitId.Empty();
+	this->UnitClusters.Empty();
+	this->UnitClusterMemberships.Empty();
+
+	Super::Deinitialize();
+}
+
+void URTSCameraSubsystem::RegisterCamera(URTSCamera* Camera)
+{
+	RTSCAMERA_LLM_SCOPE(Camera);
+
+	this->Cameras.AddUnique(Camera);
+	Camera->SetComponentTickEnabled(false);
+	this->UpdateTickFunction();
+}
+
+void URTSCameraSubsystem::UnregisterCamera(URTSCamera* Camera)
+{
+	this->Cameras.Remove(Camera);
+	this->UpdateTickFunction();
+}
+
+void URTSCameraSubsystem::UpdateTickFunction()
+{
+	if (this->Cameras.Num() == 0)
+	{
+		if (this->TickFunction.IsTickFunctionRegistered())
+		{
+			this->TickFunction.UnRegisterTickFunction();
+		}
+		return;
+	}
+
+	// Run as late as the latest camera wants to, none of them ticks earlier than it asked for
+	auto TickGroup = TG_PrePhysics;
+	for (const auto Camera : this->Cameras)
+	{
+		TickGroup = FMath::Max(TickGroup, Camera->CameraTickGroup.GetValue());
+	}
+	this->TickFunction.TickGroup = TickGroup;
+
+	if (!this->TickFunction.IsTickFunctionRegistered())
+	{
+		this->TickFunction.bCanEverTick = true;
+		this->TickFunction.Subsystem = this;
+		this->TickFunction.RegisterTickFunction(this->GetWorld()->PersistentLevel);
+	}
+
+	this->RefreshTickPrerequisites();
+}
+
+void URTSCameraSubsystem::RefreshTickPrerequisites()
+{
+	// Copied, removing modifies the array
+	const auto Prerequisites = this->TickFunction.GetPrerequisites();
+	for (const auto& Prerequisite : Prerequisites)
+	{
+		if (const auto PrerequisiteObject = Prerequisite.PrerequisiteObject.Get())
+		{
+			this->TickFunction.RemovePrerequisite(PrerequisiteObject, *Prerequisite.PrerequisiteTickFunction);
+		}
+	}
+
+	for (const auto Camera : this->Cameras)
+	{
+		if (const auto Target = Camera->CameraFollowTarget)
+		{
+			this->TickFunction.AddPrerequisite(Target, Target->PrimaryActorTick);
+
+			if (const auto MovementComponent = Target->FindComponentByClass<UMovementComponent>())
+			{
+				this->TickFunction.AddPrerequisite(MovementComponent, MovementComponent->PrimaryComponentTick);
+			}
+		}
+	}
+}
+
+APlayerController* URTSCameraSubsystem::FindPlayerControllerForCamera(const URTSCamera* Camera) const
+{
+	if (const auto Pawn = Cast<APawn>(Camera->GetOwner()))
+	{
+		if (const auto PawnController = Pawn->GetController<APlayerController>())
+		{
+			if (PawnController->IsLocalController())
+			{
+				return PawnController;
+			}
+		}
+	}
+
+	APlayerController* FirstLocalController = nullptr;
+	for (auto It = this->GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		const auto Controller = It->Get();
+		if (Controller == nullptr || !Controller->IsLocalController())
+		{
+			continue;
+		}
+
+		const auto IsClaimed = this->Cameras.ContainsByPredicate(
+			[Camera, Controller](const URTSCamera* Other)
+			{
+				return Other != Camera && Other->PlayerController == Controller;
+			}
+		);
+
+		if (!IsClaimed)
+		{
+			return Controller;
+		}
+
+		if (FirstLocalController == nullptr)
+		{
+			FirstLocalController = Controller;
+		}
+	}
+
+	// Several cameras on one controller, switched between with SetActiveCamera
+	return FirstLocalController;
+}
+
+void URTSCameraSubsystem::GetBoundaryVolumeBounds(const AActor* Volume, FVector& OutOrigin, FVector& OutExtents)
+{
+	if (this->BoundaryVolumeBoundsFrame != GFrameCounter)
+	{
+		this->BoundaryVolumeBoundsFrame = GFrameCounter;
+		this->BoundaryVolumeBounds.Reset();
+	}
+
+	if (const auto Bounds = this->BoundaryVolumeBounds.Find(Volume))
+	{
+		Bounds->GetCenterAndExtents(OutOrigin, OutExtents);
+		return;
+	}
+
+	Volume->GetActorBounds(false, OutOrigin, OutExtents);
+	this->BoundaryVolumeBounds.Add(Volume, FBox::BuildAABB(OutOrigin, OutExtents));
+}
+
+void URTSCameraSubsystem::TickCameras(const float DeltaTime)
+{
+	RTSCAMERA_TICK_SCOPE();
+	RTSCAMERA_LLM_SCOPE(Camera);
+
+	// Input and simulation are per camera, the ground and the bounds wait for the batched passes below
+	this->ActiveCameras.Reset();
+	for (const auto Camera : this->Cameras)
+	{
+		if (IsValid(Camera) && Camera->TickCamera(DeltaTime, true))
+		{
+			this->ActiveCameras.Add(Camera);
+		}
+	}
+
+	{
+		RTSCAMERA_STAGE_SCOPE(GroundHeight);
+
+		this->GroundTraces.Reset();
+		for (const auto Camera : this->ActiveCameras)
+		{
+			FGroundTrace GroundTrace;
+			if (Camera->GetGroundTrace(GroundTrace.Start, GroundTrace.End))
+			{
+				GroundTrace.Camera = Camera;
+				GroundTrace.CollisionChannel = Camera->CollisionChannel;
+				this->GroundTraces.Add(GroundTrace);
+			}
+		}
+
+		const auto World = this->GetWorld();
+		const auto QueryParams = URTSCamera::GetGroundTraceQueryParams();
+		for (auto& GroundTrace : this->GroundTraces)
+		{
+			GroundTrace.DidHit = World->LineTraceSingleByChannel(
+				GroundTrace.HitResult,
+				GroundTrace.Start,
+				GroundTrace.End,
+				GroundTrace.CollisionChannel,
+				QueryParams
+			);
+		}
+		RTSCAMERA_COUNTER_ADD(Traces, this->GroundTraces.Num());
+
+		for (const auto& GroundTrace : this->GroundTraces)
+		{
+			GroundTrace.Camera->ApplyGroundTrace(GroundTrace.DidHit, GroundTrace.HitResult);
+		}
+	}
+
+	for (const auto Camera : this->ActiveCameras)
+	{
+		Camera->ConditionallyApplyCameraBounds();
+	}
+
+	for (const auto Camera : this->ActiveCameras)
+	{
+		Camera->FinishCameraTick();
+	}
+
+	this->UpdateSignificance();
+}
+
+int32 URTSCameraSubsystem::GetNumSelectablesInSignificanceTier(const ERTSSignificanceTier Tier) const
+{
+	return Tier < ERTSSignificanceTier::Num ? this->NumSelectablesInSignificanceTier[static_cast<int32>(Tier)] : 0;
+}
+
+void URTSCameraSubsystem::UpdateSignificance()
+{
+	const auto Settings = GetDefault<URTSCameraSettings>();
+	if (!Settings->EnableSignificance)
+	{
+		return;
+	}
+
+	// Without a local view there is nothing to rank against, units keep their last tiers
+	this->ViewFootprints.Reset();
+	for (const auto Camera : this->ActiveCameras)
+	{
+		if (Camera->GetViewFootprint().IsValid)
+		{
+			this->ViewFootprints.Add(&Camera->GetViewFootprint());
+		}
+	}
+	if (this->ViewFootprints.Num() == 0)
+	{
+		return;
+	}
+
+	RTSCAMERA_STAGE_SCOPE(Significance);
+
+	this->SignificanceChanges.Reset();
+	const auto Hysteresis = Settings->SignificanceHysteresis;
+	for (auto& [CellCoordinates, Cell] : this->SelectableCells)
+	{
+		UpdateCellBounds(Cell);
+
+		const auto CellBounds = FBox2D(FVector2D(Cell.Bounds.Min), FVector2D(Cell.Bounds.Max));
+		const auto IsCellNearView = this->ViewFootprints.ContainsByPredicate(
+			[&CellBounds, Hysteresis](const FRTSCameraViewFootprint* Footprint)
+			{
+				return CellBounds.Intersect(Footprint->Bounds.ExpandBy(Hysteresis));
+			}
+		);
+
+		for (const auto Selectable : Cell.Selectables)
+		{
+			const auto Tier = IsCellNearView
+				? this->ComputeSignificanceTier(Selectable)
+				: ERTSSignificanceTier::OffScreen;
+			if (Tier != Selectable->SignificanceTier)
+			{
+				this->SignificanceChanges.Emplace(Selectable, Tier);
+			}
+		}
+	}
+
+	// Applied after the walk over the cells, handlers may move, spawn or destroy units
+	for (const auto& [Selectable, Tier] : this->SignificanceChanges)
+	{
+		if (this->SelectableCellCoordinates.Contains(Selectable))
+		{
+			this->SetSignificanceTier(Selectable, Tier);
+		}
+	}
+}
+
+ERTSSignificanceTier URTSCameraSubsystem::ComputeSignificanceTier(const URTSSelectable* Selectable) const
+{
+	const auto Settings = GetDefault<URTSCameraSettings>();
+	const auto Location = Selectable->GetOwner()->GetRootComponent()->GetComponentLocation();
+
+	// Units leave a tier only once they are past its edge by the hysteresis
+	const auto OnScreenMargin = Selectable->SignificanceTier != ERTSSignificanceTier::OffScreen
+		? Settings->SignificanceHysteresis
+		: 0.f;
+	const auto CloseDistance = Selectable->SignificanceTier == ERTSSignificanceTier::OnScreenClose
+		? Settings->SignificanceCloseDistance + Settings->SignificanceHysteresis
+		: Settings->SignificanceCloseDistance;
+
+	auto Tier = ERTSSignificanceTier::OffScreen;
+	for (const auto Footprint : this->ViewFootprints)
+	{
+		const auto DistanceOutside = RTSCameraKinematics::DistanceOutsideFootprint(
+			Footprint->Ground,
+			{Location.X, Location.Y}
+		);
+		if (DistanceOutside > OnScreenMargin)
+		{
+			continue;
+		}
+
+		if (FVector::DistSquared(Footprint->EyeLocation, Location) < FMath::Square(CloseDistance))
+		{
+			return ERTSSignificanceTier::OnScreenClose;
+		}
+		Tier = ERTSSignificanceTier::OnScreenFar;
+	}
+
+	return Tier;
+}
+
+void URTSCameraSubsystem::SetSignificanceTier(URTSSelectable* Selectable, const ERTSSignificanceTier Tier)
+{
+	const auto OldTier = Selectable->SignificanceTier;
+	this->NumSelectablesInSignificanceTier[static_cast<int32>(OldTier)]--;
+	this->NumSelectablesInSignificanceTier[static_cast<int32>(Tier)]++;
+	Selectable->SignificanceTier = Tier;
+
+	Selectable->OnSignificanceTierChanged(Tier);
+	this->OnSignificanceTierChanged.Broadcast(Selectable, OldTier, Tier);
+}
+
+FIntPoint URTSCameraSubsystem::GetCellCoordinates(const FVector& Location)
+{
+	return FIntPoint(
+		FMath::FloorToInt32(Location.X / RTSCameraSubsystem::CellSize),
+		FMath::FloorToInt32(Location.Y / RTSCameraSubsystem::CellSize)
+	);
+}
+
+void URTSCameraSubsystem::UpdateCellBounds(FSelectableCell& Cell)
+{
+	if (Cell.IsBoundsDirty)
+	{
+		Cell.Bounds.Init();
+		for (const auto Selectable : Cell.Selectables)
+		{
+			Cell.Bounds += Selectable->GetSelectionBounds();
+		}
+		Cell.IsBoundsDirty = false;
+	}
+}
+
+void URTSCameraSubsystem::RegisterSelectable(URTSSelectable* Selectable)
+{
+	RTSCAMERA_LLM_SCOPE(SpatialIndex);
+
+	// The server names every unit, clients learn the ids through replication
+	if (this->GetWorld()->GetNetMode() != NM_Client)
+	{
+		if (Selectable->UnitId == 0)
+		{
+			Selectable->UnitId = ++this->LastUnitId;
+		}
+		this->SelectablesByUnitId.Add(Selectable->UnitId, Selectable);
+	}
+
+	const auto Owner = Selectable->GetOwner();
+	const auto RootComponent = Owner != nullptr ? Owner->GetRootComponent() : nullptr;
+	if (RootComponent == nullptr || this->SelectableCellCoordinates.Contains(Selectable))
+	{
+		return;
+	}
+
+	this->AddSelectableToCell(
+		Selectable,
+		GetCellCoordinates(RootComponent->GetComponentLocation()),
+		Selectable->GetSelectionBounds()
+	);
+	this->NumSelectablesInSignificanceTier[static_cast<int32>(Selectable->SignificanceTier)]++;
+
+	if (this->UnitClusterCellSize > 0)
+	{
+		this->AddSelectableToUnitCluster(Selectable, RootComponent->GetComponentLocation());
+	}
+}
+
+void URTSCameraSubsystem::UnregisterSelectable(URTSSelectable* Selectable)
+{
+	if (this->FindSelectableByUnitId(Selectable->UnitId) == Selectable)
+	{
+		this->SelectablesByUnitId.Remove(Selectable->UnitId);
+	}
+
+	if (const auto CellCoordinates = this->SelectableCellCoordinates.Find(Selectable))
+	{
+		this->RemoveSelectableFromCell(Selectable, *CellCoordinates);
+		this->SelectableCellCoordinates.Remove(Selectable);
+		this->NumSelectablesInSignificanceTier[static_cast<int32>(Selectable->SignificanceTier)]--;
+		this->RemoveSelectableFromUnitCluster(Selectable);
+	}
+}
+
+URTSSelectable* URTSCameraSubsystem::FindSelectableByUnitId(const int32 UnitId) const
+{
+	const auto Selectable = this->SelectablesByUnitId.Find(UnitId);
+	return Selectable != nullptr ? *Selectable : nullptr;
+}
+
+void URTSCameraSubsystem::UpdateSelectable(URTSSelectable* Selectable)
+{
+	RTSCAMERA_LLM_SCOPE(SpatialIndex);
+
+	const auto CellCoordinates = this->SelectableCellCoordinates.Find(Selectable);
+	const auto Owner = Selectable->GetOwner();
+	const auto RootComponent = Owner != nullptr ? Owner->GetRootComponent() : nullptr;
+	if (CellCoordinates == nullptr || RootComponent == nullptr)
+	{
+		return;
+	}
+
+	const auto Location = RootComponent->GetComponentLocation();
+	const auto NewCellCoordinates = GetCellCoordinates(Location);
+	if (NewCellCoordinates != *CellCoordinates)
+	{
+		this->RemoveSelectableFromCell(Selectable, *CellCoordinates);
+		this->AddSelectableToCell(Selectable, NewCellCoordinates, Selectable->GetSelectionBounds());
+	}
+	else
+	{
+		// The old bounds may have been the ones that defined the cell's extent
+		this->SelectableCells[NewCellCoordinates].IsBoundsDirty = true;
+	}
+
+	if (this->UnitClusterCellSize > 0)
+	{
+		this->UpdateSelectableUnitCluster(Selectable, Location);
+	}
+}
+
+void URTSCameraSubsystem::AddSelectableToCell(
+	URTSSelectable* Selectable,
+	const FIntPoint& CellCoordinates,
+	const FBox& Bounds
+)
+{
+	auto& Cell = this->SelectableCells.FindOrAdd(CellCoordinates);
+	Cell.Selectables.Add(Selectable);
+	Cell.Bounds += Bounds;
+	this->SelectableCellCoordinates.Add(Selectable, CellCoordinates);
+}
+
+void URTSCameraSubsystem::RemoveSelectableFromCell(URTSSelectable* Selectable, const FIntPoint& CellCoordinates)
+{
+	if (const auto Cell = this->SelectableCells.Find(CellCoordinates))
+	{
+		Cell->Selectables.RemoveSingleSwap(Selectable);
+		if (Cell->Selectables.Num() == 0)
+		{
+			this->SelectableCells.Remove(CellCoordinates);
+		}
+		else
+		{
+			Cell->IsBoundsDirty = true;
+		}
+	}
+}
+
+void URTSCameraSubsystem::GetSelectableActorsInRectangle(
+	const FRTSSelectionView& View,
+	const FBox2D& Rectangle,
+	TArray<AActor*>& OutActors
+)
+{
+	for (auto& [CellCoordinates, Cell] : this->SelectableCells)
+	{
+		UpdateCellBounds(Cell);
+
+		// Cells reaching behind the view cannot be projected reliably, their units are tested one by one
+		FBox2D CellScreenBounds;
+		if (View.ProjectBounds(Cell.Bounds, CellScreenBounds) && !Rectangle.Intersect(CellScreenBounds))
+		{
+			continue;
+		}
+
+		for (const auto Selectable : Cell.Selectables)
+		{
+			RTSCAMERA_COUNTER_ADD(UnitsTested, 1);
+
+			FBox2D ScreenBounds;
+			View.ProjectBounds(Selectable->GetSelectionBounds(), ScreenBounds);
+			if (Rectangle.Intersect(ScreenBounds))
+			{
+				OutActors.Add(Selectable->GetOwner());
+			}
+		}
+	}
+}
+
+void URTSCameraSubsystem::SetUnitClusterCellSize(const double CellSize)
+{
+	if (CellSize == this->UnitClusterCellSize)
+	{
+		return;
+	}
+
+	RTSCAMERA_LLM_SCOPE(SpatialIndex);
+
+	this->UnitClusterCellSize = CellSize;
+	this->UnitClusters.Reset();
+	this->UnitClusterMemberships.Reset();
+	if (CellSize <= 0)
+	{
+		return;
+	}
+
+	for (const auto& [Selectable, CellCoordinates] : this->SelectableCellCoordinates)
+	{
+		const auto RootComponent = Selectable->GetOwner()->GetRootComponent();
+		this->AddSelectableToUnitCluster(Selectable, RootComponent->GetComponentLocation());
+	}
+}
+
+double URTSCameraSubsystem::GetUnitClusterCellSize() const
+{
+	return this->UnitClusterCellSize;
+}
+
+URTSCameraSubsystem::FUnitClusterKey URTSCameraSubsystem::GetUnitClusterKey(
+	const URTSSelectable* Selectable,
+	const FVector& Location
+) const
+{
+	FUnitClusterKey Key;
+	Key.CellCoordinates = FIntPoint(
+		FMath::FloorToInt32(Location.X / this->UnitClusterCellSize),
+		FMath::FloorToInt32(Location.Y / this->UnitClusterCellSize)
+	);
+	Key.Type = Selectable->ClusterType;
+	return Key;
+}
+
+void URTSCameraSubsystem::AddSelectableToUnitCluster(URTSSelectable* Selectable, const FVector& Location)
+{
+	FUnitClusterMembership Membership;
+	Membership.Key = this->GetUnitClusterKey(Selectable, Location);
+	Membership.Location = Location;
+
+	auto& Cluster = this->UnitClusters.FindOrAdd(Membership.Key);
+	Cluster.Selectables.Add(Selectable);
+	Cluster.LocationSum += Location;
+	this->UnitClusterMemberships.Add(Selectable, Membership);
+}
+
+void URTSCameraSubsystem::RemoveSelectableFromUnitCluster(URTSSelectable* Selectable)
+{
+	FUnitClusterMembership Membership;
+	if (!this->UnitClusterMemberships.RemoveAndCopyValue(Selectable, Membership))
+	{
+		return;
+	}
+
+	if (const auto Cluster = this->UnitClusters.Find(Membership.Key))
+	{
+		Cluster->Selectables.RemoveSingleSwap(Selectable);
+		Cluster->LocationSum -= Membership.Location;
+		if (Cluster->Selectables.Num() == 0)
+		{
+			this->UnitClusters.Remove(Membership.Key);
+		}
+	}
+}
+
+void URTSCameraSubsystem::UpdateSelectableUnitCluster(URTSSelectable* Selectable, const FVector& Location)
+{
+	const auto Membership = this->UnitClusterMemberships.Find(Selectable);
+	if (Membership == nullptr)
+	{
+		return;
+	}
+
+	const auto Key = this->GetUnitClusterKey(Selectable, Location);
+	if (Key == Membership->Key)
+	{
+		this->UnitClusters[Key].LocationSum += Location - Membership->Location;
+		Membership->Location = Location;
+		return;
+	}
+
+	this->RemoveSelectableFromUnitCluster(Selectable);
+	this->AddSelectableToUnitCluster(Selectable, Location);
+}
+
+void URTSCameraSubsystem::GetUnitClustersInView(
+	const FRTSSelectionView& View,
+	const float Margin,
+	TArray<FRTSUnitCluster>& OutClusters
+) const
+{
+	const FBox2D ViewportBounds(FVector2D(-Margin), View.ViewportSize + FVector2D(Margin));
+	for (const auto& [Key, Cluster] : this->UnitClusters)
+	{
+		const auto Location = Cluster.LocationSum / Cluster.Selectables.Num();
+		FVector2D ScreenLocation;
+		if (!View.ProjectInFront(Location, ScreenLocation) || !ViewportBounds.IsInside(ScreenLocation))
+		{
+			continue;
+		}
+
+		auto& OutCluster = OutClusters.AddDefaulted_GetRef();
+		OutCluster.Type = Key.Type;
+		OutCluster.Location = Location;
+		OutCluster.ScreenLocation = ScreenLocation;
+		OutCluster.NumUnits = Cluster.Selectables.Num();
+	}
+}
+
+void URTSCameraSubsystem::GetSelectableActorsInUnitClusters(
+	const FRTSSelectionView& View,
+	const FBox2D& Rectangle,
+	const float IconSize,
+	TArray<AActor*>& OutActors
+) const
+{
+	const FVector2D IconExtent(IconSize * 0.5f);
+	for (const auto& [Key, Cluster] : this->UnitClusters)
+	{
+		// A whole cluster is tested like a single unit
+		RTSCAMERA_COUNTER_ADD(UnitsTested, 1);
+
+		FVector2D ScreenLocation;
+		if (
+			!View.ProjectInFront(Cluster.LocationSum / Cluster.Selectables.Num(), ScreenLocation)
+			|| !Rectangle.Intersect(FBox2D(ScreenLocation - IconExtent, ScreenLocation + IconExtent))
+		)
+		{
+			continue;
+		}
+
+		for (const auto Selectable : Cluster.Selectables)
+		{
+			OutActors.Add(Selectable->GetOwner());
+		}
+	}
+}
@@ -0,0 +1,243 @@
+// Copyright 2024 Jesus Bracho All Rights Reserved.
+
+#include "RTSCameraSystemLibrary.h"
+#include "RTSCamera.h"
+#include "RTSSelectable.h"
+#include "Engine/GameViewportClient.h"
+#include "Engine/LocalPlayer.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+#include "Kismet/GameplayStatics.h"
+#include "SceneView.h"
+
+namespace
+{
+	// The view projection of a player's viewport, the part of UGameplayStatics::ProjectWorldToScreen worth sharing
+	bool GetPlayerViewProjection(
+		const UObject* WorldContextObject,
+		const int32 PlayerIndex,
+		FMatrix& OutViewProjectionMatrix,
+		FIntRect& OutViewRect
+	)
+	{
+		const auto PlayerController = UGameplayStatics::GetPlayerController(WorldContextObject, PlayerIndex);
+		const auto LocalPlayer = PlayerController != nullptr ? PlayerController->GetLocalPlayer() : nullptr;
+		if (LocalPlayer == nullptr || LocalPlayer->ViewportClient == nullptr)
+		{
+			return false;
+		}
+
+		FSceneViewProjectionData ProjectionData;
+		if (!LocalPlayer->GetProjectionData(LocalPlayer->ViewportClient->Viewport, ProjectionData))
+		{
+			return false;
+		}
+
+		OutViewProjectionMatrix = ProjectionData.ComputeViewProjectionMatrix();
+		OutViewRect = ProjectionData.GetConstrainedViewRect();
+		return true;
+	}
+
+	bool ProjectActor(
+		const AActor* Actor,
+		const FMatrix& ViewProjectionMatrix,
+		const FIntRect& ViewRect,
+		FVector2D& OutScreenLocation
+	)
+	{
+		if (Actor == nullptr)
+		{
+			OutScreenLocation = FVector2D::ZeroVector;
+			return false;
+		}
+
+		if (!FSceneView::ProjectWorldToScreen(
+			Actor->GetActorLocation(),
+			ViewRect,
+			ViewProjectionMatrix,
+			OutScreenLocation
+		))
+		{
+			return false;
+		}
+
+		// Relative to the player's viewport, like UGameplayStatics::ProjectWorldToScreen
+		OutScreenLocation -= FVector2D(ViewRect.Min);
+		return true;
+	}
+}
+
+URTSCamera* URTSCameraSystemLibrary::GetRTSCamera(const UObject* WorldContextObject, const int32 PlayerIndex)
+{
+	const auto PlayerController = UGameplayStatics::GetPlayerController(WorldContextObject, PlayerIndex);
+	const auto Pawn = PlayerController != nullptr ? PlayerController->GetPawn() : nullptr;
+	return Pawn != nullptr ? Pawn->FindComponentByClass<URTSCamera>() : nullptr;
+}
+
+void URTSCameraSystemLibrary::FollowActor(
+	const UObject* WorldContextObject,
+	AActor* Target,
+	const int32 PlayerIndex
+)
+{
+	if (const auto Camera = GetRTSCamera(WorldContextObject, PlayerIndex))
+	{
+		Camera->FollowTarget(Target);
+	}
+}
+
+void URTSCameraSystemLibrary::FollowActors(
+	const UObject* WorldContextObject,
+	const TArray<AActor*>& Targets,
+	const int32 PlayerIndex
+)
+{
+	if (const auto Camera = GetRTSCamera(WorldContextObject, PlayerIndex))
+	{
+		Camera->FollowTargets(Targets);
+	}
+}
+
+void URTSCameraSystemLibrary::StopFollowing(const UObject* WorldContextObject, const int32 PlayerIndex)
+{
+	if (const auto Camera = GetRTSCamera(WorldContextObject, PlayerIndex))
+	{
+		Camera->UnFollowTarget();
+	}
+}
+
+void URTSCameraSystemLibrary::JumpToActor(
+	const UObject* WorldContextObject,
+	AActor* Target,
+	const int32 PlayerIndex
+)
+{
+	const auto Camera = GetRTSCamera(WorldContextObject, PlayerIndex);
+	if (Camera != nullptr && Target != nullptr)
+	{
+		Camera->JumpTo(Target->GetActorLocation());
+	}
+}
+
+void URTSCameraSystemLibrary::SelectActors(
+	const UObject* WorldContextObject,
+	const TArray<AActor*>& Actors,
+	const int32 PlayerIndex
+)
+{
+	if (const auto Camera = GetRTSCamera(WorldContextObject, PlayerIndex))
+	{
+		Camera->HandleSelectedActors(Actors);
+	}
+}
+
+bool URTSCameraSystemLibrary::IsActorSelected(
+	const UObject* WorldContextObject,
+	const AActor* Actor,
+	const int32 PlayerIndex
+)
+{
+	const auto Camera = GetRTSCamera(WorldContextObject, PlayerIndex);
+	const auto Selectable = GetSelectable(Actor);
+	return Camera != nullptr && Selectable != nullptr && Camera->SelectedActors.Contains(Selectable);
+}
+
+void URTSCameraSystemLibrary::AreActorsSelected(
+	const UObject* WorldContextObject,
+	const TArray<AActor*>& Actors,
+	TArray<bool>& OutIsSelected,
+	const int32 PlayerIndex
+)
+{
+	OutIsSelected.Init(false, Actors.Num());
+	const auto Camera = GetRTSCamera(WorldContextObject, PlayerIndex);
+	if (Camera == nullptr || Camera->SelectedActors.Num() == 0)
+	{
+		return;
+	}
+
+	TSet<const AActor*> SelectedOwners;
+	SelectedOwners.Reserve(Camera->SelectedActors.Num());
+	for (const auto Selected : Camera->SelectedActors)
+	{
+		if (Selected != nullptr)
+		{
+			SelectedOwners.Add(Selected->GetOwner());
+		}
+	}
+
+	for (auto Index = 0; Index < Actors.Num(); Index++)
+	{
+		OutIsSelected[Index] = Actors[Index] != nullptr && SelectedOwners.Contains(Actors[Index]);
+	}
+}
+
+URTSSelectable* URTSCameraSystemLibrary::GetSelectable(const AActor* Actor)
+{
+	return Actor != nullptr ? Actor->FindComponentByClass<URTSSelectable>() : nullptr;
+}
+
+void URTSCameraSystemLibrary::GetSelectables(const TArray<AActor*>& Actors, TArray<URTSSelectable*>& OutSelectables)
+{
+	OutSelectables.SetNumUninitialized(Actors.Num());
+	for (auto Index = 0; Index < Actors.Num(); Index++)
+	{
+		OutSelectables[Index] = GetSelectable(Actors[Index]);
+	}
+}
+
+ERTSSignificanceTier URTSCameraSystemLibrary::GetSignificanceTier(const AActor* Actor)
+{
+	const auto Selectable = GetSelectable(Actor);
+	return Selectable != nullptr ? Selectable->SignificanceTier : ERTSSignificanceTier::OffScreen;
+}
+
+void URTSCameraSystemLibrary::GetSignificanceTiers(
+	const TArray<AActor*>& Actors,
+	TArray<ERTSSignificanceTier>& OutTiers
+)
+{
+	OutTiers.SetNumUninitialized(Actors.Num());
+	for (auto Index = 0; Index < Actors.Num(); Index++)
+	{
+		OutTiers[Index] = GetSignificanceTier(Actors[Index]);
+	}
+}
+
+bool URTSCameraSystemLibrary::ProjectActorToScreen(
+	const UObject* WorldContextObject,
+	const AActor* Actor,
+	FVector2D& OutScreenLocation,
+	const int32 PlayerIndex
+)
+{
+	FMatrix ViewProjectionMatrix;
+	FIntRect ViewRect;
+	OutScreenLocation = FVector2D::ZeroVector;
+	return GetPlayerViewProjection(WorldContextObject, PlayerIndex, ViewProjectionMatrix, ViewRect)
+		&& ProjectActor(Actor, ViewProjectionMatrix, ViewRect, OutScreenLocation);
+}
+
+void URTSCameraSystemLibrary::ProjectActorsToScreen(
+	const UObject* WorldContextObject,
+	const TArray<AActor*>& Actors,
+	TArray<FVector2D>& OutScreenLocations,
+	TArray<bool>& OutIsInFront,
+	const int32 PlayerIndex
+)
+{
+	OutScreenLocations.Init(FVector2D::ZeroVector, Actors.Num());
+	OutIsInFront.Init(false, Actors.Num());
+
+	FMatrix ViewProjectionMatrix;
+	FIntRect ViewRect;
+	if (!GetPlayerViewProjection(WorldContextObject, PlayerIndex, ViewProjectionMatrix, ViewRect))
+	{
+		return;
+	}
+
+	for (auto Index = 0; Index < Actors.Num(); Index++)
+	{
+		OutIsInFront[Index] = ProjectActor(Actors[Index], ViewProjectionMatrix, ViewRect, OutScreenLocations[Index]);
+	}
+}
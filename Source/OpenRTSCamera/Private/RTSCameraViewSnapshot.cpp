@@ -0,0 +1,16 @@
+// Copyright 2024 Jesus Bracho All Rights Reserved.
+
+#include "RTSCameraViewSnapshot.h"
+
+bool FRTSCameraViewSnapshot::IntersectsSphere(const FVector& Center, const double Radius) const
+{
+	for (const auto& Plane : this->FrustumPlanes)
+	{
+		if (Plane.PlaneDot(Center) > Radius)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
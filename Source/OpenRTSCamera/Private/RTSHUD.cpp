@@ -1,7 +1,63 @@
 #include "RTSHUD.h"
 #include "RTSCamera.h"
+#include "RTSCameraProfiling.h"
+#include "RTSCameraSubsystem.h"
 //#include "RTSSelector.h"
 #include "Engine/Canvas.h"
+#include "Engine/Engine.h"
+#include "Engine/Texture2D.h"
+#include "Kismet/GameplayStatics.h"
+#include "SceneView.h"
+#include "UObject/UObjectIterator.h"
+
+FVector2D FRTSSelectionView::Project(const FVector& WorldLocation) const
+{
+	const auto Clip = this->ViewProjectionMatrix.TransformFVector4(FVector4(WorldLocation, 1.0));
+	const auto InverseW = Clip.W != 0 ? 1.0 / Clip.W : 1.0;
+	const auto HalfSize = this->ViewportSize * 0.5;
+	return FVector2D(
+		HalfSize.X + Clip.X * InverseW * HalfSize.X,
+		HalfSize.Y - Clip.Y * InverseW * HalfSize.Y
+	);
+}
+
+bool FRTSSelectionView::ProjectInFront(const FVector& WorldLocation, FVector2D& OutScreenLocation) const
+{
+	if (this->ViewProjectionMatrix.TransformFVector4(FVector4(WorldLocation, 1.0)).W <= 0)
+	{
+		return false;
+	}
+
+	OutScreenLocation = this->Project(WorldLocation);
+	return true;
+}
+
+bool FRTSSelectionView::ProjectBounds(const FBox& Bounds, FBox2D& OutScreenBounds) const
+{
+	auto IsInFront = true;
+	OutScreenBounds.Init();
+	for (auto Corner = 0; Corner < 8; Corner++)
+	{
+		const FVector CornerLocation(
+			Corner & 1 ? Bounds.Max.X : Bounds.Min.X,
+			Corner & 2 ? Bounds.Max.Y : Bounds.Min.Y,
+			Corner & 4 ? Bounds.Max.Z : Bounds.Min.Z
+		);
+		IsInFront &= this->ViewProjectionMatrix.TransformFVector4(FVector4(CornerLocation, 1.0)).W > 0;
+		OutScreenBounds += this->Project(CornerLocation);
+	}
+	return IsInFront;
+}
+
+FRTSSelectionView FRTSSelectionView::FromViewInfo(const FMinimalViewInfo& ViewInfo, const FVector2D& ViewportSize)
+{
+	FMatrix ViewMatrix;
+	FMatrix ProjectionMatrix;
+	FRTSSelectionView View;
+	UGameplayStatics::GetViewProjectionMatrix(ViewInfo, ViewMatrix, ProjectionMatrix, View.ViewProjectionMatrix);
+	View.ViewportSize = ViewportSize;
+	return View;
+}
 
 // Constructor implementation: Initializes default values.
 ARTSHUD::ARTSHUD()
@@ -10,6 +66,12 @@ ARTSHUD::ARTSHUD()
 	SelectionBoxThickness = 1.0f;
 	bIsDrawingSelectionBox = false;
 	bIsPerformingSelection = false;
+	EnableStrategicZoom = false;
+	StrategicZoomThreshold = 0.8f;
+	StrategicZoomCellSize = 64;
+	StrategicZoomIconSize = 32;
+	StrategicZoomCountColor = FLinearColor::White;
+	IsInStrategicZoom = false;
 }
 
 // Implementation of the DrawHUD function. It's called every frame to draw the HUD.
@@ -17,6 +79,22 @@ void ARTSHUD::DrawHUD()
 {
 	Super::DrawHUD(); // Call the base class implementation.
 
+	FRTSSelectionView View;
+	if (this->GetSelectionView(View))
+	{
+		this->UpdateStrategicZoom(View);
+		if (this->IsInStrategicZoom)
+		{
+			this->UnitClustersScratch.Reset();
+			this->GetWorld()->GetSubsystem<URTSCameraSubsystem>()->GetUnitClustersInView(
+				View,
+				this->StrategicZoomIconSize,
+				this->UnitClustersScratch
+			);
+			this->DrawUnitClusters(this->UnitClustersScratch);
+		}
+	}
+
 	// Draw the selection box if it's active.
 	if (bIsDrawingSelectionBox)
 	{
@@ -67,12 +145,177 @@ void ARTSHUD::DrawSelectionBox_Implementation(const FVector2D& StartPoint, const
 	}
 }
 
+void ARTSHUD::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	// Nobody else draws the clusters, stop keeping them up to date
+	if (this->IsInStrategicZoom)
+	{
+		if (const auto Subsystem = this->GetWorld()->GetSubsystem<URTSCameraSubsystem>())
+		{
+			Subsystem->SetUnitClusterCellSize(0);
+		}
+		this->IsInStrategicZoom = false;
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+bool ARTSHUD::IsStrategicZoomActive() const
+{
+	return this->IsInStrategicZoom;
+}
+
+void ARTSHUD::UpdateStrategicZoom(const FRTSSelectionView& View)
+{
+	const auto Subsystem = this->GetWorld()->GetSubsystem<URTSCameraSubsystem>();
+	const auto Pawn = this->GetOwningPawn();
+	const auto RTSCamera = Pawn != nullptr ? Pawn->FindComponentByClass<URTSCamera>() : nullptr;
+	const auto WasInStrategicZoom = this->IsInStrategicZoom;
+	this->IsInStrategicZoom = this->EnableStrategicZoom
+		&& Subsystem != nullptr
+		&& RTSCamera != nullptr
+		&& RTSCamera->GetZoomAlpha() >= this->StrategicZoomThreshold;
+
+	if (!this->IsInStrategicZoom)
+	{
+		if (WasInStrategicZoom && Subsystem != nullptr)
+		{
+			Subsystem->SetUnitClusterCellSize(0);
+		}
+		return;
+	}
+
+	// How many pixels a step on the ground covers around the point the camera looks at
+	const auto Pivot = Pawn->GetActorLocation();
+	const auto Step = Canvas->SceneView->GetViewRight() * 100;
+	const auto PixelsPerUnit = FVector2D::Distance(View.Project(Pivot), View.Project(Pivot + Step)) / 100;
+	if (PixelsPerUnit <= 0)
+	{
+		return;
+	}
+
+	// Snapped to powers of two so that zooming only regroups the units when it crosses one
+	Subsystem->SetUnitClusterCellSize(
+		FMath::Pow(2.0, FMath::RoundToDouble(FMath::Log2(this->StrategicZoomCellSize / PixelsPerUnit)))
+	);
+}
+
+// Default implementation of DrawUnitClusters. Draws each cluster's icon with the number of units below it.
+void ARTSHUD::DrawUnitClusters_Implementation(const TArray<FRTSUnitCluster>& Clusters)
+{
+	const auto Font = GEngine->GetSmallFont();
+	const auto IconSize = this->StrategicZoomIconSize;
+	for (const auto& Cluster : Clusters)
+	{
+		const auto Left = Cluster.ScreenLocation.X - IconSize * 0.5f;
+		const auto Top = Cluster.ScreenLocation.Y - IconSize * 0.5f;
+		const auto Style = this->StrategicZoomIconStyles.Find(Cluster.Type);
+		if (Style != nullptr && Style->Icon != nullptr)
+		{
+			DrawTexture(Style->Icon, Left, Top, IconSize, IconSize, 0, 0, 1, 1, Style->Color);
+		}
+		else
+		{
+			DrawRect(Style != nullptr ? Style->Color : FLinearColor::White, Left, Top, IconSize, IconSize);
+		}
+
+		DrawText(FString::FromInt(Cluster.NumUnits), this->StrategicZoomCountColor, Left, Top + IconSize, Font);
+	}
+}
+
+// Builds the selection view from the scene view the canvas is projecting with.
+bool ARTSHUD::GetSelectionView(FRTSSelectionView& OutView) const
+{
+	if (Canvas == nullptr || Canvas->SceneView == nullptr)
+	{
+		return false;
+	}
+
+	OutView.ViewProjectionMatrix = Canvas->SceneView->ViewMatrices.GetViewProjectionMatrix();
+	OutView.ViewportSize = FVector2D(Canvas->ClipX, Canvas->ClipY);
+	return true;
+}
+
+// Same test as AHUD::GetActorsInSelectionRectangle, but it only visits selectables and uses the cached bounds of their
+// root component instead of gathering the bounds of every component of every actor in the world.
+void ARTSHUD::GetSelectableActorsInRectangle(
+	const UWorld* World,
+	const FRTSSelectionView& View,
+	const FVector2D& FirstPoint,
+	const FVector2D& SecondPoint,
+	TArray<AActor*>& OutActors
+)
+{
+	RTSCAMERA_STAGE_SCOPE(SelectionQuery);
+	RTSCAMERA_LLM_SCOPE(Selection);
+
+	const FBox2D SelectionRectangle(
+		FVector2D(FMath::Min(FirstPoint.X, SecondPoint.X), FMath::Min(FirstPoint.Y, SecondPoint.Y)),
+		FVector2D(FMath::Max(FirstPoint.X, SecondPoint.X), FMath::Max(FirstPoint.Y, SecondPoint.Y))
+	);
+
+	// Worlds with a camera subsystem keep selectables in a spatial index, this is only the fallback for other worlds
+	if (const auto Subsystem = World != nullptr ? World->GetSubsystem<URTSCameraSubsystem>() : nullptr)
+	{
+		Subsystem->GetSelectableActorsInRectangle(View, SelectionRectangle, OutActors);
+		return;
+	}
+
+	for (TObjectIterator<URTSSelectable> It; It; ++It)
+	{
+		const auto Actor = It->GetOwner();
+		if (Actor == nullptr || It->GetWorld() != World || It->IsTemplate())
+		{
+			continue;
+		}
+
+		const auto RootComponent = Actor->GetRootComponent();
+		if (RootComponent == nullptr)
+		{
+			continue;
+		}
+
+		RTSCAMERA_COUNTER_ADD(UnitsTested, 1);
+
+		FBox2D ScreenBounds;
+		View.ProjectBounds(It->GetSelectionBounds(), ScreenBounds);
+		if (SelectionRectangle.Intersect(ScreenBounds))
+		{
+			OutActors.Add(Actor);
+		}
+	}
+}
+
 // Default implementation of PerformSelection. Selects actors within the selection box.
 void ARTSHUD::PerformSelection_Implementation()
 {
+	RTSCAMERA_LLM_SCOPE(Selection);
+
 	// Array to store actors that are within the selection rectangle.
-	TArray<AActor*> SelectedActors;
-	GetActorsInSelectionRectangle<AActor>(SelectionStart, SelectionEnd, SelectedActors, false, false);
+	auto& SelectedActors = this->SelectedActorsScratch;
+	SelectedActors.Reset();
+	FRTSSelectionView View;
+	if (GetSelectionView(View))
+	{
+		if (this->IsInStrategicZoom)
+		{
+			// Zoomed out, the box selects the clusters the player sees rather than the units beneath them
+			const FBox2D SelectionRectangle(
+				FVector2D(FMath::Min(SelectionStart.X, SelectionEnd.X), FMath::Min(SelectionStart.Y, SelectionEnd.Y)),
+				FVector2D(FMath::Max(SelectionStart.X, SelectionEnd.X), FMath::Max(SelectionStart.Y, SelectionEnd.Y))
+			);
+			GetWorld()->GetSubsystem<URTSCameraSubsystem>()->GetSelectableActorsInUnitClusters(
+				View,
+				SelectionRectangle,
+				this->StrategicZoomIconSize,
+				SelectedActors
+			);
+		}
+		else
+		{
+			GetSelectableActorsInRectangle(GetWorld(), View, SelectionStart, SelectionEnd, SelectedActors);
+		}
+	}
 
 
 
@@ -80,6 +323,11 @@ void ARTSHUD::PerformSelection_Implementation()
 	if (const auto PC = GetOwningPlayerController())
 	{
 		APawn* ControlledPawn = PC->GetPawn();
+		if (ControlledPawn == nullptr)
+		{
+			bIsPerformingSelection = false;
+			return;
+		}
 		//UE_LOG(LogTemp, Log, TEXT("%s"), ControlledPawn->FindComponentByClass<URTSCamera>());
 
 
@@ -1 +1,80 @@
 ﻿#include "RTSSelectable.h"
+#include "RTSCameraSubsystem.h"
+#include "Engine/World.h"
+#include "Net/UnrealNetwork.h"
+
+void URTSSelectable::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME_CONDITION(URTSSelectable, UnitId, COND_InitialOnly);
+}
+
+FBox URTSSelectable::GetSelectionBounds() const
+{
+	const auto RootComponent = this->GetOwner()->GetRootComponent();
+	return RootComponent != nullptr ? RootComponent->Bounds.GetBox() : FBox(ForceInit);
+}
+
+void URTSSelectable::AppendUnits(TArray<AActor*>& OutUnits) const
+{
+	OutUnits.Add(this->GetOwner());
+}
+
+void URTSSelectable::OnRegister()
+{
+	Super::OnRegister();
+
+	// Only replicates anything if the owner does, and then only the unit id
+	if (this->EnableUnitIdReplication)
+	{
+		this->SetIsReplicated(true);
+	}
+
+	const auto World = this->GetWorld();
+	const auto Subsystem = World != nullptr ? World->GetSubsystem<URTSCameraSubsystem>() : nullptr;
+	const auto RootComponent = this->GetOwner() != nullptr ? this->GetOwner()->GetRootComponent() : nullptr;
+	if (Subsystem != nullptr)
+	{
+		Subsystem->RegisterSelectable(this);
+	}
+
+	if (Subsystem != nullptr && RootComponent != nullptr)
+	{
+		this->TrackedRootComponent = RootComponent;
+		this->RootTransformUpdatedHandle = RootComponent->TransformUpdated.AddUObject(
+			this,
+			&URTSSelectable::OnRootTransformUpdated
+		);
+	}
+}
+
+void URTSSelectable::OnUnregister()
+{
+	if (const auto RootComponent = this->TrackedRootComponent.Get())
+	{
+		RootComponent->TransformUpdated.Remove(this->RootTransformUpdatedHandle);
+	}
+	this->TrackedRootComponent.Reset();
+	this->RootTransformUpdatedHandle.Reset();
+
+	const auto World = this->GetWorld();
+	if (const auto Subsystem = World != nullptr ? World->GetSubsystem<URTSCameraSubsystem>() : nullptr)
+	{
+		Subsystem->UnregisterSelectable(this);
+	}
+
+	Super::OnUnregister();
+}
+
+void URTSSelectable::OnRootTransformUpdated(
+	USceneComponent* UpdatedComponent,
+	EUpdateTransformFlags UpdateTransformFlags,
+	ETeleportType Teleport
+)
+{
+	if (const auto Subsystem = this->GetWorld()->GetSubsystem<URTSCameraSubsystem>())
+	{
+		Subsystem->UpdateSelectable(this);
+	}
+}
@@ -0,0 +1,278 @@
+// Copyright 2024 Jesus Bracho All Rights Reserved.
+
+#include "RTSSelectionReplication.h"
+
+namespace RTSSelectionReplication
+{
+	static void WriteVarUInt(uint32 Value, TArray<uint8>& OutBytes)
+	{
+		while (Value >= 0x80)
+		{
+			OutBytes.Add(static_cast<uint8>(Value) | 0x80);
+			Value >>= 7;
+		}
+		OutBytes.Add(static_cast<uint8>(Value));
+	}
+
+	static bool ReadVarUInt(const TArray<uint8>& Bytes, int32& InOutOffset, uint32& OutValue)
+	{
+		OutValue = 0;
+		for (auto Shift = 0; Shift < 32; Shift += 7)
+		{
+			if (InOutOffset >= Bytes.Num())
+			{
+				return false;
+			}
+
+			const auto Byte = Bytes[InOutOffset++];
+			OutValue |= static_cast<uint32>(Byte & 0x7F) << Shift;
+			if ((Byte & 0x80) == 0)
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+}
+
+void RTSSelectionReplication::EncodeUnitIdRuns(const TArray<int32>& SortedUnitIds, TArray<uint8>& OutBytes)
+{
+	// Counted first so that the reader knows where the runs end
+	auto NumRuns = 0;
+	for (auto Index = 0; Index < SortedUnitIds.Num(); Index++)
+	{
+		if (Index == 0 || SortedUnitIds[Index] != SortedUnitIds[Index - 1] + 1)
+		{
+			NumRuns++;
+		}
+	}
+	WriteVarUInt(static_cast<uint32>(NumRuns), OutBytes);
+
+	auto Cursor = 0;
+	auto Index = 0;
+	while (Index < SortedUnitIds.Num())
+	{
+		const auto Start = SortedUnitIds[Index];
+		auto Length = 1;
+		while (Index + Length < SortedUnitIds.Num() && SortedUnitIds[Index + Length] == Start + Length)
+		{
+			Length++;
+		}
+
+		WriteVarUInt(static_cast<uint32>(Start - Cursor), OutBytes);
+		WriteVarUInt(static_cast<uint32>(Length - 1), OutBytes);
+		Cursor = Start + Length;
+		Index += Length;
+	}
+}
+
+bool RTSSelectionReplication::DecodeUnitIdRuns(
+	const TArray<uint8>& Bytes,
+	int32& InOutOffset,
+	TArray<int32>& OutUnitIds
+)
+{
+	uint32 NumRuns;
+	if (!ReadVarUInt(Bytes, InOutOffset, NumRuns))
+	{
+		return false;
+	}
+
+	int64 Cursor = 0;
+	for (uint32 Run = 0; Run < NumRuns; Run++)
+	{
+		uint32 Gap;
+		uint32 LengthMinusOne;
+		if (!ReadVarUInt(Bytes, InOutOffset, Gap) || !ReadVarUInt(Bytes, InOutOffset, LengthMinusOne))
+		{
+			return false;
+		}
+
+		const auto Start = Cursor + Gap;
+		const auto Length = static_cast<int64>(LengthMinusOne) + 1;
+		if (Start + Length > MAX_int32 || OutUnitIds.Num() + Length > MaxUnitIdsPerDelta)
+		{
+			return false;
+		}
+
+		for (auto Offset = 0; Offset < Length; Offset++)
+		{
+			OutUnitIds.Add(static_cast<int32>(Start + Offset));
+		}
+		Cursor = Start + Length;
+	}
+
+	return true;
+}
+
+void RTSSelectionReplication::EncodeSelectionDelta(
+	const TArray<int32>& OldUnitIds,
+	const TArray<int32>& NewUnitIds,
+	TArray<uint8>& OutBytes
+)
+{
+	// Both are sorted, one merge walk splits them into removed and added ids
+	TArray<int32> Removed;
+	TArray<int32> Added;
+	auto OldIndex = 0;
+	auto NewIndex = 0;
+	while (OldIndex < OldUnitIds.Num() || NewIndex < NewUnitIds.Num())
+	{
+		if (
+			NewIndex >= NewUnitIds.Num()
+			|| (OldIndex < OldUnitIds.Num() && OldUnitIds[OldIndex] < NewUnitIds[NewIndex])
+		)
+		{
+			Removed.Add(OldUnitIds[OldIndex++]);
+		}
+		else if (OldIndex >= OldUnitIds.Num() || NewUnitIds[NewIndex] < OldUnitIds[OldIndex])
+		{
+			Added.Add(NewUnitIds[NewIndex++]);
+		}
+		else
+		{
+			OldIndex++;
+			NewIndex++;
+		}
+	}
+
+	EncodeUnitIdRuns(Removed, OutBytes);
+	EncodeUnitIdRuns(Added, OutBytes);
+}
+
+bool RTSSelectionReplication::ApplySelectionDelta(const TArray<uint8>& Bytes, TArray<int32>& InOutUnitIds)
+{
+	auto Offset = 0;
+	TArray<int32> Removed;
+	TArray<int32> Added;
+	if (
+		!DecodeUnitIdRuns(Bytes, Offset, Removed)
+		|| !DecodeUnitIdRuns(Bytes, Offset, Added)
+		|| Offset != Bytes.Num()
+	)
+	{
+		return false;
+	}
+
+	TArray<int32> UnitIds;
+	UnitIds.Reserve(InOutUnitIds.Num() + Added.Num());
+	auto RemovedIndex = 0;
+	auto AddedIndex = 0;
+	for (const auto UnitId : InOutUnitIds)
+	{
+		while (RemovedIndex < Removed.Num() && Removed[RemovedIndex] < UnitId)
+		{
+			RemovedIndex++;
+		}
+		while (AddedIndex < Added.Num() && Added[AddedIndex] < UnitId)
+		{
+			UnitIds.Add(Added[AddedIndex++]);
+		}
+
+		if (RemovedIndex < Removed.Num() && Removed[RemovedIndex] == UnitId)
+		{
+			continue;
+		}
+		UnitIds.Add(UnitId);
+
+		// An id that is already selected is not added twice
+		if (AddedIndex < Added.Num() && Added[AddedIndex] == UnitId)
+		{
+			AddedIndex++;
+		}
+	}
+	while (AddedIndex < Added.Num())
+	{
+		UnitIds.Add(Added[AddedIndex++]);
+	}
+
+	InOutUnitIds = MoveTemp(UnitIds);
+	return true;
+}
+
+void RTSSelectionReplication::FSelectionSender::Reset()
+{
+	this->SentUnitIds.Reset();
+	this->Sequence = 0;
+	this->IsKeyframePending = true;
+}
+
+bool RTSSelectionReplication::FSelectionSender::MakeUpdate(
+	TArray<int32>& InOutUnitIds,
+	int32& OutSequence,
+	bool& OutIsKeyframe,
+	TArray<uint8>& OutDelta
+)
+{
+	if (!this->IsKeyframePending && InOutUnitIds == this->SentUnitIds)
+	{
+		return false;
+	}
+
+	// A keyframe is a delta from the empty selection, SentUnitIds is empty after a reset
+	OutDelta.Reset();
+	EncodeSelectionDelta(this->SentUnitIds, InOutUnitIds, OutDelta);
+	Swap(this->SentUnitIds, InOutUnitIds);
+	OutIsKeyframe = this->IsKeyframePending;
+	this->IsKeyframePending = false;
+	OutSequence = ++this->Sequence;
+	return true;
+}
+
+RTSSelectionReplication::EReceiveResult RTSSelectionReplication::FSelectionReceiver::Receive(
+	const int32 Sequence,
+	const bool IsKeyframe,
+	const TArray<uint8>& Delta
+)
+{
+	if (!IsKeyframe && this->IsAwaitingKeyframe)
+	{
+		return EReceiveResult::Dropped;
+	}
+
+	const auto Previous = !IsKeyframe && this->Selections.Num() > 0 ? &this->Selections.Last() : nullptr;
+	if (!IsKeyframe && (Previous == nullptr || Sequence != Previous->Sequence + 1))
+	{
+		this->IsAwaitingKeyframe = true;
+		return EReceiveResult::ResyncNeeded;
+	}
+
+	FSelection Selection;
+	Selection.Sequence = Sequence;
+	if (Previous != nullptr)
+	{
+		Selection.UnitIds = Previous->UnitIds;
+	}
+
+	if (!ApplySelectionDelta(Delta, Selection.UnitIds))
+	{
+		this->IsAwaitingKeyframe = true;
+		return EReceiveResult::ResyncNeeded;
+	}
+
+	// Selections from before a keyframe belong to a sequence the client has abandoned
+	if (IsKeyframe)
+	{
+		this->Selections.Reset();
+		this->IsAwaitingKeyframe = false;
+	}
+	else if (this->Selections.Num() >= MaxRememberedSelections)
+	{
+		this->Selections.RemoveAt(0);
+	}
+	this->Selections.Add(MoveTemp(Selection));
+	return EReceiveResult::Applied;
+}
+
+const TArray<int32>* RTSSelectionReplication::FSelectionReceiver::Find(const int32 Sequence) const
+{
+	const auto Selection = this->Selections.FindByPredicate(
+		[Sequence](const FSelection& Candidate)
+		{
+			return Candidate.Sequence == Sequence;
+		}
+	);
+
+	return Selection != nullptr ? &Selection->UnitIds : nullptr;
+}
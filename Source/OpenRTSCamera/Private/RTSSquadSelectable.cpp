@@ -0,0 +1,157 @@
+// Copyright 2024 Jesus Bracho All Rights Reserved.
+
+#include "RTSSquadSelectable.h"
+#include "RTSCameraProfiling.h"
+#include "RTSCameraSubsystem.h"
+#include "Engine/World.h"
+
+void URTSSquadSelectable::AddMember(AActor* Member)
+{
+	if (Member == nullptr || Member == this->GetOwner())
+	{
+		return;
+	}
+
+	for (const auto& Existing : this->Members)
+	{
+		if (Existing.Actor == Member)
+		{
+			return;
+		}
+	}
+
+	RTSCAMERA_LLM_SCOPE(Selection);
+
+	auto& NewMember = this->Members.AddDefaulted_GetRef();
+	NewMember.Actor = Member;
+	if (this->IsRegistered())
+	{
+		this->BindMember(NewMember);
+		this->OnMemberTransformUpdated(nullptr, EUpdateTransformFlags::None, ETeleportType::None);
+	}
+}
+
+void URTSSquadSelectable::RemoveMember(AActor* Member)
+{
+	const auto Index = this->Members.IndexOfByPredicate(
+		[Member](const FMember& Existing)
+		{
+			return Existing.Actor == Member;
+		}
+	);
+	if (Index == INDEX_NONE)
+	{
+		return;
+	}
+
+	UnbindMember(this->Members[Index]);
+	this->Members.RemoveAtSwap(Index);
+	if (this->IsRegistered())
+	{
+		this->OnMemberTransformUpdated(nullptr, EUpdateTransformFlags::None, ETeleportType::None);
+	}
+}
+
+void URTSSquadSelectable::GetMembers(TArray<AActor*>& OutMembers) const
+{
+	OutMembers.Reset();
+	this->AppendUnits(OutMembers);
+}
+
+int32 URTSSquadSelectable::GetNumMembers() const
+{
+	return this->Members.Num();
+}
+
+FBox URTSSquadSelectable::GetSelectionBounds() const
+{
+	if (this->IsMemberBoundsDirty)
+	{
+		this->MemberBounds.Init();
+		for (const auto& Member : this->Members)
+		{
+			if (const auto RootComponent = Member.RootComponent.Get())
+			{
+				this->MemberBounds += RootComponent->Bounds.GetBox();
+			}
+		}
+		this->IsMemberBoundsDirty = false;
+	}
+
+	// A squad without members is selected like any other actor
+	return this->MemberBounds.IsValid ? this->MemberBounds : Super::GetSelectionBounds();
+}
+
+void URTSSquadSelectable::AppendUnits(TArray<AActor*>& OutUnits) const
+{
+	for (const auto& Member : this->Members)
+	{
+		if (const auto Actor = Member.Actor.Get())
+		{
+			OutUnits.Add(Actor);
+		}
+	}
+}
+
+void URTSSquadSelectable::OnRegister()
+{
+	for (auto& Member : this->Members)
+	{
+		this->BindMember(Member);
+	}
+	this->IsMemberBoundsDirty = true;
+
+	// Registers with the subsystem, which already needs the members' bounds
+	Super::OnRegister();
+}
+
+void URTSSquadSelectable::OnUnregister()
+{
+	for (auto& Member : this->Members)
+	{
+		UnbindMember(Member);
+	}
+
+	Super::OnUnregister();
+}
+
+void URTSSquadSelectable::BindMember(FMember& Member)
+{
+	const auto Actor = Member.Actor.Get();
+	const auto RootComponent = Actor != nullptr ? Actor->GetRootComponent() : nullptr;
+	if (RootComponent == nullptr || Member.TransformUpdatedHandle.IsValid())
+	{
+		return;
+	}
+
+	Member.RootComponent = RootComponent;
+	Member.TransformUpdatedHandle = RootComponent->TransformUpdated.AddUObject(
+		this,
+		&URTSSquadSelectable::OnMemberTransformUpdated
+	);
+}
+
+void URTSSquadSelectable::UnbindMember(FMember& Member)
+{
+	if (const auto RootComponent = Member.RootComponent.Get())
+	{
+		RootComponent->TransformUpdated.Remove(Member.TransformUpdatedHandle);
+	}
+	Member.RootComponent.Reset();
+	Member.TransformUpdatedHandle.Reset();
+}
+
+void URTSSquadSelectable::OnMemberTransformUpdated(
+	USceneComponent* UpdatedComponent,
+	EUpdateTransformFlags UpdateTransformFlags,
+	ETeleportType Teleport
+)
+{
+	this->IsMemberBoundsDirty = true;
+
+	// Lets the subsystem know the squad's cell has to be measured again
+	if (const auto Subsystem = this->GetWorld()->GetSubsystem<URTSCameraSubsystem>())
+	{
+		Subsystem->UpdateSelectable(this);
+	}
+}
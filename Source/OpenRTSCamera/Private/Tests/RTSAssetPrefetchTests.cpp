@@ -0,0 +1,63 @@
+// Copyright 2024 Jesus Bracho All Rights Reserved.
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "RTSAssetPrefetchSubsystem.h"
+#include "RTSCameraSettings.h"
+#include "RTSCameraTestWorld.h"
+#include "Engine/TargetPoint.h"
+
+/**
+ * Prefetches three unit types into a cache with room for two and checks that the least recently used one goes.
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(
+	FRTSAssetPrefetchTest,
+	"OpenRTSCamera.AssetPrefetch.EvictsLeastRecentlyUsedType",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter
+)
+
+bool FRTSAssetPrefetchTest::RunTest(const FString& Parameters)
+{
+	using namespace RTSCameraTests;
+
+	FRTSCameraTestWorld TestWorld(0);
+	const auto Settings = GetMutableDefault<URTSCameraSettings>();
+	const auto SavedMaxTypes = Settings->AssetPrefetchMaxTypes;
+	Settings->AssetPrefetchMaxTypes = 2;
+
+	// Always loaded, so that requesting it completes right away
+	const FSoftObjectPath TexturePath(TEXT("/Engine/EngineResources/DefaultTexture.DefaultTexture"));
+	const TSoftObjectPtr<UObject> Texture(TexturePath);
+	const auto SpawnUnit = [&TestWorld, &Texture](UClass* Class)
+	{
+		const auto Unit = TestWorld.World->SpawnActor<AActor>(Class);
+		const auto Selectable = NewObject<URTSSelectable>(Unit);
+		Selectable->PrefetchAssets.Add(Texture);
+		Selectable->RegisterComponent();
+		return Selectable;
+	};
+	const auto First = SpawnUnit(AActor::StaticClass());
+	const auto Second = SpawnUnit(ATargetPoint::StaticClass());
+	const auto Third = SpawnUnit(APawn::StaticClass());
+
+	const auto AssetPrefetch = NewObject<URTSAssetPrefetchSubsystem>();
+	AssetPrefetch->Prefetch(First);
+	AssetPrefetch->Prefetch(Second);
+	TestTrue(TEXT("Loaded assets are prefetched right away"), AssetPrefetch->IsPrefetched(First->GetOwner()));
+	TestTrue(TEXT("Their size is estimated"), AssetPrefetch->GetResidentBytes() > 0);
+
+	// The first type is used again, so the second is the least recently used when the third arrives
+	AssetPrefetch->Prefetch(First);
+	AssetPrefetch->Prefetch(Third);
+	TestEqual(TEXT("The cache keeps to its number of types"), AssetPrefetch->GetNumResidentTypes(), 2);
+	TestTrue(TEXT("The recently used type stays"), AssetPrefetch->IsPrefetched(First->GetOwner()));
+	TestFalse(TEXT("The least recently used type is released"), AssetPrefetch->IsPrefetched(Second->GetOwner()));
+	TestTrue(TEXT("The new type is prefetched"), AssetPrefetch->IsPrefetched(Third->GetOwner()));
+
+	Settings->AssetPrefetchMaxTypes = SavedMaxTypes;
+	return true;
+}
+
+#endif
@@ -0,0 +1,209 @@
+// Copyright 2024 Jesus Bracho All Rights Reserved.
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "RTSCameraTestWorld.h"
+#include "HAL/MemoryBase.h"
+#include <atomic>
+
+namespace RTSCameraAllocationTests
+{
+	using namespace RTSCameraTests;
+
+	static constexpr int32 NumSelectables = 1000;
+	static constexpr int32 WarmupFrames = 8;
+	static constexpr int32 MeasuredFrames = 120;
+
+	/**
+	 * Counts the allocations the game thread makes while installed in front of the engine's allocator.
+	 * Everything is forwarded, memory allocated before or after counting is freed through either one.
+	 */
+	class FAllocationCounter final : public FMalloc
+	{
+	public:
+		explicit FAllocationCounter(FMalloc* InInner)
+			: Inner(InInner)
+		{
+		}
+
+		virtual void* Malloc(const SIZE_T Count, const uint32 Alignment) override
+		{
+			this->Count();
+			return this->Inner->Malloc(Count, Alignment);
+		}
+
+		virtual void* TryMalloc(const SIZE_T Count, const uint32 Alignment) override
+		{
+			this->Count();
+			return this->Inner->TryMalloc(Count, Alignment);
+		}
+
+		virtual void* Realloc(void* Original, const SIZE_T Count, const uint32 Alignment) override
+		{
+			// Shrinking to nothing frees
+			if (Count > 0)
+			{
+				this->Count();
+			}
+			return this->Inner->Realloc(Original, Count, Alignment);
+		}
+
+		virtual void* TryRealloc(void* Original, const SIZE_T Count, const uint32 Alignment) override
+		{
+			if (Count > 0)
+			{
+				this->Count();
+			}
+			return this->Inner->TryRealloc(Original, Count, Alignment);
+		}
+
+		virtual void Free(void* Original) override
+		{
+			this->Inner->Free(Original);
+		}
+
+		virtual SIZE_T QuantizeSize(const SIZE_T Count, const uint32 Alignment) override
+		{
+			return this->Inner->QuantizeSize(Count, Alignment);
+		}
+
+		virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override
+		{
+			return this->Inner->GetAllocationSize(Original, SizeOut);
+		}
+
+		virtual void Trim(const bool bTrimThreadCaches) override
+		{
+			this->Inner->Trim(bTrimThreadCaches);
+		}
+
+		virtual bool IsInternallyThreadSafe() const override
+		{
+			return this->Inner->IsInternallyThreadSafe();
+		}
+
+		virtual const TCHAR* GetDescriptiveName() override
+		{
+			return TEXT("RTSCameraAllocationCounter");
+		}
+
+		void Begin()
+		{
+			this->NumAllocations = 0;
+			this->IsCounting = true;
+		}
+
+		int32 End()
+		{
+			this->IsCounting = false;
+			return this->NumAllocations;
+		}
+
+	private:
+		void Count()
+		{
+			if (this->IsCounting && IsInGameThread())
+			{
+				++this->NumAllocations;
+			}
+		}
+
+		FMalloc* Inner;
+		std::atomic<bool> IsCounting{false};
+		std::atomic<int32> NumAllocations{0};
+	};
+
+	/**
+	 * Puts an allocation counter in front of GMalloc for its lifetime.
+	 * The counter itself is never destroyed, other threads may still be inside it when it is taken out again.
+	 */
+	class FScopedAllocationCounter
+	{
+	public:
+		FScopedAllocationCounter()
+			: Inner(GMalloc)
+		{
+			static FAllocationCounter* Counter = new FAllocationCounter(GMalloc);
+			this->Counter = Counter;
+			GMalloc = this->Counter;
+		}
+
+		~FScopedAllocationCounter()
+		{
+			GMalloc = this->Inner;
+		}
+
+		FAllocationCounter* Counter;
+
+	private:
+		FMalloc* Inner;
+	};
+}
+
+/**
+ * Runs camera ticks with pan input and the same box selection over and over, and fails if any steady state frame
+ * allocates on the game thread: everything the camera and the selection need per frame is reused memory.
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(
+	FRTSCameraAllocationTest,
+	"OpenRTSCamera.Memory.SteadyStateFramesDoNotAllocate",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter
+)
+
+bool FRTSCameraAllocationTest::RunTest(const FString& Parameters)
+{
+	using namespace RTSCameraAllocationTests;
+
+	FRTSCameraTestWorld TestWorld(NumSelectables);
+	if (!TestNotNull(TEXT("Camera"), TestWorld.Camera))
+	{
+		return false;
+	}
+
+	const auto Camera = TestWorld.Camera;
+	const auto View = TestWorld.GetSelectionView();
+	TArray<AActor*> SelectedActors;
+
+	const auto RunFrame = [&]()
+	{
+		SelectedActors.Reset();
+		ARTSHUD::GetSelectableActorsInRectangle(
+			TestWorld.World,
+			View,
+			ViewportSize * 0.25,
+			ViewportSize * 0.75,
+			SelectedActors
+		);
+		// Called directly, the blueprint event thunk copies its array parameter
+		Camera->HandleSelectedActors_Implementation(SelectedActors);
+
+		Camera->InjectInput(ERTSCameraInputEvent::MoveCameraXAxis, FInputActionValue(0.5f));
+		Camera->TickComponent(1.0f / 60.0f, LEVELTICK_All, &Camera->PrimaryComponentTick);
+	};
+
+	// The first frames grow the reused buffers to their working size
+	for (auto Frame = 0; Frame < WarmupFrames; Frame++)
+	{
+		RunFrame();
+	}
+
+	int32 NumAllocations;
+	{
+		const FScopedAllocationCounter ScopedCounter;
+		ScopedCounter.Counter->Begin();
+		for (auto Frame = 0; Frame < MeasuredFrames; Frame++)
+		{
+			RunFrame();
+		}
+		NumAllocations = ScopedCounter.Counter->End();
+	}
+
+	AddInfo(FString::Printf(TEXT("%d allocations over %d frames"), NumAllocations, MeasuredFrames));
+	TestTrue(TEXT("The selection found units"), Camera->SelectedActors.Num() > 0);
+	TestEqual(TEXT("Steady state frames allocate nothing on the game thread"), NumAllocations, 0);
+	return true;
+}
+
+#endif
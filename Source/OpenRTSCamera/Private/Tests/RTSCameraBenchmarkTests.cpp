@@ -0,0 +1,185 @@
+// Copyright 2024 Jesus Bracho All Rights Reserved.
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "RTSCameraProfiling.h"
+#include "RTSCameraTestWorld.h"
+#include "Misc/CommandLine.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+
+namespace RTSCameraBenchmarkTests
+{
+	using namespace RTSCameraTests;
+
+	static constexpr int32 DefaultIterations = 200;
+
+	/**
+	 * Collects stage timings per iteration so percentiles can be reported per stage.
+	 */
+	class FStageCollector final : public IRTSCameraStageSink
+	{
+	public:
+		FStageCollector()
+		{
+			RTSCameraProfiling::SetStageSink(this);
+		}
+
+		virtual ~FStageCollector() override
+		{
+			RTSCameraProfiling::SetStageSink(nullptr);
+		}
+
+		virtual void AddStageSample(const ERTSCameraStage Stage, const uint64 Cycles) override
+		{
+			this->IterationCycles[static_cast<int32>(Stage)] += Cycles;
+		}
+
+		void BeginIteration()
+		{
+			FMemory::Memzero(this->IterationCycles);
+		}
+
+		void EndIteration(const ERTSCameraStage First, const ERTSCameraStage Last)
+		{
+			for (auto Stage = static_cast<int32>(First); Stage <= static_cast<int32>(Last); Stage++)
+			{
+				this->Samples[Stage].Add(FPlatformTime::ToMilliseconds64(this->IterationCycles[Stage]) * 1000.0);
+			}
+		}
+
+		TArray<double>& GetSamples(const ERTSCameraStage Stage)
+		{
+			return this->Samples[static_cast<int32>(Stage)];
+		}
+
+	private:
+		uint64 IterationCycles[static_cast<int32>(ERTSCameraStage::Num)];
+		TArray<double> Samples[static_cast<int32>(ERTSCameraStage::Num)];
+	};
+
+	static void ReportStage(
+		FAutomationTestBase& Test,
+		FStageCollector& Collector,
+		const ERTSCameraStage Stage,
+		const int32 NumSelectables,
+		FString& Csv
+	)
+	{
+		auto& Samples = Collector.GetSamples(Stage);
+		const auto P50 = RTSCameraProfiling::Percentile(Samples, 50);
+		const auto P95 = RTSCameraProfiling::Percentile(Samples, 95);
+		const auto P99 = RTSCameraProfiling::Percentile(Samples, 99);
+
+		Test.AddInfo(
+			FString::Printf(
+				TEXT("%s with %d selectables: p50 %.2fus, p95 %.2fus, p99 %.2fus"),
+				RTSCameraProfiling::GetStageName(Stage),
+				NumSelectables,
+				P50,
+				P95,
+				P99
+			)
+		);
+
+		Csv += FString::Printf(
+			TEXT("%s,%d,%.3f,%.3f,%.3f\n"),
+			RTSCameraProfiling::GetStageName(Stage),
+			NumSelectables,
+			P50,
+			P95,
+			P99
+		);
+	}
+}
+
+/**
+ * Spawns a grid of selectables and drives box selections and camera ticks programmatically, reporting timing
+ * percentiles for every stage. Run headless with for example:
+ *	UnrealEditor-Cmd <Project> -nullrhi -unattended -ExecCmds="Automation RunTests OpenRTSCamera.Benchmarks; Quit"
+ * `-RTSCameraBenchmarkIterations=` changes the number of samples, results are also written to
+ * Saved/Automation/OpenRTSCamera/Benchmarks.
+ */
+IMPLEMENT_COMPLEX_AUTOMATION_TEST(
+	FRTSCameraBenchmarkTest,
+	"OpenRTSCamera.Benchmarks.SelectionAndTick",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter
+)
+
+void FRTSCameraBenchmarkTest::GetTests(TArray<FString>& OutBeautifiedNames, TArray<FString>& OutTestCommands) const
+{
+	for (const auto NumSelectables : {1000, 10000, 50000})
+	{
+		OutBeautifiedNames.Add(FString::Printf(TEXT("%dk"), NumSelectables / 1000));
+		OutTestCommands.Add(FString::FromInt(NumSelectables));
+	}
+}
+
+bool FRTSCameraBenchmarkTest::RunTest(const FString& Parameters)
+{
+	using namespace RTSCameraBenchmarkTests;
+
+	const auto NumSelectables = FCString::Atoi(*Parameters);
+	auto Iterations = DefaultIterations;
+	FParse::Value(FCommandLine::Get(), TEXT("RTSCameraBenchmarkIterations="), Iterations);
+
+	FRTSCameraTestWorld BenchmarkWorld(NumSelectables);
+	if (!TestNotNull(TEXT("Camera"), BenchmarkWorld.Camera))
+	{
+		return false;
+	}
+
+	const auto Camera = BenchmarkWorld.Camera;
+	const auto View = BenchmarkWorld.GetSelectionView();
+	const FInputActionValue Pressed(true);
+	TArray<AActor*> SelectedActors;
+
+	FStageCollector Collector;
+	for (auto Iteration = 0; Iteration < Iterations; Iteration++)
+	{
+		Collector.BeginIteration();
+
+		// Alternate between two overlapping boxes so every selection both adds and removes units
+		const auto Inset = Iteration % 2 == 0 ? 0.25 : 0.35;
+		Camera->OnSelectionStart(Pressed);
+		Camera->OnUpdateSelection(Pressed);
+		Camera->OnSelectionEnd(Pressed);
+
+		SelectedActors.Reset();
+		ARTSHUD::GetSelectableActorsInRectangle(
+			BenchmarkWorld.World,
+			View,
+			ViewportSize * Inset,
+			ViewportSize * (1 - Inset),
+			SelectedActors
+		);
+		Camera->HandleSelectedActors(SelectedActors);
+
+		Camera->TickComponent(1.0f / 60.0f, LEVELTICK_All, &Camera->PrimaryComponentTick);
+
+		Collector.EndIteration(ERTSCameraStage::MoveCommands, ERTSCameraStage::SelectionDispatch);
+	}
+
+	FString Csv = TEXT("Stage,Selectables,P50us,P95us,P99us\n");
+	for (auto Stage = 0; Stage < static_cast<int32>(ERTSCameraStage::Num); Stage++)
+	{
+		ReportStage(*this, Collector, static_cast<ERTSCameraStage>(Stage), NumSelectables, Csv);
+	}
+
+	const auto OutputPath = FPaths::Combine(
+		FPaths::ProjectSavedDir(),
+		TEXT("Automation"),
+		TEXT("OpenRTSCamera"),
+		TEXT("Benchmarks"),
+		FString::Printf(TEXT("SelectionAndTick_%d.csv"), NumSelectables)
+	);
+	FFileHelper::SaveStringToFile(Csv, *OutputPath);
+
+	TestTrue(TEXT("Selection found units"), Camera->SelectedActors.Num() > 0);
+	return true;
+}
+
+#endif
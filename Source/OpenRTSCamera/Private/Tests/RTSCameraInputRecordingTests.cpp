@@ -0,0 +1,156 @@
+// Copyright 2024 Jesus Bracho All Rights Reserved.
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "RTSCameraTestWorld.h"
+
+/**
+ * Records a scripted session of pans, zooms, edge scrolls and drags, replays it without any input and checks that
+ * the camera goes through the same states frame by frame and that the recording stays small.
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(
+	FRTSCameraInputRecordingTest,
+	"OpenRTSCamera.InputRecording.ReplaysIdentically",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter
+)
+
+bool FRTSCameraInputRecordingTest::RunTest(const FString& Parameters)
+{
+	using namespace RTSCameraTests;
+
+	FRTSCameraTestWorld TestWorld(0);
+	if (!TestNotNull(TEXT("Camera"), TestWorld.Camera))
+	{
+		return false;
+	}
+
+	const auto Camera = TestWorld.Camera;
+	const auto CameraComponent = TestWorld.CameraComponent;
+
+	struct FFrameState
+	{
+		FVector RootLocation;
+		FVector CameraLocation;
+		FRotator CameraRotation;
+	};
+
+	const auto CaptureFrameState = [Camera, CameraComponent]()
+	{
+		FFrameState State;
+		State.RootLocation = Camera->GetOwner()->GetActorLocation();
+		State.CameraLocation = CameraComponent->GetComponentLocation();
+		State.CameraRotation = CameraComponent->GetComponentRotation();
+		return State;
+	};
+
+	FRTSCameraCursorSnapshot Cursor;
+	Cursor.ViewportSize = ViewportSize;
+	Cursor.ViewportMousePosition = ViewportSize * 0.5;
+	Cursor.PlayerMousePosition = ViewportSize * 0.5;
+	Camera->SetCursorOverride(Cursor);
+
+	constexpr auto NumFrames = 600;
+	TArray<FFrameState> RecordedStates;
+	Camera->StartInputRecording();
+	for (auto Frame = 0; Frame < NumFrames; Frame++)
+	{
+		if (Frame < 120)
+		{
+			Camera->InjectInput(ERTSCameraInputEvent::MoveCameraXAxis, FInputActionValue(1.0f));
+			if (Frame % 2 == 0)
+			{
+				Camera->InjectInput(ERTSCameraInputEvent::MoveCameraYAxis, FInputActionValue(-0.5f));
+			}
+		}
+		else if (Frame < 240)
+		{
+			if (Frame % 10 == 0)
+			{
+				Camera->InjectInput(ERTSCameraInputEvent::ZoomCamera, FInputActionValue(Frame < 180 ? 1.0f : -1.0f));
+			}
+		}
+		else if (Frame < 360)
+		{
+			// Towards the right edge and into the edge scroll band
+			if (Frame % 4 == 0)
+			{
+				Cursor.ViewportMousePosition.X = FMath::Min(Cursor.ViewportMousePosition.X + 40, ViewportSize.X);
+				Cursor.PlayerMousePosition = Cursor.ViewportMousePosition;
+				Camera->SetCursorOverride(Cursor);
+			}
+		}
+		else if (Frame < 480)
+		{
+			if (Frame == 360)
+			{
+				Cursor.ViewportMousePosition = ViewportSize * 0.5;
+				Cursor.PlayerMousePosition = Cursor.ViewportMousePosition;
+				Camera->SetCursorOverride(Cursor);
+			}
+			else if (Frame % 4 == 0)
+			{
+				Cursor.ViewportMousePosition += FVector2D(-8, 5);
+				Cursor.PlayerMousePosition = Cursor.ViewportMousePosition;
+				Camera->SetCursorOverride(Cursor);
+			}
+			Camera->InjectInput(ERTSCameraInputEvent::DragCamera, FInputActionValue(Frame < 479));
+		}
+
+		// Uneven frame times, the replay has to simulate with the recorded ones
+		Camera->TickComponent(1.0f / 60.0f + (Frame % 3) * 0.001f, LEVELTICK_All, &Camera->PrimaryComponentTick);
+		RecordedStates.Add(CaptureFrameState());
+	}
+
+	const auto Recording = Camera->StopInputRecording();
+	TestFalse(TEXT("Recording stopped"), Camera->IsRecordingInput());
+	TestTrue(
+		TEXT("The session moved the camera"),
+		!RecordedStates[0].RootLocation.Equals(RecordedStates.Last().RootLocation)
+	);
+
+	// Ten minutes at 60 frames per second should take a few hundred KB
+	const auto BytesPerTenMinutes = static_cast<double>(Recording.Num()) / NumFrames * 60 * 60 * 10;
+	TestTrue(
+		*FString::Printf(TEXT("Ten minutes take %.0f KB"), BytesPerTenMinutes / 1024),
+		BytesPerTenMinutes < 512 * 1024
+	);
+
+	if (!TestTrue(TEXT("The recording replays"), Camera->StartInputReplay(Recording)))
+	{
+		return false;
+	}
+
+	for (auto Frame = 0; Frame < NumFrames; Frame++)
+	{
+		// Neither the live frame time nor live input may leak into the replay
+		Camera->InjectInput(ERTSCameraInputEvent::MoveCameraYAxis, FInputActionValue(1.0f));
+		Camera->TickComponent(1.0f / 30.0f, LEVELTICK_All, &Camera->PrimaryComponentTick);
+
+		const auto State = CaptureFrameState();
+		const auto& Recorded = RecordedStates[Frame];
+		if (
+			!State.RootLocation.Equals(Recorded.RootLocation, KINDA_SMALL_NUMBER)
+			|| !State.CameraLocation.Equals(Recorded.CameraLocation, KINDA_SMALL_NUMBER)
+			|| !State.CameraRotation.Equals(Recorded.CameraRotation, KINDA_SMALL_NUMBER)
+		)
+		{
+			AddError(
+				FString::Printf(
+					TEXT("Frame %d replayed at %s instead of %s"),
+					Frame,
+					*State.CameraLocation.ToString(),
+					*Recorded.CameraLocation.ToString()
+				)
+			);
+			return false;
+		}
+	}
+
+	Camera->TickComponent(1.0f / 60.0f, LEVELTICK_All, &Camera->PrimaryComponentTick);
+	TestFalse(TEXT("The replay ends with the recording"), Camera->IsReplayingInput());
+	return true;
+}
+
+#endif
@@ -0,0 +1,82 @@
+// Copyright 2024 Jesus Bracho All Rights Reserved.
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "RTSCameraTestWorld.h"
+
+/**
+ * Runs a move and a zoom queued as a sequence from the camera's tick and cancels a sequence part way through.
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(
+	FRTSCameraSequenceTest,
+	"OpenRTSCamera.Sequence.QueuedOperations",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter
+)
+
+bool FRTSCameraSequenceTest::RunTest(const FString& Parameters)
+{
+	using namespace RTSCameraTests;
+
+	FRTSCameraTestWorld TestWorld(0);
+	if (!TestNotNull(TEXT("Camera"), TestWorld.Camera))
+	{
+		return false;
+	}
+
+	const auto Camera = TestWorld.Camera;
+
+	// A cursor in the middle of the screen, away from the edges that scroll the camera
+	FRTSCameraCursorSnapshot Cursor;
+	Cursor.ViewportSize = ViewportSize;
+	Cursor.ViewportMousePosition = ViewportSize * 0.5;
+	Cursor.PlayerMousePosition = ViewportSize * 0.5;
+	Camera->SetCursorOverride(Cursor);
+
+	const auto Tick = [Camera](const int32 NumFrames)
+	{
+		for (auto Frame = 0; Frame < NumFrames; Frame++)
+		{
+			Camera->TickComponent(1.0f / 60.0f, LEVELTICK_All, &Camera->PrimaryComponentTick);
+		}
+	};
+
+	const FVector Destination(3000, -2000, 0);
+	auto Moved = Camera->QueueCameraOperationAsync(FRTSCameraOperation::MoveTo(Destination, 0.5f));
+	auto IsZoomContinued = false;
+	Camera->QueueCameraOperationAsync(FRTSCameraOperation::ZoomTo(Camera->MinimumZoomLength, 0.5f)).Next(
+		[&IsZoomContinued](const bool IsFinished)
+		{
+			IsZoomContinued = IsFinished;
+		}
+	);
+	TestTrue(TEXT("The sequence runs"), Camera->IsSequenceRunning());
+
+	Tick(10);
+	TestFalse(TEXT("The move takes its duration"), Moved.IsReady());
+
+	Tick(30);
+	if (TestTrue(TEXT("The move finished"), Moved.IsReady()))
+	{
+		TestTrue(TEXT("The move completed"), Moved.Get());
+		TestTrue(
+			TEXT("The camera arrived"),
+			FVector::Dist2D(TestWorld.CameraComponent->GetOwner()->GetActorLocation(), Destination) < 1
+		);
+	}
+	TestFalse(TEXT("The zoom waits for the move"), IsZoomContinued);
+
+	Tick(40);
+	TestTrue(TEXT("The zoom runs after the move and continues the future"), IsZoomContinued);
+	TestFalse(TEXT("The sequence is over"), Camera->IsSequenceRunning());
+
+	auto Cancelled = Camera->QueueCameraOperationAsync(FRTSCameraOperation::MoveTo(FVector::ZeroVector, 1));
+	Tick(5);
+	Camera->CancelSequence();
+	TestTrue(TEXT("Cancelling finishes the future"), Cancelled.IsReady() && !Cancelled.Get());
+	TestFalse(TEXT("Nothing is left queued"), Camera->IsSequenceRunning());
+	return true;
+}
+
+#endif
@@ -0,0 +1,94 @@
+// Copyright 2024 Jesus Bracho All Rights Reserved.
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "RTSCameraTestWorld.h"
+
+/**
+ * Checks that the camera state holds what the last tick did instead of flags reset within the tick.
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(
+	FRTSCameraStateTest,
+	"OpenRTSCamera.State.Transitions",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter
+)
+
+bool FRTSCameraStateTest::RunTest(const FString& Parameters)
+{
+	using namespace RTSCameraTests;
+
+	FRTSCameraTestWorld TestWorld(1);
+	if (!TestNotNull(TEXT("Camera"), TestWorld.Camera))
+	{
+		return false;
+	}
+
+	const auto Camera = TestWorld.Camera;
+
+	// A cursor in the middle of the screen, away from the edges that scroll the camera
+	FRTSCameraCursorSnapshot Cursor;
+	Cursor.ViewportSize = ViewportSize;
+	Cursor.ViewportMousePosition = ViewportSize * 0.5;
+	Cursor.PlayerMousePosition = ViewportSize * 0.5;
+	Camera->SetCursorOverride(Cursor);
+
+	const auto Tick = [Camera]()
+	{
+		Camera->TickComponent(1.0f / 60.0f, LEVELTICK_All, &Camera->PrimaryComponentTick);
+	};
+
+	Tick();
+	TestFalse(TEXT("The camera rests without input"), Camera->IsPanning());
+
+	Camera->InjectInput(ERTSCameraInputEvent::MoveCameraXAxis, FInputActionValue(1.0f));
+	Tick();
+	TestTrue(TEXT("Keyboard input pans the camera"), Camera->HasCameraState(ERTSCameraStateFlags::KeyboardPan));
+	TestTrue(TEXT("The pan outlives the tick that caused it"), Camera->IsPanning());
+
+	Tick();
+	TestFalse(TEXT("The pan stops with the input"), Camera->IsPanning());
+
+	// Edge scrolling ends when it is turned off or a drag starts, even with the cursor still on the edge
+	auto EdgeCursor = Cursor;
+	EdgeCursor.ViewportMousePosition.X = ViewportSize.X;
+	EdgeCursor.PlayerMousePosition.X = ViewportSize.X;
+	Camera->SetCursorOverride(EdgeCursor);
+	Tick();
+	TestTrue(TEXT("The cursor on the edge scrolls"), Camera->HasCameraState(ERTSCameraStateFlags::EdgeScrollPan));
+
+	Camera->EnableEdgeScrolling = false;
+	Tick();
+	TestFalse(TEXT("Disabling edge scrolling stops the pan"), Camera->IsPanning());
+
+	Camera->EnableEdgeScrolling = true;
+	Tick();
+	TestTrue(TEXT("Enabling it again scrolls"), Camera->HasCameraState(ERTSCameraStateFlags::EdgeScrollPan));
+
+	Camera->InjectInput(ERTSCameraInputEvent::DragCamera, FInputActionValue(true));
+	Tick();
+	TestFalse(
+		TEXT("Starting a drag stops the edge scroll pan"),
+		Camera->HasCameraState(ERTSCameraStateFlags::EdgeScrollPan)
+	);
+
+	Camera->InjectInput(ERTSCameraInputEvent::DragCamera, FInputActionValue(false));
+	Camera->SetCursorOverride(Cursor);
+	Tick();
+	TestFalse(TEXT("The camera rests again"), Camera->IsPanning());
+
+	const auto Target = TestWorld.World->SpawnActor<AActor>();
+	Camera->FollowTarget(Target);
+	TestTrue(
+		TEXT("Following starts without waiting for a tick"),
+		Camera->HasCameraState(ERTSCameraStateFlags::Following)
+	);
+
+	Camera->UnFollowTarget();
+	TestFalse(TEXT("Following stops"), Camera->HasCameraState(ERTSCameraStateFlags::Following));
+
+	return true;
+}
+
+#endif
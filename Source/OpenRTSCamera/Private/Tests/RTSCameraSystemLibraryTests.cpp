@@ -0,0 +1,212 @@
+// Copyright 2024 Jesus Bracho All Rights Reserved.
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "RTSCameraFollowMe.h"
+#include "RTSCameraSystemLibrary.h"
+#include "RTSCameraTestWorld.h"
+#include "UObject/UnrealType.h"
+
+/**
+ * Checks that the batched library functions agree with the ones for a single actor and that the follow me component
+ * drives the player's camera.
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(
+	FRTSCameraSystemLibraryTest,
+	"OpenRTSCamera.Library.BatchedMatchesSingle",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter
+)
+
+bool FRTSCameraSystemLibraryTest::RunTest(const FString& Parameters)
+{
+	using namespace RTSCameraTests;
+
+	FRTSCameraTestWorld TestWorld(0);
+	const auto World = TestWorld.World;
+	if (!TestEqual(TEXT("The player's camera is found"), URTSCameraSystemLibrary::GetRTSCamera(World), TestWorld.Camera))
+	{
+		return false;
+	}
+
+	// Every other actor is a unit
+	TArray<AActor*> Actors;
+	for (auto Index = 0; Index < 8; Index++)
+	{
+		const auto Actor = World->SpawnActor<AActor>();
+		const auto Root = NewObject<USceneComponent>(Actor);
+		Actor->SetRootComponent(Root);
+		Root->RegisterComponent();
+		if (Index % 2 == 0)
+		{
+			NewObject<URTSSelectable>(Actor)->RegisterComponent();
+		}
+		Actors.Add(Actor);
+	}
+	Actors.Add(nullptr);
+
+	URTSCameraSystemLibrary::SelectActors(World, {Actors[0], Actors[1], Actors[4]});
+
+	TArray<URTSSelectable*> Selectables;
+	TArray<ERTSSignificanceTier> Tiers;
+	TArray<bool> IsSelected;
+	URTSCameraSystemLibrary::GetSelectables(Actors, Selectables);
+	URTSCameraSystemLibrary::GetSignificanceTiers(Actors, Tiers);
+	URTSCameraSystemLibrary::AreActorsSelected(World, Actors, IsSelected);
+	if (!TestEqual(TEXT("Batches fill one element per actor"), Selectables.Num(), Actors.Num()))
+	{
+		return false;
+	}
+
+	auto NumSelected = 0;
+	for (auto Index = 0; Index < Actors.Num(); Index++)
+	{
+		const auto Actor = Actors[Index];
+		TestEqual(TEXT("Selectables match"), Selectables[Index], URTSCameraSystemLibrary::GetSelectable(Actor));
+		TestEqual(TEXT("Tiers match"), Tiers[Index], URTSCameraSystemLibrary::GetSignificanceTier(Actor));
+		TestEqual(
+			TEXT("Selection matches"),
+			IsSelected[Index],
+			URTSCameraSystemLibrary::IsActorSelected(World, Actor)
+		);
+		NumSelected += IsSelected[Index] ? 1 : 0;
+	}
+	TestEqual(TEXT("Only the selected units are selected"), NumSelected, 2);
+
+	const auto FollowMe = NewObject<URTSCameraFollowMe>(Actors[2]);
+	FollowMe->RegisterComponent();
+	FollowMe->FollowMe();
+	TestTrue(TEXT("The camera follows the actor"), FollowMe->IsFollowingMe());
+	TestEqual(TEXT("The camera's target is the actor"), TestWorld.Camera->GetFollowTarget(), Actors[2]);
+
+	Actors[2]->Destroy();
+	TestNull(TEXT("The camera stops following a destroyed actor"), TestWorld.Camera->GetFollowTarget());
+	return true;
+}
+
+namespace RTSCameraTests
+{
+	// The hidden world context pins are filled in by the graph, they do not have to line up
+	static bool IsWorldContextParameter(const FProperty* Parameter)
+	{
+		return Parameter->GetFName() == TEXT("__WorldContext") || Parameter->GetFName() == TEXT("WorldContextObject");
+	}
+
+	static TArray<const FProperty*> GetParameters(const UFunction* Function)
+	{
+		TArray<const FProperty*> Parameters;
+		for (TFieldIterator<FProperty> It(Function); It && It->HasAnyPropertyFlags(CPF_Parm); ++It)
+		{
+			if (!IsWorldContextParameter(*It))
+			{
+				Parameters.Add(*It);
+			}
+		}
+		return Parameters;
+	}
+
+	/**
+	 * Lists the functions and variables the Blueprint class declares that the native class does not declare with the
+	 * same name, parameters and types. Overridden events and the event graph are the Blueprint's own.
+	 */
+	static void FindSignatureMismatches(
+		const UClass* BlueprintClass,
+		const UClass* NativeClass,
+		TArray<FString>& OutMismatches
+	)
+	{
+		for (TFieldIterator<UFunction> It(BlueprintClass, EFieldIteratorFlags::ExcludeSuper); It; ++It)
+		{
+			const auto BlueprintFunction = *It;
+			if (
+				BlueprintFunction->GetSuperFunction() != nullptr
+				|| BlueprintFunction->GetName().StartsWith(TEXT("ExecuteUbergraph"))
+				|| BlueprintFunction->GetFName() == TEXT("UserConstructionScript")
+			)
+			{
+				continue;
+			}
+
+			const auto NativeFunction = NativeClass->FindFunctionByName(BlueprintFunction->GetFName());
+			if (NativeFunction == nullptr)
+			{
+				OutMismatches.Add(FString::Printf(TEXT("%s has no native function"), *BlueprintFunction->GetName()));
+				continue;
+			}
+
+			const auto BlueprintParameters = GetParameters(BlueprintFunction);
+			const auto NativeParameters = GetParameters(NativeFunction);
+			auto IsSame = BlueprintParameters.Num() == NativeParameters.Num();
+			for (auto Index = 0; IsSame && Index < BlueprintParameters.Num(); Index++)
+			{
+				const auto BlueprintParameter = BlueprintParameters[Index];
+				const auto NativeParameter = NativeParameters[Index];
+				IsSame = BlueprintParameter->GetFName() == NativeParameter->GetFName()
+					&& BlueprintParameter->SameType(NativeParameter)
+					&& BlueprintParameter->HasAnyPropertyFlags(CPF_OutParm | CPF_ReturnParm)
+					== NativeParameter->HasAnyPropertyFlags(CPF_OutParm | CPF_ReturnParm);
+			}
+			if (!IsSame)
+			{
+				OutMismatches.Add(FString::Printf(TEXT("%s has different parameters"), *BlueprintFunction->GetName()));
+			}
+		}
+
+		for (TFieldIterator<FProperty> It(BlueprintClass, EFieldIteratorFlags::ExcludeSuper); It; ++It)
+		{
+			if (!It->HasAnyPropertyFlags(CPF_BlueprintVisible))
+			{
+				continue;
+			}
+
+			const auto NativeProperty = NativeClass->FindPropertyByName(It->GetFName());
+			if (NativeProperty == nullptr || !It->SameType(NativeProperty))
+			{
+				OutMismatches.Add(FString::Printf(TEXT("Variable %s has no native counterpart"), *It->GetName()));
+			}
+		}
+	}
+}
+
+/**
+ * Compares BPFL_RTSCameraSystem and AC_RTSCameraFollowMe with their native counterparts, graphs only keep working on
+ * the native classes once every Blueprint function and variable is declared the same way there.
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(
+	FRTSCameraSystemLibrarySignatureTest,
+	"OpenRTSCamera.Library.MirrorsBlueprintSignatures",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter
+)
+
+bool FRTSCameraSystemLibrarySignatureTest::RunTest(const FString& Parameters)
+{
+	using namespace RTSCameraTests;
+
+	const TPair<const TCHAR*, const UClass*> Pairs[] = {
+		{TEXT("/OpenRTSCamera/BPFL_RTSCameraSystem.BPFL_RTSCameraSystem_C"), URTSCameraSystemLibrary::StaticClass()},
+		{TEXT("/OpenRTSCamera/AC_RTSCameraFollowMe.AC_RTSCameraFollowMe_C"), URTSCameraFollowMe::StaticClass()},
+	};
+
+	for (const auto& [BlueprintPath, NativeClass] : Pairs)
+	{
+		const auto BlueprintClass = LoadObject<UClass>(nullptr, BlueprintPath);
+		if (BlueprintClass == nullptr)
+		{
+			// A checkout without its LFS content has nothing to compare against
+			AddWarning(FString::Printf(TEXT("Could not load %s"), BlueprintPath));
+			continue;
+		}
+
+		TArray<FString> Mismatches;
+		FindSignatureMismatches(BlueprintClass, NativeClass, Mismatches);
+		for (const auto& Mismatch : Mismatches)
+		{
+			AddError(FString::Printf(TEXT("%s: %s"), *BlueprintClass->GetName(), *Mismatch));
+		}
+	}
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,118 @@
+// Copyright 2024 Jesus Bracho All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "RTSCamera.h"
+#include "RTSHUD.h"
+#include "RTSSelectable.h"
+#include "Components/BoxComponent.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+
+namespace RTSCameraTests
+{
+	static constexpr float UnitSpacing = 200;
+	static const FVector2D ViewportSize(1920, 1080);
+
+	/**
+	 * A game world with a possessed RTS camera pawn and a grid of selectables, torn down on destruction.
+	 */
+	class FRTSCameraTestWorld
+	{
+	public:
+		explicit FRTSCameraTestWorld(const int32 NumSelectables)
+		{
+			this->World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("RTSCameraTestWorld"));
+			auto& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+			WorldContext.SetCurrentWorld(this->World);
+			this->World->InitializeActorsForPlay(FURL());
+			this->World->BeginPlay();
+
+			this->SpawnGround();
+			this->SpawnSelectables(NumSelectables);
+			this->SpawnCameraPawn();
+
+			// Let the spring arm place the camera before anything projects through it
+			this->World->Tick(LEVELTICK_All, 1.0f / 60.0f);
+		}
+
+		~FRTSCameraTestWorld()
+		{
+			GEngine->DestroyWorldContext(this->World);
+			this->World->DestroyWorld(false);
+		}
+
+		FRTSSelectionView GetSelectionView() const
+		{
+			FMinimalViewInfo ViewInfo;
+			this->CameraComponent->GetCameraView(0, ViewInfo);
+			ViewInfo.AspectRatio = ViewportSize.X / ViewportSize.Y;
+			return FRTSSelectionView::FromViewInfo(ViewInfo, ViewportSize);
+		}
+
+		UWorld* World = nullptr;
+		URTSCamera* Camera = nullptr;
+		UCameraComponent* CameraComponent = nullptr;
+
+	private:
+		void SpawnGround() const
+		{
+			const auto Ground = this->World->SpawnActor<AActor>();
+			const auto Box = NewObject<UBoxComponent>(Ground);
+			Box->SetBoxExtent(FVector(1000000, 1000000, 10));
+			Box->SetCollisionProfileName(UCollisionProfile::BlockAll_ProfileName);
+			Ground->SetRootComponent(Box);
+			Box->RegisterComponent();
+		}
+
+		void SpawnSelectables(const int32 NumSelectables) const
+		{
+			const auto Side = FMath::CeilToInt32(FMath::Sqrt(static_cast<float>(NumSelectables)));
+			const auto Offset = Side * UnitSpacing * 0.5f;
+			for (auto Index = 0; Index < NumSelectables; Index++)
+			{
+				const auto Unit = this->World->SpawnActor<AActor>();
+				const auto Root = NewObject<USceneComponent>(Unit);
+				Unit->SetRootComponent(Root);
+				Root->SetWorldLocation(
+					FVector((Index % Side) * UnitSpacing - Offset, (Index / Side) * UnitSpacing - Offset, 0)
+				);
+				Root->RegisterComponent();
+				NewObject<URTSSelectable>(Unit)->RegisterComponent();
+			}
+		}
+
+		void SpawnCameraPawn()
+		{
+			const auto Pawn = this->World->SpawnActor<APawn>();
+			const auto Root = NewObject<USceneComponent>(Pawn);
+			Pawn->SetRootComponent(Root);
+			Root->RegisterComponent();
+
+			const auto SpringArm = NewObject<USpringArmComponent>(Pawn);
+			SpringArm->SetupAttachment(Root);
+			SpringArm->RegisterComponent();
+
+			this->CameraComponent = NewObject<UCameraComponent>(Pawn);
+			this->CameraComponent->SetupAttachment(SpringArm);
+			this->CameraComponent->RegisterComponent();
+
+			const auto PlayerController = this->World->SpawnActor<APlayerController>();
+			PlayerController->Possess(Pawn);
+			PlayerController->SetViewTarget(Pawn);
+			PlayerController->ClientSetHUD(ARTSHUD::StaticClass());
+
+			// Registered last, BeginPlay collects everything spawned above
+			this->Camera = NewObject<URTSCamera>(Pawn);
+			this->Camera->RegisterComponent();
+		}
+	};
+}
+
+#endif
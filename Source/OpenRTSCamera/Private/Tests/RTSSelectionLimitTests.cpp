@@ -0,0 +1,73 @@
+// Copyright 2024 Jesus Bracho All Rights Reserved.
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "RTSCameraSubsystem.h"
+#include "RTSCameraTestWorld.h"
+
+/**
+ * Selects a whole grid of units with MaxSelectionCount set and checks which units are kept and how many are dropped.
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(
+	FRTSSelectionLimitTest,
+	"OpenRTSCamera.Selection.MaxSelectionCount",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter
+)
+
+bool FRTSSelectionLimitTest::RunTest(const FString& Parameters)
+{
+	using namespace RTSCameraTests;
+
+	FRTSCameraTestWorld TestWorld(400);
+	const auto Camera = TestWorld.Camera;
+	const auto Subsystem = TestWorld.World->GetSubsystem<URTSCameraSubsystem>();
+	if (!TestNotNull(TEXT("Camera"), Camera) || !TestNotNull(TEXT("Subsystem"), Subsystem))
+	{
+		return false;
+	}
+
+	TArray<AActor*> Units;
+	Subsystem->GetSelectableActorsInRectangle(
+		TestWorld.GetSelectionView(),
+		FBox2D(FVector2D(-1.e6), FVector2D(1.e6)),
+		Units
+	);
+	if (!TestEqual(TEXT("Every unit is found"), Units.Num(), 400))
+	{
+		return false;
+	}
+
+	Camera->HandleSelectedActors(Units);
+	TestEqual(TEXT("Without a limit everything is selected"), Camera->SelectedActors.Num(), 400);
+	TestEqual(TEXT("Nothing is dropped without a limit"), Camera->GetNumDroppedFromLastSelection(), 0);
+
+	// A few officers among the rank and file
+	for (auto Index = 0; Index < Units.Num(); Index += 50)
+	{
+		Units[Index]->FindComponentByClass<URTSSelectable>()->SelectionPriority = 1;
+	}
+
+	Camera->MaxSelectionCount = 20;
+	Camera->SelectionOrder = ERTSSelectionOrder::Priority;
+	Camera->HandleSelectedActors(Units);
+	TestEqual(TEXT("The selection is capped"), Camera->SelectedActors.Num(), 20);
+	TestEqual(TEXT("The dropped units are counted"), Camera->GetNumDroppedFromLastSelection(), 380);
+	if (TestEqual(TEXT("Kept units are ordered best first"), Camera->SelectedActors[0]->SelectionPriority, 1))
+	{
+		auto NumOfficers = 0;
+		for (const auto Selected : Camera->SelectedActors)
+		{
+			NumOfficers += Selected->SelectionPriority;
+		}
+		TestEqual(TEXT("Every higher priority unit is kept"), NumOfficers, 8);
+	}
+
+	Camera->SelectionOrder = ERTSSelectionOrder::NearestToCenter;
+	Camera->HandleSelectedActors(Units);
+	TestEqual(TEXT("Nearest to the centre is capped the same way"), Camera->SelectedActors.Num(), 20);
+	return true;
+}
+
+#endif
@@ -0,0 +1,145 @@
+// Copyright 2024 Jesus Bracho All Rights Reserved.
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "RTSSelectionReplication.h"
+
+/**
+ * Round trips selection deltas and checks that typical selections stay small.
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(
+	FRTSSelectionReplicationTest,
+	"OpenRTSCamera.SelectionReplication.Deltas",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter
+)
+
+bool FRTSSelectionReplicationTest::RunTest(const FString& Parameters)
+{
+	using namespace RTSSelectionReplication;
+
+	// 300 units spawned together, then 10 orders that each add or drop a few of them
+	TArray<int32> Selection;
+	for (auto UnitId = 1000; UnitId < 1300; UnitId++)
+	{
+		Selection.Add(UnitId);
+	}
+
+	TArray<int32> ServerSelection;
+	TArray<uint8> Delta;
+	EncodeSelectionDelta(ServerSelection, Selection, Delta);
+	TestTrue(TEXT("A contiguous group of 300 units encodes in a few bytes"), Delta.Num() <= 8);
+	TestTrue(TEXT("The delta applies"), ApplySelectionDelta(Delta, ServerSelection));
+	TestEqual(TEXT("The server mirrors the selection"), ServerSelection, Selection);
+
+	auto TotalBytes = Delta.Num();
+	for (auto Order = 0; Order < 10; Order++)
+	{
+		auto NewSelection = Selection;
+		NewSelection.Remove(1000 + Order * 17);
+		NewSelection.Add(5000 + Order);
+		NewSelection.Sort();
+
+		Delta.Reset();
+		EncodeSelectionDelta(Selection, NewSelection, Delta);
+		TotalBytes += Delta.Num();
+
+		TestTrue(TEXT("Each delta applies"), ApplySelectionDelta(Delta, ServerSelection));
+		TestEqual(TEXT("The server follows every change"), ServerSelection, NewSelection);
+		Selection = MoveTemp(NewSelection);
+	}
+	AddInfo(FString::Printf(TEXT("Selection and 10 changes took %d bytes of deltas"), TotalBytes));
+	TestTrue(TEXT("The whole exchange stays under a hundred bytes"), TotalBytes < 100);
+
+	Delta.Reset();
+	EncodeSelectionDelta(Selection, {}, Delta);
+	TestTrue(TEXT("Clearing applies"), ApplySelectionDelta(Delta, ServerSelection));
+	TestEqual(TEXT("Clearing empties the selection"), ServerSelection.Num(), 0);
+
+	const auto Untouched = Selection;
+	TestFalse(TEXT("Truncated deltas are rejected"), ApplySelectionDelta({0x01, 0x05}, Selection));
+	TestFalse(TEXT("Trailing bytes are rejected"), ApplySelectionDelta({0x00, 0x00, 0x00}, Selection));
+	TestFalse(
+		TEXT("Deltas that add too many units are rejected"),
+		ApplySelectionDelta({0x00, 0x01, 0x01, 0xFF, 0xFF, 0x7F}, Selection)
+	);
+	TestEqual(TEXT("Rejected deltas leave the selection alone"), Selection, Untouched);
+
+	return true;
+}
+
+/**
+ * Loses an update between the client and the server and checks that the server asks for a keyframe, ignores what the
+ * client sent in the meantime and mirrors the selection again once the keyframe arrives.
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(
+	FRTSSelectionResyncTest,
+	"OpenRTSCamera.SelectionReplication.Resync",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter
+)
+
+bool FRTSSelectionResyncTest::RunTest(const FString& Parameters)
+{
+	using namespace RTSSelectionReplication;
+
+	FSelectionSender Sender;
+	FSelectionReceiver Receiver;
+	int32 Sequence;
+	bool IsKeyframe;
+	TArray<uint8> Delta;
+
+	// Selects the units from First up to Last and returns what the server made of the update, if anything was sent
+	const auto Select = [&](const int32 First, const int32 Last, const bool IsDelivered = true)
+	{
+		TArray<int32> UnitIds;
+		for (auto UnitId = First; UnitId <= Last; UnitId++)
+		{
+			UnitIds.Add(UnitId);
+		}
+		if (!Sender.MakeUpdate(UnitIds, Sequence, IsKeyframe, Delta) || !IsDelivered)
+		{
+			return EReceiveResult::Dropped;
+		}
+		return Receiver.Receive(Sequence, IsKeyframe, Delta);
+	};
+
+	const auto IsMirrored = [&](const int32 First, const int32 Last)
+	{
+		const auto UnitIds = Receiver.Find(Sender.Sequence);
+		return UnitIds != nullptr && UnitIds->Num() == Last - First + 1 && (*UnitIds)[0] == First;
+	};
+
+	TestTrue(TEXT("The first update is a keyframe"), Select(1, 10) == EReceiveResult::Applied && IsKeyframe);
+	TestTrue(TEXT("Later updates are deltas"), Select(5, 20) == EReceiveResult::Applied && !IsKeyframe);
+	TestTrue(TEXT("The server mirrors the selection"), IsMirrored(5, 20));
+
+	Select(30, 40, false);
+	TestTrue(TEXT("The update after a lost one asks for a keyframe"), Select(30, 50) == EReceiveResult::ResyncNeeded);
+	TestTrue(TEXT("Updates already on their way are ignored"), Select(35, 50) == EReceiveResult::Dropped);
+	TestFalse(TEXT("The lost selection cannot be looked up"), IsMirrored(35, 50));
+
+	Sender.Reset();
+	TestTrue(TEXT("The reset sends a keyframe"), Select(35, 50) == EReceiveResult::Applied && IsKeyframe);
+	TestTrue(TEXT("The server converges again"), IsMirrored(35, 50));
+	TestTrue(TEXT("Deltas follow the keyframe"), Select(36, 60) == EReceiveResult::Applied && IsMirrored(36, 60));
+
+	TArray<int32> UnitIds = {100};
+	Sender.MakeUpdate(UnitIds, Sequence, IsKeyframe, Delta);
+	Delta.Add(0);
+	TestTrue(
+		TEXT("A malformed delta asks for a keyframe"),
+		Receiver.Receive(Sequence, IsKeyframe, Delta) == EReceiveResult::ResyncNeeded
+	);
+	Sender.Reset();
+	TestTrue(TEXT("The server converges after a malformed delta"), Select(100, 100) == EReceiveResult::Applied);
+	TestTrue(TEXT("The keyframe's selection is mirrored"), IsMirrored(100, 100));
+
+	TestTrue(
+		TEXT("A server that lost the selection asks for a keyframe"),
+		FSelectionReceiver().Receive(7, false, Delta) == EReceiveResult::ResyncNeeded
+	);
+	return true;
+}
+
+#endif
@@ -0,0 +1,90 @@
+// Copyright 2024 Jesus Bracho All Rights Reserved.
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "RTSCameraSubsystem.h"
+#include "RTSCameraTestWorld.h"
+#include "RTSSquadSelectable.h"
+
+/**
+ * Selects squads as single selectables, expands them into their members on request and follows a member that moved.
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(
+	FRTSSquadSelectionTest,
+	"OpenRTSCamera.Selection.Squads",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter
+)
+
+bool FRTSSquadSelectionTest::RunTest(const FString& Parameters)
+{
+	using namespace RTSCameraTests;
+
+	FRTSCameraTestWorld TestWorld(0);
+	const auto Camera = TestWorld.Camera;
+	const auto Subsystem = TestWorld.World->GetSubsystem<URTSCameraSubsystem>();
+	if (!TestNotNull(TEXT("Camera"), Camera) || !TestNotNull(TEXT("Subsystem"), Subsystem))
+	{
+		return false;
+	}
+
+	const auto SpawnAt = [&TestWorld](const FVector& Location)
+	{
+		const auto Actor = TestWorld.World->SpawnActor<AActor>();
+		const auto Root = NewObject<USceneComponent>(Actor);
+		Actor->SetRootComponent(Root);
+		Root->SetWorldLocation(Location);
+		Root->RegisterComponent();
+		return Actor;
+	};
+
+	// 5 squads of 10, each squad in a column of its own
+	TArray<URTSSquadSelectable*> Squads;
+	TArray<AActor*> FirstMembers;
+	for (auto SquadIndex = 0; SquadIndex < 5; SquadIndex++)
+	{
+		const FVector SquadLocation(SquadIndex * 2000 - 4000, 0, 0);
+		const auto Squad = NewObject<URTSSquadSelectable>(SpawnAt(SquadLocation));
+		for (auto MemberIndex = 0; MemberIndex < 10; MemberIndex++)
+		{
+			const auto Member = SpawnAt(SquadLocation + FVector(0, MemberIndex * UnitSpacing, 0));
+			Squad->AddMember(Member);
+			if (MemberIndex == 0)
+			{
+				FirstMembers.Add(Member);
+			}
+		}
+		Squad->RegisterComponent();
+		Squads.Add(Squad);
+	}
+
+	const auto View = TestWorld.GetSelectionView();
+	TArray<AActor*> Found;
+	Subsystem->GetSelectableActorsInRectangle(View, FBox2D(FVector2D(-1.e6), FVector2D(1.e6)), Found);
+	TestEqual(TEXT("Each squad is found once"), Found.Num(), 5);
+
+	Camera->HandleSelectedActors(Found);
+	TestEqual(TEXT("Each squad is one selection entry"), Camera->SelectedActors.Num(), 5);
+
+	TArray<AActor*> Units;
+	Camera->GetSelectedUnits(Units);
+	TestEqual(TEXT("Squads expand into their members on request"), Units.Num(), 50);
+
+	// A member wandering off takes its squad's bounds along
+	const FVector WanderedTo(-4000, 3000, 0);
+	FirstMembers[0]->SetActorLocation(WanderedTo);
+	const auto ScreenLocation = View.Project(WanderedTo);
+	Found.Reset();
+	Subsystem->GetSelectableActorsInRectangle(View, FBox2D(ScreenLocation - 1, ScreenLocation + 1), Found);
+	if (TestEqual(TEXT("Only the wandering member's squad is under it"), Found.Num(), 1))
+	{
+		TestEqual(TEXT("The squad is selected by its member"), Found[0], Squads[0]->GetOwner());
+	}
+
+	Squads[0]->RemoveMember(FirstMembers[0]);
+	TestEqual(TEXT("Removed members leave the squad"), Squads[0]->GetNumMembers(), 9);
+	return true;
+}
+
+#endif
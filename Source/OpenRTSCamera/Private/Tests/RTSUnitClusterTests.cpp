@@ -0,0 +1,86 @@
+// Copyright 2024 Jesus Bracho All Rights Reserved.
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "RTSCameraTestWorld.h"
+#include "RTSCameraSubsystem.h"
+
+/**
+ * Groups a grid of units into strategic zoom clusters, moves units across cells and selects whole clusters.
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(
+	FRTSUnitClusterTest,
+	"OpenRTSCamera.StrategicZoom.UnitClusters",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter
+)
+
+bool FRTSUnitClusterTest::RunTest(const FString& Parameters)
+{
+	using namespace RTSCameraTests;
+
+	// 20 by 20 units 200 apart, so cells of 1000 hold 5 by 5 units
+	FRTSCameraTestWorld TestWorld(400);
+	const auto Subsystem = TestWorld.World->GetSubsystem<URTSCameraSubsystem>();
+	if (!TestNotNull(TEXT("Subsystem"), Subsystem))
+	{
+		return false;
+	}
+
+	const auto View = TestWorld.GetSelectionView();
+	const auto CountUnits = [](const TArray<FRTSUnitCluster>& Clusters)
+	{
+		auto NumUnits = 0;
+		for (const auto& Cluster : Clusters)
+		{
+			NumUnits += Cluster.NumUnits;
+		}
+		return NumUnits;
+	};
+
+	TArray<FRTSUnitCluster> Clusters;
+	Subsystem->GetUnitClustersInView(View, 1000000, Clusters);
+	TestEqual(TEXT("Nothing is clustered until a cell size is set"), Clusters.Num(), 0);
+
+	Subsystem->SetUnitClusterCellSize(1000);
+	Subsystem->GetUnitClustersInView(View, 1000000, Clusters);
+	TestEqual(TEXT("Every unit is in a cluster"), CountUnits(Clusters), 400);
+	TestEqual(TEXT("Units group by cell"), Clusters.Num(), 16);
+
+	// Carry one unit far away, into a cell of its own
+	TArray<AActor*> Units;
+	Subsystem->GetSelectableActorsInUnitClusters(View, FBox2D(FVector2D(-1.e6), FVector2D(1.e6)), 32, Units);
+	TestEqual(TEXT("A box around everything selects every unit"), Units.Num(), 400);
+	const auto Straggler = Units[0];
+	Straggler->SetActorLocation(FVector(50000, 50000, 0));
+
+	Clusters.Reset();
+	Subsystem->GetUnitClustersInView(View, 1000000, Clusters);
+	TestEqual(TEXT("A unit moving cells moves between clusters"), Clusters.Num(), 17);
+	TestEqual(TEXT("Moving keeps every unit in a cluster"), CountUnits(Clusters), 400);
+
+	// A click on a cluster's icon selects all of its units
+	Clusters.Reset();
+	Subsystem->GetUnitClustersInView(View, 0, Clusters);
+	if (TestTrue(TEXT("Clusters are on screen"), Clusters.Num() > 0))
+	{
+		const auto& Cluster = Clusters[0];
+		Units.Reset();
+		Subsystem->GetSelectableActorsInUnitClusters(
+			View,
+			FBox2D(Cluster.ScreenLocation, Cluster.ScreenLocation + FVector2D(1)),
+			1,
+			Units
+		);
+		TestEqual(TEXT("Clicking a cluster selects its units"), Units.Num(), Cluster.NumUnits);
+	}
+
+	Subsystem->SetUnitClusterCellSize(0);
+	Clusters.Reset();
+	Subsystem->GetUnitClustersInView(View, 1000000, Clusters);
+	TestEqual(TEXT("Clustering stops"), Clusters.Num(), 0);
+	return true;
+}
+
+#endif
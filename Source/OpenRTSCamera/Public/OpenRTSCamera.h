@@ -5,6 +5,13 @@
 #include "CoreMinimal.h"
 #include "Modules/ModuleManager.h"
 
+// Verbose and VeryVerbose messages are compiled out of shipping builds
+#if UE_BUILD_SHIPPING
+OPENRTSCAMERA_API DECLARE_LOG_CATEGORY_EXTERN(LogOpenRTSCamera, Log, Log);
+#else
+OPENRTSCAMERA_API DECLARE_LOG_CATEGORY_EXTERN(LogOpenRTSCamera, Log, All);
+#endif
+
 class FOpenRTSCameraModule : public IModuleInterface
 {
 public:
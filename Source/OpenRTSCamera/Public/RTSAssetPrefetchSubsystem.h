@@ -0,0 +1,65 @@
+// Copyright 2024 Jesus Bracho All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "RTSAssetPrefetchSubsystem.generated.h"
+
+class URTSSelectable;
+struct FStreamableHandle;
+
+/**
+ * Streams in the UI assets of unit types before the UI needs them and keeps the recently used ones loaded.
+ *
+ * Units list the assets of their type, portraits, icons, command card data and so on, in
+ * URTSSelectable::PrefetchAssets; the type is the class of the unit's actor. The first time a unit of a type is hovered
+ * or selected its assets are requested asynchronously, later requests only mark the type as used. Loaded types stay
+ * resident across levels until the cache grows past AssetPrefetchBudgetMB or AssetPrefetchMaxTypes in the project
+ * settings, then the least recently used types are released.
+ *
+ * Only created when EnableAssetPrefetch is set.
+ */
+UCLASS()
+class OPENRTSCAMERA_API URTSAssetPrefetchSubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Deinitialize() override;
+
+	/** Requests the assets of the selectable's type, or marks them as used if they were requested before. */
+	void Prefetch(const URTSSelectable* Selectable);
+
+	UFUNCTION(BlueprintCallable, Category = "RTS Selection")
+	void PrefetchActors(const TArray<AActor*>& Actors);
+
+	/** Whether the assets of the actor's type finished loading. */
+	UFUNCTION(BlueprintPure, Category = "RTS Selection")
+	bool IsPrefetched(const AActor* Actor) const;
+
+	/** The estimated size of the loaded assets of all resident types. */
+	int64 GetResidentBytes() const;
+	int32 GetNumResidentTypes() const;
+
+private:
+	struct FEntry
+	{
+		TSharedPtr<FStreamableHandle> Handle;
+		int64 SizeBytes = 0;
+		uint64 LastUse = 0;
+		bool IsSizeKnown = false;
+	};
+
+	void OnTypeLoaded(FObjectKey Type);
+	// Releases the least recently used types until the cache fits its budget, the last used one always stays
+	void Trim();
+
+	TMap<FObjectKey, FEntry> Entries;
+	uint64 LastUse = 0;
+	int64 ResidentBytes = 0;
+	// Selections are mostly runs of units of one type, which are only looked up once
+	FObjectKey LastPrefetchedType;
+};
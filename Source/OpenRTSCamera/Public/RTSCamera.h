@@ -6,13 +6,27 @@
 #include "InputAction.h"
 #include "InputMappingContext.h"
 //#include "Delegates/DelegateCombinations.h"
+#include "RTSCameraFollowGroup.h"
+#include "RTSCameraInputRecording.h"
+#include "RTSCameraReplicatedView.h"
+#include "RTSCameraSequence.h"
+#include "RTSCameraSignificance.h"
+#include "RTSCameraState.h"
+#include "RTSCameraViewSnapshot.h"
 #include "RTSHUD.h"
 #include "RTSSelectable.h"
+#include "RTSSelectionReplication.h"
+#include "Async/Future.h"
 #include "Camera/CameraComponent.h"
 #include "Components/ActorComponent.h"
 #include "GameFramework/SpringArmComponent.h"
+#include "WorldPartition/WorldPartitionStreamingSource.h"
 #include "RTSCamera.generated.h"
 
+class URTSAssetPrefetchSubsystem;
+class URTSCameraSubsystem;
+struct FStreamableHandle;
+
 /**
  * We use these commands so that move camera inputs can be tied to the tick rate of the game.
  * https://github.com/HeyZoos/OpenRTSCamera/issues/27
@@ -29,11 +43,26 @@ struct FMoveCameraCommand
 	float Scale = 0;
 };
 
+/**
+ * The part of the camera that is advanced by the fixed timestep simulation and interpolated for rendering.
+ */
+USTRUCT()
+struct FRTSCameraSimulationState
+{
+	GENERATED_BODY()
+	UPROPERTY()
+	FVector RootLocation = FVector::ZeroVector;
+	UPROPERTY()
+	float TargetArmLength = 0;
+};
+
 UCLASS(Blueprintable, ClassGroup=(Custom), meta=(BlueprintSpawnableComponent))
-class OPENRTSCAMERA_API URTSCamera : public UActorComponent
+class OPENRTSCAMERA_API URTSCamera : public UActorComponent, public IWorldPartitionStreamingSourceProvider
 {
 	GENERATED_BODY()
 
+	friend class URTSCameraSubsystem;
+
 public:
 	URTSCamera();
 
@@ -43,18 +72,180 @@ public:
 		FActorComponentTickFunction* ThisTickFunction
 	) override;
 
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
 	UFUNCTION(BlueprintCallable, Category = "RTSCamera")
 	void FollowTarget(AActor* Target);
 
+	/**
+	 * Follows the centroid of a group of actors and, with EnableFollowGroupFraming, zooms to keep the group in view.
+	 * The centroid is updated as the actors move, so following a large army costs what its moving units cost.
+	 * Replaces the target followed so far.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "RTSCamera")
+	void FollowTargets(const TArray<AActor*>& Targets);
+
+	/** Follows the owners of the selected units, see FollowTargets. */
+	UFUNCTION(BlueprintCallable, Category = "RTSCamera")
+	void FollowSelection();
+
+	/** Stops following the target or the group. */
 	UFUNCTION(BlueprintCallable, Category = "RTSCamera")
 	void UnFollowTarget();
 
+	/** The single actor followed, null while following nothing or a group. */
+	UFUNCTION(BlueprintPure, Category = "RTSCamera")
+	AActor* GetFollowTarget() const;
+
 	UFUNCTION(BlueprintCallable, Category = "RTSCamera")
 	void SetActiveCamera() const;
 	
 	UFUNCTION(BlueprintCallable, Category = "RTSCamera")
 	void JumpTo(FVector Position) const;
 
+	/**
+	 * Moves the camera to the position once the scene there has streamed in, so that it does not arrive to blurry
+	 * textures and missing level cells. The position is handed to texture streaming and World Partition right away.
+	 * The camera moves once the cells around the destination are active and JumpPrewarmMinimumTime passed, or after
+	 * JumpPrewarmTimeout. A new jump replaces a pending one.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "RTSCamera - Jump")
+	void JumpToWithPrewarm(FVector Position);
+
+	UFUNCTION(BlueprintCallable, Category = "RTSCamera - Jump")
+	void CancelJump();
+
+	UFUNCTION(BlueprintPure, Category = "RTSCamera - Jump")
+	bool IsJumpPending() const;
+
+	DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnJumpFinished);
+	/** Broadcast when a prewarmed jump arrived at its destination. */
+	UPROPERTY(BlueprintAssignable, Category = "RTSCamera - Jump")
+	FOnJumpFinished OnJumpFinished;
+
+	/**
+	 * Queues a step of a camera sequence, which the camera runs from its own tick after the steps queued before it.
+	 * Operation.OnFinished is called once the step finished or the sequence was cancelled. An idle camera does not
+	 * look at the queue beyond checking that it is empty. See URTSCameraSequenceAction for the Blueprint nodes.
+	 */
+	void QueueCameraOperation(FRTSCameraOperation&& Operation);
+
+	/** Queues the operation and returns a future set to whether it finished, continue the sequence with Next. */
+	TFuture<bool> QueueCameraOperationAsync(FRTSCameraOperation&& Operation);
+
+	/** Drops every queued operation, their callbacks are called with false. */
+	UFUNCTION(BlueprintCallable, Category = "RTSCamera - Sequence")
+	void CancelSequence();
+
+	UFUNCTION(BlueprintPure, Category = "RTSCamera - Sequence")
+	bool IsSequenceRunning() const;
+
+	/** Whether the camera stopped moving, zooming and jumping. */
+	UFUNCTION(BlueprintPure, Category = "RTSCamera - Sequence")
+	bool IsSettled() const;
+
+	/** What the camera did in its last tick, as ERTSCameraStateFlags. */
+	ERTSCameraStateFlags GetCameraState() const;
+
+	UFUNCTION(BlueprintPure, Category = "RTSCamera - State")
+	bool HasCameraState(ERTSCameraStateFlags Flag) const;
+
+	/** Whether any input moved the camera in its last tick. */
+	UFUNCTION(BlueprintPure, Category = "RTSCamera - State")
+	bool IsPanning() const;
+
+	DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnCameraStateChanged, int32, NewState, int32, OldState);
+	/** Broadcast whenever any of the ERTSCameraStateFlags changed, with the flags before and after. */
+	UPROPERTY(BlueprintAssignable, Category = "RTSCamera - State")
+	FOnCameraStateChanged OnCameraStateChanged;
+
+	DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnPanStarted, int32, PanSources);
+	/** Broadcast when the camera starts moving, with the pan flags of the inputs that moved it. */
+	UPROPERTY(BlueprintAssignable, Category = "RTSCamera - State")
+	FOnPanStarted OnPanStarted;
+
+	DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnCameraStateEvent);
+	/** Broadcast on the first tick no input moved the camera. */
+	UPROPERTY(BlueprintAssignable, Category = "RTSCamera - State")
+	FOnCameraStateEvent OnPanStopped;
+
+	UPROPERTY(BlueprintAssignable, Category = "RTSCamera - State")
+	FOnCameraStateEvent OnDragStarted;
+
+	UPROPERTY(BlueprintAssignable, Category = "RTSCamera - State")
+	FOnCameraStateEvent OnDragEnded;
+
+	DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnFollowStarted, AActor*, Target);
+	/** Broadcast when the camera starts following a target, or switches to another one. No target for groups. */
+	UPROPERTY(BlueprintAssignable, Category = "RTSCamera - State")
+	FOnFollowStarted OnFollowStarted;
+
+	/** Broadcast when the camera stops following, also when its target was destroyed. */
+	UPROPERTY(BlueprintAssignable, Category = "RTSCamera - State")
+	FOnCameraStateEvent OnFollowStopped;
+
+	DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(
+		FOnZoomBandChanged,
+		ERTSCameraZoomBand,
+		NewZoomBand,
+		ERTSCameraZoomBand,
+		OldZoomBand
+	);
+	UPROPERTY(BlueprintAssignable, Category = "RTSCamera - State")
+	FOnZoomBandChanged OnZoomBandChanged;
+
+	//~ Begin IWorldPartitionStreamingSourceProvider interface
+	virtual bool GetStreamingSources(TArray<FWorldPartitionStreamingSource>& OutStreamingSources) const override;
+	//~ End IWorldPartitionStreamingSourceProvider interface
+
+	/**
+	 * Starts capturing every input the camera receives, along with the cursor and frame times, into a compact binary
+	 * stream that can be fed back with `StartInputReplay`.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "RTSCamera - Input Recording")
+	void StartInputRecording();
+
+	/** Stops recording and returns the recorded stream. */
+	UFUNCTION(BlueprintCallable, Category = "RTSCamera - Input Recording")
+	TArray<uint8> StopInputRecording();
+
+	/** Stops recording and writes the recorded stream to the given file. */
+	UFUNCTION(BlueprintCallable, Category = "RTSCamera - Input Recording")
+	bool StopInputRecordingToFile(const FString& FilePath);
+
+	/**
+	 * Restores the camera to the state the recording started from and feeds the recorded input back through the same
+	 * handlers, one recorded frame per tick. Live input is ignored until the replay ends.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "RTSCamera - Input Recording")
+	bool StartInputReplay(const TArray<uint8>& Recording);
+
+	UFUNCTION(BlueprintCallable, Category = "RTSCamera - Input Recording")
+	bool StartInputReplayFromFile(const FString& FilePath);
+
+	UFUNCTION(BlueprintCallable, Category = "RTSCamera - Input Recording")
+	void StopInputReplay();
+
+	UFUNCTION(BlueprintPure, Category = "RTSCamera - Input Recording")
+	bool IsRecordingInput() const;
+
+	UFUNCTION(BlueprintPure, Category = "RTSCamera - Input Recording")
+	bool IsReplayingInput() const;
+
+	/**
+	 * Feeds an input value through the same handler the bound input action would, for scripted or automated input.
+	 * Injected input is recorded like live input and ignored while a recording is replayed.
+	 */
+	void InjectInput(ERTSCameraInputEvent Event, const FInputActionValue& Value);
+
+	/** Makes the camera read the given cursor instead of the real one until ClearCursorOverride is called. */
+	void SetCursorOverride(const FRTSCameraCursorSnapshot& Cursor);
+	void ClearCursorOverride();
+
+	DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnInputReplayFinished);
+	UPROPERTY(BlueprintAssignable, Category = "RTSCamera - Input Recording")
+	FOnInputReplayFinished OnInputReplayFinished;
+
 	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "RTSCamera - Zoom Settings")
 	float MinimumZoomLength;
 	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "RTSCamera - Zoom Settings")
@@ -69,6 +260,13 @@ public:
 	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "RTSCamera")
 	float StartingZAngle;
 
+	/**
+	 * The tick group the camera runs in. Defaults to a group after physics so that the follow target and other
+	 * gameplay movement has already been applied by the time the camera computes its transform for the frame.
+	 */
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "RTSCamera")
+	TEnumAsByte<ETickingGroup> CameraTickGroup;
+
 	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "RTSCamera")
 	float MoveSpeed;
 	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "RTSCamera")
@@ -89,6 +287,147 @@ public:
 	)
 	float DragExtent;
 
+	/**
+	 * Simulates pan, edge scroll, ground height, zoom and bounds at a fixed rate instead of once per rendered frame.
+	 * The rendered transform is interpolated between the last two simulated states, so camera feel no longer depends
+	 * on the frame rate and hitch frames are clamped to the bounds on every step.
+	 */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "RTSCamera - Fixed Timestep Settings")
+	bool EnableFixedTimestep;
+	UPROPERTY(
+		BlueprintReadWrite,
+		EditAnywhere,
+		Category = "RTSCamera - Fixed Timestep Settings",
+		meta=(EditCondition="EnableFixedTimestep", ClampMin = "1.0")
+	)
+	float FixedTimestepRate;
+	/**
+	 * The maximum number of simulation steps run in a single frame.
+	 * Time beyond that is dropped so that a long hitch does not cause a burst of catch-up work.
+	 */
+	UPROPERTY(
+		BlueprintReadWrite,
+		EditAnywhere,
+		Category = "RTSCamera - Fixed Timestep Settings",
+		meta=(EditCondition="EnableFixedTimestep", ClampMin = "1")
+	)
+	int32 MaxFixedTimestepSteps;
+
+	/**
+	 * Sends the controlling player's view (root location, yaw, pitch and zoom) to everyone else, so that spectators
+	 * and casters viewing this camera see exactly what the player sees. Must be set before the camera is registered.
+	 * Views are quantized to twelve bytes, only sent when they change by at least one step and interpolated on arrival.
+	 */
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "RTSCamera - Replication Settings")
+	bool EnableViewReplication;
+	/** How often a fast moving view is sent, per second. */
+	UPROPERTY(
+		BlueprintReadWrite,
+		EditAnywhere,
+		Category = "RTSCamera - Replication Settings",
+		meta=(EditCondition="EnableViewReplication", ClampMin = "1.0")
+	)
+	float ViewReplicationMaxRate;
+	/** How often a view that only drifts by a few steps is sent, per second. */
+	UPROPERTY(
+		BlueprintReadWrite,
+		EditAnywhere,
+		Category = "RTSCamera - Replication Settings",
+		meta=(EditCondition="EnableViewReplication", ClampMin = "0.1")
+	)
+	float ViewReplicationMinRate;
+	/**
+	 * The half size of the box, around the world origin, that locations are quantized in when there is no boundary
+	 * volume. With a boundary volume only the height is, around the volume.
+	 */
+	UPROPERTY(
+		BlueprintReadWrite,
+		EditAnywhere,
+		Category = "RTSCamera - Replication Settings",
+		meta=(EditCondition="EnableViewReplication")
+	)
+	FVector ViewReplicationExtents;
+
+	/**
+	 * Mirrors the selection to the server as deltas of unit ids whenever HandleSelectedActors changes it, so commands
+	 * can name a selection by its sequence number. Must be set before the camera is registered.
+	 * Only units whose URTSSelectable has EnableUnitIdReplication set can be named.
+	 */
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "RTSCamera - Replication Settings")
+	bool EnableSelectionReplication;
+
+	/**
+	 * The least a prewarmed jump waits. Texture streaming gets this long to load the destination's mips, it is not
+	 * waited on beyond that because its pending work covers the whole world.
+	 */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "RTSCamera - Jump Settings", meta = (ClampMin = "0.0"))
+	float JumpPrewarmMinimumTime;
+	/** The most a prewarmed jump waits for level streaming at the destination before it moves anyway. */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "RTSCamera - Jump Settings", meta = (ClampMin = "0.0"))
+	float JumpPrewarmTimeout;
+	/** How long the camera travels to the destination of a prewarmed jump, 0 cuts straight to it. */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "RTSCamera - Jump Settings", meta = (ClampMin = "0.0"))
+	float JumpTransitionDuration;
+
+	/**
+	 * Makes the camera a World Partition streaming source on top of the player controller: the ground it sees is
+	 * loaded, and so is the ground it is panning towards, at a higher priority than what it leaves behind.
+	 * Off by default, zoomed out the footprint and with it the streamed area get large.
+	 */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "RTSCamera - Streaming Settings")
+	bool EnableStreamingSource;
+	/** How far ahead of a pan the ground is loaded, in seconds of the current pan velocity. */
+	UPROPERTY(
+		BlueprintReadWrite,
+		EditAnywhere,
+		Category = "RTSCamera - Streaming Settings",
+		meta=(EditCondition="EnableStreamingSource", ClampMin = "0.0")
+	)
+	float StreamingLookaheadTime;
+	/** Scales the radius that covers the view footprint, above 1 loads a margin around it. */
+	UPROPERTY(
+		BlueprintReadWrite,
+		EditAnywhere,
+		Category = "RTSCamera - Streaming Settings",
+		meta=(EditCondition="EnableStreamingSource", ClampMin = "0.1")
+	)
+	float StreamingRadiusScale;
+
+	/** Sets the zoom while following a group so that the group stays in view. Zoom input is overridden meanwhile. */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "RTSCamera - Follow Settings")
+	bool EnableFollowGroupFraming;
+	/** How much ground is kept in view around a followed group, in multiples of the group's spread. */
+	UPROPERTY(
+		BlueprintReadWrite,
+		EditAnywhere,
+		Category = "RTSCamera - Follow Settings",
+		meta=(EditCondition="EnableFollowGroupFraming", ClampMin = "0.1")
+	)
+	float FollowGroupFramingScale;
+	/** How quickly the framing catches up with a group that spreads out or closes in. */
+	UPROPERTY(
+		BlueprintReadWrite,
+		EditAnywhere,
+		Category = "RTSCamera - Follow Settings",
+		meta=(EditCondition="EnableFollowGroupFraming", ClampMin = "0.0")
+	)
+	float FollowGroupFramingSpeed;
+	/** Units further from a followed group than this many times its spread are left out of its centroid and framing. */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "RTSCamera - Follow Settings", meta = (ClampMin = "1.0"))
+	float FollowGroupOutlierScale;
+	/** How many units of a followed group that did not move are checked again for being outliers every tick. */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "RTSCamera - Follow Settings", meta = (ClampMin = "1"))
+	int32 FollowGroupReclassificationsPerTick;
+
+	/**
+	 * The most units a selection keeps, 0 for no limit. Larger selections keep the units that come first by
+	 * SelectionOrder, found without sorting all of them, see GetNumDroppedFromLastSelection.
+	 */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "RTSCamera - Selection Settings", meta = (ClampMin = "0"))
+	int32 MaxSelectionCount;
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "RTSCamera - Selection Settings")
+	ERTSSelectionOrder SelectionOrder;
+
 	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "RTSCamera")
 	bool EnableCameraLag;
 	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "RTSCamera")
@@ -235,10 +574,53 @@ public:
 	UPROPERTY(BlueprintReadOnly, Category = "RTSCamera - Selection")
 	TArray<URTSSelectable*> SelectedActors;
 
+	/** The actors the selection stands for, with selected squads expanded into their members. */
+	UFUNCTION(BlueprintCallable, Category = "RTSCamera - Selection")
+	void GetSelectedUnits(TArray<AActor*>& OutUnits) const;
+
+	/**
+	 * The sequence number of the selection last mirrored to the server, see EnableSelectionReplication.
+	 * Commands sent to the server can carry it instead of the selected units.
+	 */
+	UFUNCTION(BlueprintPure, Category = "RTSCamera - Selection")
+	int32 GetSelectionSequence() const;
+
+	/** How many selectable units the last selection left out to stay within MaxSelectionCount. */
+	UFUNCTION(BlueprintPure, Category = "RTSCamera - Selection")
+	int32 GetNumDroppedFromLastSelection() const;
+
+	/**
+	 * On the server, the units of the owning client's selection with the given sequence number.
+	 * Returns false if that selection has not arrived yet or is too old to be remembered.
+	 * Send commands through the camera's owner so that they arrive after the selection they name.
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category = "RTSCamera - Selection")
+	bool GetReplicatedSelection(int32 Sequence, TArray<AActor*>& OutActors) const;
+
+	/** How far the camera is zoomed out, from 0 at MinimumZoomLength to 1 at MaximumZoomLength. */
+	UFUNCTION(BlueprintPure, Category = "RTSCamera")
+	float GetZoomAlpha() const;
+
+	/** The part of the ground the camera saw the last time it ticked, the URTSCameraSubsystem ranks units by it. */
+	UFUNCTION(BlueprintPure, Category = "RTSCamera")
+	const FRTSCameraViewFootprint& GetViewFootprint() const;
+
+	/**
+	 * Copies the view the camera published at the end of its last tick. Safe to call from any thread.
+	 * Returns false until the camera ticked once.
+	 */
+	bool GetViewSnapshot(FRTSCameraViewSnapshot& OutSnapshot) const;
+
+	/** The buffer view snapshots are published to, worker threads may hold on to it past the camera's lifetime. */
+	TSharedRef<const FRTSCameraViewSnapshotBuffer, ESPMode::ThreadSafe> GetViewSnapshotBuffer() const;
+
 
 
 protected:
+	virtual void OnRegister() override;
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	virtual void RegisterComponentTickFunctions(bool bRegister) override;
 
 	void OnZoomCamera(const FInputActionValue& Value);
 	void OnRotateCamera(const FInputActionValue& Value);
@@ -249,7 +631,6 @@ protected:
 	void OnDragCamera(const FInputActionValue& Value);
 
 	void RequestMoveCamera(float X, float Y, float Scale);
-	void ApplyMoveCameraCommands();
 
 	UPROPERTY()
 	AActor* Owner;
@@ -266,8 +647,6 @@ protected:
 	UPROPERTY()
 	float DesiredZoomLength;
 
-	void ConditionallyPerformEdgeScrolling();
-
 
 	// "RTSSelector.h"
 
@@ -278,7 +657,55 @@ protected:
 
 
 private:
+	/**
+	 * Whether this machine drives the camera: never on dedicated servers, and for a pawn only while it is locally
+	 * controlled. Unpossessed pawns count as local outside of clients, where other players' pawns have no controller.
+	 */
+	bool ShouldBeLocalCamera() const;
+	void EvaluateCameraRole();
+	void ActivateLocalCamera();
+	void DeactivateLocalCamera();
+	void UnbindInputs();
+
+	FBox GetViewReplicationBounds() const;
+	FRTSCameraViewPose CaptureViewPose() const;
+	void ApplyViewPose(const FRTSCameraViewPose& Pose);
+	void ConditionallyReplicateView();
+	void UpdateViewFootprint();
+	void TickJump(float DeltaTime);
+	bool IsJumpDestinationStreamed() const;
+	void UpdateStreamingSourceRegistration();
+	void UpdatePanVelocity(float DeltaTime);
+	void UpdateCameraState();
+	void SetCameraState(ERTSCameraStateFlags NewState);
+	void PublishViewSnapshot();
+	URTSAssetPrefetchSubsystem* GetAssetPrefetchSubsystem() const;
+	void UpdateHoverPrefetch();
+	double GetViewAspectRatio() const;
+	void SetReplicatedView(const FRTSCameraReplicatedView& View);
+	void ReceiveReplicatedView();
+	void TickReplicatedView(float DeltaTime);
+
+	UFUNCTION(Server, Unreliable)
+	void ServerSetReplicatedView(const FRTSCameraReplicatedView& View);
+
+	UFUNCTION()
+	void OnRep_ReplicatedView();
+
+	void ConditionallyReplicateSelection();
+
+	UFUNCTION(Server, Reliable)
+	void ServerUpdateSelection(int32 Sequence, bool IsKeyframe, const TArray<uint8>& SelectionDelta);
+
+	// Sent when the server rejected an update, the client answers with a keyframe
+	UFUNCTION(Client, Reliable)
+	void ClientResetSelectionSync();
+
+	UFUNCTION()
+	void OnOwnerControllerChanged(APawn* Pawn, AController* OldController, AController* NewController);
+
 	void CollectComponentDependencyReferences();
+	void CollectOwnerComponentReferences();
 	void ConfigureSpringArm();
 	void TryToFindBoundaryVolumeReference();
 	void ConditionallyEnableEdgeScrolling() const;
@@ -286,22 +713,62 @@ private:
 	void BindInputMappingContext() const;
 	void BindInputActions();
 
-	double EdgeScrollLeft() const;
-	double EdgeScrollRight() const;
-	double EdgeScrollUp() const;
-	double EdgeScrollDown() const;
-
+	void RequestInputAssets();
+	void OnInputAssetsLoaded();
+	void ApplyDefaultInputAssets();
+	void BindInputs();
+
+	bool TickCamera(float DeltaTime, bool IsBatched);
+	void FinishCameraTick();
+	void TickFixedTimestep(float DeltaTime);
+	void RunSimulationStep();
+	FRTSCameraSimulationState CaptureSimulationState() const;
+	void ApplySimulationState(const FRTSCameraSimulationState& State) const;
+
+	bool ShouldHandleInput(ERTSCameraInputEvent Event, const FInputActionValue& Value);
+	const FRTSCameraCursorSnapshot& GetCursorSnapshot() const;
+	FRTSCameraRecordingStart CaptureRecordingStart() const;
+	float ReplayRecordedFrame(float DeltaTime);
+	void DispatchInput(ERTSCameraInputEvent Event, const FInputActionValue& Value);
+
+	void AddFollowTargetTickPrerequisites();
+	void RemoveFollowTargetTickPrerequisites();
 	void FollowTargetIfSet() const;
-	void SmoothTargetArmLengthToDesiredZoom() const;
+	bool HasFollowTarget() const;
+	void ClearFollowGroup();
+	void UpdateFollowGroup(float DeltaTime);
+	void OnFollowGroupMemberMoved(
+		USceneComponent* UpdatedComponent,
+		EUpdateTransformFlags UpdateTransformFlags,
+		ETeleportType Teleport,
+		int32 MemberId
+	);
 	void ConditionallyKeepCameraAtDesiredZoomAboveGround();
+	bool GetGroundTrace(FVector& OutStart, FVector& OutEnd) const;
+	void ApplyGroundTrace(bool DidHit, const FHitResult& HitResult);
 	void ConditionallyApplyCameraBounds() const;
 
+	static FCollisionQueryParams GetGroundTraceQueryParams();
+
 	UPROPERTY()
 	FName CameraBlockingVolumeTag;
 	UPROPERTY()
 	AActor* CameraFollowTarget;
+
+	struct FFollowGroupMember
+	{
+		TWeakObjectPtr<USceneComponent> RootComponent;
+		FDelegateHandle TransformUpdatedHandle;
+	};
+
+	FRTSCameraFollowGroup FollowGroup;
+	// Indexed by the member's id in FollowGroup
+	TArray<FFollowGroupMember> FollowGroupMembers;
+	int32 FollowGroupReclassifyCursor;
 	UPROPERTY()
 	float DeltaSeconds;
+	// The time this frame covered for the camera, the replayed one under an input player, not a fixed step
+	float FrameDeltaSeconds;
 	UPROPERTY()
 	bool IsCameraOutOfBoundsErrorAlreadyDisplayed;
 
@@ -310,6 +777,130 @@ private:
 
 	UPROPERTY()
 	TArray<FMoveCameraCommand> MoveCameraCommands;
+	// With a fixed timestep, commands are held until a step consumed them and weighted by the frame they came with
+	int32 NumWeightedMoveCameraCommands;
+	float PendingMoveCameraSeconds;
+	float MoveCameraCommandScale;
+	bool HasConsumedMoveCameraCommands;
+	// The move commands as RTSCameraKinematics::Step reads them, refilled every step
+	TArray<RTSCameraKinematics::FMoveCommand> KinematicsMoveCommandsScratch;
+
+	// Reused by every selection so that selecting does not allocate once they have grown
+	TSet<AActor*> NewSelectedActorSetScratch;
+	TArray<URTSSelectable*> DeselectedActorsScratch;
+	TArray<URTSSelectable*> NewlySelectedActorsScratch;
+
+	UPROPERTY()
+	float FixedTimestepAccumulator;
+	UPROPERTY()
+	bool HasSimulationState;
+	UPROPERTY()
+	FRTSCameraSimulationState PreviousSimulationState;
+	UPROPERTY()
+	FRTSCameraSimulationState CurrentSimulationState;
+	UPROPERTY()
+	FRTSCameraSimulationState RenderedSimulationState;
+
+	TUniquePtr<FRTSCameraInputRecorder> InputRecorder;
+	TUniquePtr<FRTSCameraInputPlayer> InputPlayer;
+	bool IsDispatchingReplayedInput;
+
+	mutable FRTSCameraCursorSnapshot CursorSnapshot;
+	mutable uint64 CursorSnapshotFrame;
+	bool HasCursorOverride;
+
+	TSharedPtr<FStreamableHandle> InputAssetsHandle;
+	bool IsInputBindingPending;
+
+	// Only a local camera registers its tick, binds input and loads input assets, see EvaluateCameraRole
+	bool IsLocalCamera;
+	bool IsSpringArmConfigured;
+
+	UPROPERTY(ReplicatedUsing = OnRep_ReplicatedView)
+	FRTSCameraReplicatedView ReplicatedView;
+	FRTSCameraReplicatedView LastSentView;
+	double LastViewSendTime;
+	// The last change is sent once more after a while, the server RPC carrying it may have been dropped
+	bool IsViewResendPending;
+	// Remote cameras only tick while they interpolate towards a received view
+	bool IsReceivingReplicatedView;
+	FRTSCameraViewPose ReplicatedViewFrom;
+	FRTSCameraViewPose ReplicatedViewTo;
+	float ReplicatedViewAlpha;
+	float ReplicatedViewDuration;
+	double LastViewReceiveTime;
+
+	FRTSCameraViewFootprint ViewFootprint;
+
+	ERTSCameraStateFlags CameraState;
+	// Set while the drag input moved the camera this tick, like bIsMoveCameraXAxisCalled for the keyboard
+	bool IsDragMoveCalled;
+	TWeakObjectPtr<AActor> BroadcastFollowTarget;
+	ERTSCameraZoomBand BroadcastZoomBand;
+	// The zoom band is first broadcast when it changes from the one of the first valid footprint
+	bool HasBroadcastZoomBand;
+
+	enum class EJumpPhase : uint8
+	{
+		None,
+		Prewarming,
+		Moving
+	};
+
+	void TickSequence(float DeltaTime);
+	void StartCameraOperation(FRTSCameraOperation& Operation);
+	// Whether the operation at the front of the queue finished
+	bool UpdateCameraOperation(const FRTSCameraOperation& Operation);
+
+	TArray<FRTSCameraOperation> CameraOperations;
+	float CameraOperationElapsedTime;
+	bool IsCameraOperationStarted;
+	FVector CameraOperationStartLocation;
+	float CameraOperationStartZoomLength;
+	float CameraOperationStartYaw;
+
+	EJumpPhase JumpPhase;
+	FVector JumpOrigin;
+	FVector JumpDestination;
+	float JumpElapsedTime;
+	FName JumpStreamingSourceName;
+	FName ViewStreamingSourceName;
+	FName LookaheadStreamingSourceName;
+	bool IsStreamingSourceRegistered;
+	// Smoothed over a few frames, teleports reset it
+	FVector PanVelocity;
+	FVector LastPanLocation;
+	TSharedPtr<FRTSCameraViewSnapshotBuffer, ESPMode::ThreadSafe> ViewSnapshotBuffer;
+	double LastHoverPrefetchTime;
+	FVector2D LastHoverCursorPosition;
+	TArray<AActor*> HoveredActorsScratch;
+
+	// On the owning client, what was last sent to the server
+	RTSSelectionReplication::FSelectionSender SelectionSender;
+	TArray<int32> SelectionUnitIdsScratch;
+	// Set while HandleSelectedActors clears the old selection, only the new one is mirrored
+	bool IsReplacingSelection;
+
+	struct FSelectionCandidate
+	{
+		AActor* Actor;
+		int32 Priority;
+		double DistanceSquared;
+	};
+
+	void LimitSelection(const TArray<AActor*>& Actors, TArray<AActor*>& OutSelection);
+	FVector GetSelectionFocus() const;
+
+	TArray<FSelectionCandidate> SelectionCandidatesScratch;
+	TArray<AActor*> LimitedSelectionScratch;
+	int32 NumDroppedFromLastSelection;
+	// On the server, the last few selections received from the owning client
+	RTSSelectionReplication::FSelectionReceiver SelectionReceiver;
+
+	UPROPERTY()
+	URTSCameraSubsystem* CameraSubsystem;
+	// Set while URTSCameraSubsystem ticks the camera, which then traces the ground and applies bounds for all cameras
+	bool IsGroundAndBoundsBatched;
 
 
 	// "RTSSelector.h"
@@ -0,0 +1,251 @@
+// Copyright 2024 Jesus Bracho All Rights Reserved.
+
+#pragma once
+
+#include "RTSCameraKinematics.h"
+
+#include <cmath>
+#include <vector>
+
+/**
+ * The centroid and spread of a group of followed units, kept up to date from the units that moved instead of by
+ * summing every location each frame.
+ *
+ * The group keeps running sums of the locations and of their squared distances on the ground plane, so adding,
+ * removing and moving a unit cost the same no matter how large the group is. Units further out than OutlierScale
+ * times the spread of the whole group are left out of the centroid and the radius, so that a few stragglers do not
+ * drag the camera away from the army. A unit is classified whenever it moves; call Reclassify on the units that did not
+ * move, a few at a time, to catch the ones the group moved away from.
+ *
+ * Locations are summed relative to the first unit added, which keeps the sums precise far away from the origin.
+ *
+ * Free of the engine like RTSCameraKinematics.h and tested in Tests/KinematicsCore.
+ */
+class FRTSCameraFollowGroup
+{
+public:
+	using FVec3 = RTSCameraKinematics::FVec3;
+
+	/** Units further from the centroid than this many times the spread of the whole group are outliers. */
+	double OutlierScale = 3;
+	/** Units closer to the centroid than this are never outliers, so that tight groups keep all of their units. */
+	double MinimumOutlierDistance = 500;
+
+	/** Adds a unit and returns the id it is moved and removed by. Ids of removed units are reused. */
+	int Add(const FVec3& Location)
+	{
+		if (this->NumUnits == 0)
+		{
+			this->Origin = Location;
+		}
+
+		int Id;
+		if (this->FreeIds.empty())
+		{
+			Id = static_cast<int>(this->Units.size());
+			this->Units.emplace_back();
+		}
+		else
+		{
+			Id = this->FreeIds.back();
+			this->FreeIds.pop_back();
+		}
+
+		auto& Unit = this->Units[Id];
+		Unit.Location = Location - this->Origin;
+		Unit.IsUsed = true;
+		this->All.Add(Unit.Location);
+		this->NumUnits++;
+
+		Unit.IsInlier = this->IsInlierLocation(Unit.Location);
+		if (Unit.IsInlier)
+		{
+			this->Inliers.Add(Unit.Location);
+		}
+		return Id;
+	}
+
+	void Remove(const int Id)
+	{
+		if (!this->IsValid(Id))
+		{
+			return;
+		}
+
+		auto& Unit = this->Units[Id];
+		this->All.Remove(Unit.Location);
+		if (Unit.IsInlier)
+		{
+			this->Inliers.Remove(Unit.Location);
+		}
+		Unit.IsUsed = false;
+		this->FreeIds.push_back(Id);
+		this->NumUnits--;
+
+		// Start over from exact zeros instead of whatever rounding left behind
+		if (this->NumUnits == 0)
+		{
+			this->Reset();
+		}
+	}
+
+	void Move(const int Id, const FVec3& Location)
+	{
+		if (!this->IsValid(Id))
+		{
+			return;
+		}
+
+		auto& Unit = this->Units[Id];
+		const auto NewLocation = Location - this->Origin;
+		this->All.Remove(Unit.Location);
+		this->All.Add(NewLocation);
+		if (Unit.IsInlier)
+		{
+			this->Inliers.Remove(Unit.Location);
+		}
+		Unit.Location = NewLocation;
+
+		Unit.IsInlier = this->IsInlierLocation(Unit.Location);
+		if (Unit.IsInlier)
+		{
+			this->Inliers.Add(Unit.Location);
+		}
+	}
+
+	/** Decides again whether a unit is an outlier, against where the group is now. */
+	void Reclassify(const int Id)
+	{
+		if (!this->IsValid(Id))
+		{
+			return;
+		}
+
+		auto& Unit = this->Units[Id];
+		const auto IsInlier = this->IsInlierLocation(Unit.Location);
+		if (IsInlier != Unit.IsInlier)
+		{
+			Unit.IsInlier = IsInlier;
+			if (IsInlier)
+			{
+				this->Inliers.Add(Unit.Location);
+			}
+			else
+			{
+				this->Inliers.Remove(Unit.Location);
+			}
+		}
+	}
+
+	void Reset()
+	{
+		this->Units.clear();
+		this->FreeIds.clear();
+		this->All = FMoments();
+		this->Inliers = FMoments();
+		this->NumUnits = 0;
+	}
+
+	bool IsValid(const int Id) const
+	{
+		return Id >= 0 && Id < static_cast<int>(this->Units.size()) && this->Units[Id].IsUsed;
+	}
+
+	/** One past the highest id in use, for walking the ids round robin. */
+	int GetMaxId() const
+	{
+		return static_cast<int>(this->Units.size());
+	}
+
+	int Num() const
+	{
+		return this->NumUnits;
+	}
+
+	int NumInliers() const
+	{
+		return this->Inliers.Count;
+	}
+
+	/** The mean location of the units that are not outliers, or of all units if every one of them is. */
+	FVec3 GetCentroid() const
+	{
+		return this->GetFramedMoments().GetMean() + this->Origin;
+	}
+
+	/** The root mean square distance on the ground plane of the units that are not outliers from their centroid. */
+	double GetRadius() const
+	{
+		return this->GetFramedMoments().GetRadius();
+	}
+
+private:
+	// Running sums of a set of locations
+	struct FMoments
+	{
+		int Count = 0;
+		FVec3 Sum;
+		double SumSquaredGroundDistance = 0;
+
+		void Add(const FVec3& Location)
+		{
+			this->Count++;
+			this->Sum = this->Sum + Location;
+			this->SumSquaredGroundDistance += Location.X * Location.X + Location.Y * Location.Y;
+		}
+
+		void Remove(const FVec3& Location)
+		{
+			this->Count--;
+			this->Sum = this->Sum - Location;
+			this->SumSquaredGroundDistance -= Location.X * Location.X + Location.Y * Location.Y;
+		}
+
+		FVec3 GetMean() const
+		{
+			return this->Count > 0 ? this->Sum * (1.0 / this->Count) : FVec3();
+		}
+
+		double GetRadius() const
+		{
+			if (this->Count == 0)
+			{
+				return 0;
+			}
+
+			// E[|p|^2] - |E[p]|^2, rounding may take it slightly below zero
+			const auto Mean = this->GetMean();
+			const auto Variance =
+				this->SumSquaredGroundDistance / this->Count - (Mean.X * Mean.X + Mean.Y * Mean.Y);
+			return std::sqrt(Variance > 0 ? Variance : 0);
+		}
+	};
+
+	struct FUnit
+	{
+		FVec3 Location;
+		bool IsUsed = false;
+		bool IsInlier = false;
+	};
+
+	const FMoments& GetFramedMoments() const
+	{
+		return this->Inliers.Count > 0 ? this->Inliers : this->All;
+	}
+
+	bool IsInlierLocation(const FVec3& Location) const
+	{
+		const auto Mean = this->All.GetMean();
+		const auto DeltaX = Location.X - Mean.X;
+		const auto DeltaY = Location.Y - Mean.Y;
+		const auto MaxDistance = std::fmax(this->OutlierScale * this->All.GetRadius(), this->MinimumOutlierDistance);
+		return DeltaX * DeltaX + DeltaY * DeltaY <= MaxDistance * MaxDistance;
+	}
+
+	std::vector<FUnit> Units;
+	std::vector<int> FreeIds;
+	FMoments All;
+	FMoments Inliers;
+	FVec3 Origin;
+	int NumUnits = 0;
+};
@@ -0,0 +1,41 @@
+// Copyright 2024 Jesus Bracho All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "RTSCameraFollowMe.generated.h"
+
+/**
+ * Makes a player's RTS camera follow the actor it is on. Doesn't tick, the camera does the following.
+ * Meant to replace the AC_RTSCameraFollowMe Blueprint, see URTSCameraSystemLibrary for what is still missing.
+ */
+UCLASS(Blueprintable, ClassGroup=(Custom), meta=(BlueprintSpawnableComponent))
+class OPENRTSCAMERA_API URTSCameraFollowMe : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	URTSCameraFollowMe();
+
+	UFUNCTION(BlueprintCallable, Category = "RTSCamera")
+	void FollowMe();
+
+	/** Only stops the camera if it is still following this actor. */
+	UFUNCTION(BlueprintCallable, Category = "RTSCamera")
+	void StopFollowingMe();
+
+	UFUNCTION(BlueprintPure, Category = "RTSCamera")
+	bool IsFollowingMe() const;
+
+	/** The player whose camera follows the actor. */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "RTSCamera")
+	int32 PlayerIndex;
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "RTSCamera")
+	bool EnableFollowOnBeginPlay;
+
+protected:
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+};
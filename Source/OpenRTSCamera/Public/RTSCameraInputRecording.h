@@ -0,0 +1,140 @@
+// Copyright 2024 Jesus Bracho All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "InputActionValue.h"
+
+/**
+ * Everything the camera can receive from the outside world, in the order it is written to a recording.
+ */
+enum class ERTSCameraInputEvent : uint8
+{
+	// End of a camera tick, carries the delta time the camera simulated with
+	Frame,
+	// The cursor the camera saw during a frame
+	Cursor,
+	ZoomCamera,
+	RotateCamera,
+	TurnCameraLeft,
+	TurnCameraRight,
+	MoveCameraYAxis,
+	MoveCameraXAxis,
+	DragCamera,
+	SelectionStart,
+	UpdateSelection,
+	SelectionEnd,
+	Num
+};
+
+/**
+ * All cursor and viewport state the camera reads during a frame.
+ * The camera samples it once per frame so that every handler sees the same cursor and so that it can be replayed.
+ */
+struct OPENRTSCAMERA_API FRTSCameraCursorSnapshot
+{
+	// Mouse position in viewport widget space, see UWidgetLayoutLibrary::GetMousePositionOnViewport
+	FVector2D ViewportMousePosition = FVector2D::ZeroVector;
+	// Viewport size in viewport widget space, see UWidgetLayoutLibrary::GetViewportWidgetGeometry
+	FVector2D ViewportSize = FVector2D::ZeroVector;
+	// Mouse position in viewport pixels, see APlayerController::GetMousePosition
+	FVector2D PlayerMousePosition = FVector2D::ZeroVector;
+};
+
+/**
+ * The camera state a recording starts from, restored before a replay begins.
+ */
+struct OPENRTSCAMERA_API FRTSCameraRecordingStart
+{
+	FVector RootLocation = FVector::ZeroVector;
+	FRotator RootRotation = FRotator::ZeroRotator;
+	FRotator SpringArmRotation = FRotator::ZeroRotator;
+	float TargetArmLength = 0;
+	float DesiredZoomLength = 0;
+	float ZoomSpeed = 0;
+	float MoveSpeed = 0;
+	float EdgeScrollSpeed = 0;
+};
+
+/**
+ * Writes camera input into a compact binary stream.
+ *
+ * Every record starts with a one byte tag. Cursor positions and frame times are delta encoded against the previous
+ * record as zigzag varints, and input values are stored as fixed point varints whenever that is lossless, so an idle
+ * frame costs two bytes and a typical frame with mouse movement well under ten.
+ */
+class OPENRTSCAMERA_API FRTSCameraInputRecorder
+{
+public:
+	explicit FRTSCameraInputRecorder(const FRTSCameraRecordingStart& Start);
+
+	/**
+	 * Records the cursor if it changed since the last snapshot.
+	 * The snapshot is quantized in place to what the stream can represent so that recording and replay see the same
+	 * values.
+	 */
+	void RecordCursor(FRTSCameraCursorSnapshot& Snapshot);
+
+	void RecordInput(ERTSCameraInputEvent Event, const FInputActionValue& Value);
+
+	/**
+	 * Closes the current frame.
+	 * Returns the delta time as it will be replayed, which the camera should simulate with.
+	 */
+	float RecordFrame(float DeltaSeconds);
+
+	const TArray<uint8>& GetData() const { return this->Data; }
+
+private:
+	void WriteTag(ERTSCameraInputEvent Event, uint8 Flags = 0);
+	void WriteVarUInt(uint64 Value);
+	void WriteVarInt(int64 Value);
+	void WriteFloat(float Value);
+	void WriteDouble(double Value);
+	void WriteAxisValue(float Value);
+
+	TArray<uint8> Data;
+	int64 LastCursor[6];
+	int64 LastFrameMicroseconds;
+};
+
+/**
+ * Reads a stream written by FRTSCameraInputRecorder one record at a time.
+ */
+class OPENRTSCAMERA_API FRTSCameraInputPlayer
+{
+public:
+	struct FRecord
+	{
+		ERTSCameraInputEvent Event = ERTSCameraInputEvent::Num;
+		FInputActionValue Value;
+		FRTSCameraCursorSnapshot Cursor;
+		float DeltaSeconds = 0;
+	};
+
+	explicit FRTSCameraInputPlayer(TArray<uint8> InData);
+
+	/** Whether the stream header could be read, the start state is only meaningful if it could. */
+	bool IsValid() const { return this->bIsValid; }
+
+	const FRTSCameraRecordingStart& GetStart() const { return this->Start; }
+
+	/** Reads the next record, returns false at the end of the stream or if the stream is corrupt. */
+	bool ReadNext(FRecord& OutRecord);
+
+private:
+	bool ReadByte(uint8& OutValue);
+	bool ReadVarUInt(uint64& OutValue);
+	bool ReadVarInt(int64& OutValue);
+	bool ReadFloat(float& OutValue);
+	bool ReadDouble(double& OutValue);
+	bool ReadAxisValue(float& OutValue);
+
+	TArray<uint8> Data;
+	int32 Offset;
+	bool bIsValid;
+	FRTSCameraRecordingStart Start;
+	int64 LastCursor[6];
+	int64 LastFrameMicroseconds;
+	FRTSCameraCursorSnapshot Cursor;
+};
@@ -0,0 +1,488 @@
+// Copyright 2024 Jesus Bracho All Rights Reserved.
+
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+
+/**
+ * The camera math, free of the engine so that it can be tested and benchmarked standalone and reused by cameras that
+ * are not a URTSCamera (a server-side view, a Mass processor, ...).
+ *
+ * Everything here works on plain structs, allocates nothing and has no hidden state. URTSCamera converts to and from
+ * these types and keeps all engine interaction (traces, components, input) to itself.
+ * The standalone tests and benchmarks live in Tests/KinematicsCore at the root of the plugin.
+ */
+namespace RTSCameraKinematics
+{
+	struct FVec2
+	{
+		double X = 0;
+		double Y = 0;
+	};
+
+	struct FVec3
+	{
+		double X = 0;
+		double Y = 0;
+		double Z = 0;
+	};
+
+	inline FVec3 operator+(const FVec3& A, const FVec3& B) { return {A.X + B.X, A.Y + B.Y, A.Z + B.Z}; }
+	inline FVec3 operator-(const FVec3& A, const FVec3& B) { return {A.X - B.X, A.Y - B.Y, A.Z - B.Z}; }
+	inline FVec3 operator*(const FVec3& A, const double Scale) { return {A.X * Scale, A.Y * Scale, A.Z * Scale}; }
+
+	inline double Clamp(const double Value, const double Min, const double Max)
+	{
+		return Value < Min ? Min : Value > Max ? Max : Value;
+	}
+
+	inline double Lerp(const double A, const double B, const double Alpha)
+	{
+		return A + (B - A) * Alpha;
+	}
+
+	inline FVec3 Lerp(const FVec3& A, const FVec3& B, const double Alpha)
+	{
+		return {Lerp(A.X, B.X, Alpha), Lerp(A.Y, B.Y, Alpha), Lerp(A.Z, B.Z, Alpha)};
+	}
+
+	/** Same as UKismetMathLibrary::NormalizeToRange. */
+	inline double NormalizeToRange(const double Value, double RangeMin, double RangeMax)
+	{
+		if (RangeMin == RangeMax)
+		{
+			return Value < RangeMin ? 0 : 1;
+		}
+
+		if (RangeMin > RangeMax)
+		{
+			const auto Swap = RangeMin;
+			RangeMin = RangeMax;
+			RangeMax = Swap;
+		}
+
+		return (Value - RangeMin) / (RangeMax - RangeMin);
+	}
+
+	/** Same as FMath::FInterpTo. */
+	inline double InterpTo(const double Current, const double Target, const double DeltaSeconds, const double Speed)
+	{
+		if (Speed <= 0)
+		{
+			return Target;
+		}
+
+		const auto Distance = Target - Current;
+		if (Distance * Distance < 1.e-8)
+		{
+			return Target;
+		}
+
+		return Current + Distance * Clamp(DeltaSeconds * Speed, 0, 1);
+	}
+
+	/**
+	 * Zoom input changes the desired zoom, and every speed is derived from the zoom it was changed from so that the
+	 * camera moves faster the further out it is.
+	 */
+	struct FZoom
+	{
+		double DesiredZoomLength = 0;
+		double ZoomSpeed = 0;
+		double MoveSpeed = 0;
+		double EdgeScrollSpeed = 0;
+	};
+
+	inline FZoom ApplyZoomInput(
+		const double DesiredZoomLength,
+		const double Input,
+		const double MinimumZoomLength,
+		const double MaximumZoomLength
+	)
+	{
+		FZoom Zoom;
+		Zoom.ZoomSpeed = -20 - DesiredZoomLength / 20;
+		Zoom.MoveSpeed = DesiredZoomLength * 2;
+		Zoom.EdgeScrollSpeed = Zoom.MoveSpeed;
+		Zoom.DesiredZoomLength = Clamp(
+			DesiredZoomLength + Input * Zoom.ZoomSpeed,
+			MinimumZoomLength,
+			MaximumZoomLength
+		);
+		return Zoom;
+	}
+
+	/**
+	 * How far into each screen edge the cursor is, from 0 outside the edge band to 1 at the very edge.
+	 */
+	struct FEdgeScroll
+	{
+		double Left = 0;
+		double Right = 0;
+		double Up = 0;
+		double Down = 0;
+
+		bool IsScrolling() const { return Left != 0 || Right != 0 || Up != 0 || Down != 0; }
+	};
+
+	inline FEdgeScroll ComputeEdgeScroll(const FVec2& MousePosition, const FVec2& ViewportSize)
+	{
+		// The edge band is 5% of the viewport on every side
+		constexpr auto EdgeBand = 0.05f;
+
+		FEdgeScroll EdgeScroll;
+		EdgeScroll.Left = 1 - Clamp(NormalizeToRange(MousePosition.X, 0, ViewportSize.X * EdgeBand), 0, 1);
+		EdgeScroll.Right = Clamp(NormalizeToRange(MousePosition.X, ViewportSize.X * (1 - EdgeBand), ViewportSize.X), 0, 1);
+		EdgeScroll.Up = 1 - Clamp(NormalizeToRange(MousePosition.Y, 0, ViewportSize.Y * EdgeBand), 0, 1);
+		EdgeScroll.Down = Clamp(NormalizeToRange(MousePosition.Y, ViewportSize.Y * (1 - EdgeBand), ViewportSize.Y), 0, 1);
+		return EdgeScroll;
+	}
+
+	/** The offset edge scrolling moves the root by, along the root's own forward and right vectors. */
+	inline FVec3 EdgeScrollOffset(
+		const FEdgeScroll& EdgeScroll,
+		const FVec3& Forward,
+		const FVec3& Right,
+		const double EdgeScrollSpeed,
+		const double DeltaSeconds
+	)
+	{
+		const auto Distance = EdgeScrollSpeed * DeltaSeconds;
+		return Right * ((EdgeScroll.Right - EdgeScroll.Left) * Distance)
+			+ Forward * ((EdgeScroll.Up - EdgeScroll.Down) * Distance);
+	}
+
+	/**
+	 * The offset a single move command moves the root by.
+	 * The direction is flattened onto the ground and normalized, a degenerate direction does not move at all.
+	 */
+	inline FVec3 MoveCommandOffset(
+		const double DirectionX,
+		const double DirectionY,
+		const double Scale,
+		const double MoveSpeed,
+		const double DeltaSeconds
+	)
+	{
+		const auto SquareLength = DirectionX * DirectionX + DirectionY * DirectionY;
+		if (SquareLength <= 1.e-8)
+		{
+			return {};
+		}
+
+		const auto Distance = MoveSpeed * Scale * DeltaSeconds / std::sqrt(SquareLength);
+		return {DirectionX * Distance, DirectionY * Distance, 0};
+	}
+
+	/**
+	 * How far to drag along the right and forward vectors, each in [-1, 1].
+	 * The cursor has to move DragExtent of the viewport away from where the drag started to reach full speed.
+	 */
+	inline FVec2 DragScale(
+		const FVec2& MousePosition,
+		const FVec2& DragStartPosition,
+		const FVec2& ViewportSize,
+		const double DragExtent
+	)
+	{
+		const FVec2 DragExtents = {ViewportSize.X * DragExtent, ViewportSize.Y * DragExtent};
+		if (DragExtents.X == 0 || DragExtents.Y == 0)
+		{
+			return {};
+		}
+
+		return {
+			Clamp(MousePosition.X - DragStartPosition.X, -DragExtents.X, DragExtents.X) / DragExtents.X,
+			-Clamp(MousePosition.Y - DragStartPosition.Y, -DragExtents.Y, DragExtents.Y) / DragExtents.Y
+		};
+	}
+
+	/**
+	 * Yaw and pitch to add for one rotate input, X is yaw and Y is pitch.
+	 * The cursor direction picks the sign and holding the cursor on a screen edge keeps rotating that way, the rate
+	 * grows with the zoom.
+	 */
+	inline FVec2 RotationFromCursor(
+		const FVec2& MouseDelta,
+		const FEdgeScroll& EdgeScroll,
+		const double DesiredZoomLength
+	)
+	{
+		const auto RotationRate = DesiredZoomLength / 20000;
+
+		FVec2 Rotation;
+		if (MouseDelta.X > 0 || EdgeScroll.Right != 0)
+		{
+			Rotation.X = 0.5 + RotationRate;
+		}
+		else if (MouseDelta.X < 0 || EdgeScroll.Left != 0)
+		{
+			Rotation.X = -(0.5 + RotationRate);
+		}
+
+		if (MouseDelta.Y > 0 || EdgeScroll.Down != 0)
+		{
+			Rotation.Y = 0.4 + RotationRate;
+		}
+		else if (MouseDelta.Y < 0 || EdgeScroll.Up != 0)
+		{
+			Rotation.Y = -(0.4 + RotationRate);
+		}
+
+		return Rotation;
+	}
+
+	/** Clamps a location into the horizontal extents of a bounds box, height is left alone. */
+	inline FVec3 ClampToBounds(const FVec3& Location, const FVec3& Origin, const FVec3& Extents)
+	{
+		return {
+			Clamp(Location.X, Origin.X - Extents.X, Origin.X + Extents.X),
+			Clamp(Location.Y, Origin.Y - Extents.Y, Origin.Y + Extents.Y),
+			Location.Z
+		};
+	}
+
+	/** Maps a value in [Min, Max] onto the 65536 steps of a uint16, values outside of the range are clamped. */
+	inline std::uint16_t QuantizeToUint16(const double Value, const double Min, const double Max)
+	{
+		const auto Alpha = Max > Min ? Clamp((Value - Min) / (Max - Min), 0, 1) : 0;
+		return static_cast<std::uint16_t>(std::lround(Alpha * 65535));
+	}
+
+	inline double DequantizeFromUint16(const std::uint16_t Quantized, const double Min, const double Max)
+	{
+		return Lerp(Min, Max, Quantized / 65535.0);
+	}
+
+	/** Maps an angle in degrees onto a uint16 covering one full turn. */
+	inline std::uint16_t QuantizeAngleToUint16(const double Degrees)
+	{
+		const auto Turns = Degrees / 360;
+		return static_cast<std::uint16_t>(std::lround((Turns - std::floor(Turns)) * 65536) & 0xFFFF);
+	}
+
+	/** The angle in degrees, in [0, 360). */
+	inline double DequantizeAngleFromUint16(const std::uint16_t Quantized)
+	{
+		return Quantized * (360.0 / 65536);
+	}
+
+	/**
+	 * Where the view meets the ground: the four corners of the viewport cast onto a horizontal plane, in the order
+	 * top left, top right, bottom right, bottom left as seen through the camera.
+	 */
+	struct FFootprint
+	{
+		FVec2 Corners[4];
+		FVec2 Min;
+		FVec2 Max;
+	};
+
+	/**
+	 * Intersects the rays through the corners of the view with the ground plane at GroundZ.
+	 * Rays that hit the ground further than MaxDistance away along the ground, or that look at or above the horizon,
+	 * are cut off at MaxDistance.
+	 */
+	inline FFootprint ComputeGroundFootprint(
+		const FVec3& Eye,
+		const double YawDegrees,
+		const double PitchDegrees,
+		const double HorizontalFovDegrees,
+		const double AspectRatio,
+		const double GroundZ,
+		const double MaxDistance
+	)
+	{
+		constexpr auto DegreesToRadians = 3.14159265358979323846 / 180;
+		const auto SinYaw = std::sin(YawDegrees * DegreesToRadians);
+		const auto CosYaw = std::cos(YawDegrees * DegreesToRadians);
+		const auto SinPitch = std::sin(PitchDegrees * DegreesToRadians);
+		const auto CosPitch = std::cos(PitchDegrees * DegreesToRadians);
+
+		const FVec3 Forward = {CosPitch * CosYaw, CosPitch * SinYaw, SinPitch};
+		const FVec3 Right = {-SinYaw, CosYaw, 0};
+		const FVec3 Up = {-SinPitch * CosYaw, -SinPitch * SinYaw, CosPitch};
+		const auto TanX = std::tan(HorizontalFovDegrees * 0.5 * DegreesToRadians);
+		const auto TanY = AspectRatio > 0 ? TanX / AspectRatio : TanX;
+		const auto Height = Eye.Z > GroundZ ? Eye.Z - GroundZ : 0;
+
+		constexpr double Signs[4][2] = {{-1, 1}, {1, 1}, {1, -1}, {-1, -1}};
+		FFootprint Footprint;
+		for (auto Index = 0; Index < 4; Index++)
+		{
+			const auto Direction = Forward + Right * (TanX * Signs[Index][0]) + Up * (TanY * Signs[Index][1]);
+			const auto Horizontal = std::sqrt(Direction.X * Direction.X + Direction.Y * Direction.Y);
+			const auto MaxScale = Horizontal > 0 ? MaxDistance / Horizontal : 0;
+			const auto Scale = Direction.Z < 0 && Height / -Direction.Z < MaxScale ? Height / -Direction.Z : MaxScale;
+			Footprint.Corners[Index] = {Eye.X + Direction.X * Scale, Eye.Y + Direction.Y * Scale};
+		}
+
+		Footprint.Min = Footprint.Max = Footprint.Corners[0];
+		for (const auto& Corner : Footprint.Corners)
+		{
+			Footprint.Min.X = Corner.X < Footprint.Min.X ? Corner.X : Footprint.Min.X;
+			Footprint.Min.Y = Corner.Y < Footprint.Min.Y ? Corner.Y : Footprint.Min.Y;
+			Footprint.Max.X = Corner.X > Footprint.Max.X ? Corner.X : Footprint.Max.X;
+			Footprint.Max.Y = Corner.Y > Footprint.Max.Y ? Corner.Y : Footprint.Max.Y;
+		}
+
+		return Footprint;
+	}
+
+	/**
+	 * How far a point on the ground lies outside of a footprint, negative inside.
+	 * This is the largest distance to the line through any edge, exact near the edges and an underestimate near the
+	 * corners, which is all hysteresis needs.
+	 */
+	inline double DistanceOutsideFootprint(const FFootprint& Footprint, const FVec2& Point)
+	{
+		// The winding depends on whether the camera looks down or up, the signed area fixes the edge normals
+		auto TwiceArea = 0.0;
+		for (auto Index = 0; Index < 4; Index++)
+		{
+			const auto& A = Footprint.Corners[Index];
+			const auto& B = Footprint.Corners[(Index + 1) % 4];
+			TwiceArea += A.X * B.Y - B.X * A.Y;
+		}
+		const auto Winding = TwiceArea < 0 ? -1.0 : 1.0;
+
+		auto Distance = -1.e300;
+		for (auto Index = 0; Index < 4; Index++)
+		{
+			const auto& A = Footprint.Corners[Index];
+			const auto& B = Footprint.Corners[(Index + 1) % 4];
+			const auto EdgeX = B.X - A.X;
+			const auto EdgeY = B.Y - A.Y;
+			const auto Length = std::sqrt(EdgeX * EdgeX + EdgeY * EdgeY);
+			if (Length <= 0)
+			{
+				continue;
+			}
+
+			// Positive on the right of a counter clockwise edge, which is outside
+			const auto EdgeDistance = Winding * (EdgeY * (Point.X - A.X) - EdgeX * (Point.Y - A.Y)) / Length;
+			Distance = EdgeDistance > Distance ? EdgeDistance : Distance;
+		}
+
+		return Distance;
+	}
+
+	/** Interpolates between two angles in degrees the shorter way round. */
+	inline double LerpAngle(const double A, const double B, const double Alpha)
+	{
+		auto Delta = std::fmod(B - A, 360.0);
+		if (Delta > 180)
+		{
+			Delta -= 360;
+		}
+		else if (Delta < -180)
+		{
+			Delta += 360;
+		}
+		return A + Delta * Alpha;
+	}
+
+	struct FMoveCommand
+	{
+		double X = 0;
+		double Y = 0;
+		double Scale = 0;
+	};
+
+	/**
+	 * Everything the camera reads from the outside during a step.
+	 * MoveCommands is borrowed, the core never copies or frees it.
+	 */
+	struct FStepInput
+	{
+		const FMoveCommand* MoveCommands = nullptr;
+		int NumMoveCommands = 0;
+		bool EnableEdgeScrolling = false;
+		// Dragging moves the camera through move commands and suspends edge scrolling
+		bool IsDragging = false;
+		FVec2 MousePosition;
+		FVec2 ViewportSize;
+		double DeltaSeconds = 0;
+	};
+
+	struct FStepSettings
+	{
+		double ZoomCatchupSpeed = 0;
+	};
+
+	struct FState
+	{
+		FVec3 RootLocation;
+		// Unit vectors of the root, edge scrolling moves along them
+		FVec3 RootForward = {1, 0, 0};
+		FVec3 RootRight = {0, 1, 0};
+		double TargetArmLength = 0;
+		double DesiredZoomLength = 0;
+		double MoveSpeed = 0;
+		double EdgeScrollSpeed = 0;
+	};
+
+	/** Moves the root by every move command of the step. */
+	inline void ApplyMoveCommands(FState& State, const FStepInput& Input)
+	{
+		for (auto Index = 0; Index < Input.NumMoveCommands; Index++)
+		{
+			const auto& Command = Input.MoveCommands[Index];
+			State.RootLocation = State.RootLocation + MoveCommandOffset(
+				Command.X,
+				Command.Y,
+				Command.Scale,
+				State.MoveSpeed,
+				Input.DeltaSeconds
+			);
+		}
+	}
+
+	/**
+	 * Moves the root towards the screen edges the cursor is in.
+	 * Returns how far the cursor was into each screen edge, nothing if edge scrolling did not run.
+	 */
+	inline FEdgeScroll ApplyEdgeScrolling(FState& State, const FStepInput& Input)
+	{
+		FEdgeScroll EdgeScroll;
+		if (Input.EnableEdgeScrolling && !Input.IsDragging)
+		{
+			EdgeScroll = ComputeEdgeScroll(Input.MousePosition, Input.ViewportSize);
+			State.RootLocation = State.RootLocation + EdgeScrollOffset(
+				EdgeScroll,
+				State.RootForward,
+				State.RootRight,
+				State.EdgeScrollSpeed,
+				Input.DeltaSeconds
+			);
+		}
+
+		return EdgeScroll;
+	}
+
+	/** Eases the arm length towards the desired zoom. */
+	inline void SmoothZoom(FState& State, const FStepInput& Input, const FStepSettings& Settings)
+	{
+		State.TargetArmLength = InterpTo(
+			State.TargetArmLength,
+			State.DesiredZoomLength,
+			Input.DeltaSeconds,
+			Settings.ZoomCatchupSpeed
+		);
+	}
+
+	/**
+	 * Advances the camera by one step. URTSCamera::RunSimulationStep runs the same three sub-steps one by one so that
+	 * each of them can be timed.
+	 * The ground trace needs a world and the bounds are clamped after it, both are left to the caller.
+	 * Returns how far the cursor was into each screen edge, nothing if edge scrolling did not run.
+	 */
+	inline FEdgeScroll Step(FState& State, const FStepInput& Input, const FStepSettings& Settings)
+	{
+		ApplyMoveCommands(State, Input);
+		const auto EdgeScroll = ApplyEdgeScrolling(State, Input);
+		SmoothZoom(State, Input, Settings);
+		return EdgeScroll;
+	}
+}
@@ -0,0 +1,79 @@
+// Copyright 2024 Jesus Bracho All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RTSCameraReplicatedView.generated.h"
+
+/**
+ * What a spectator needs to see exactly what a player sees, before quantization.
+ */
+struct OPENRTSCAMERA_API FRTSCameraViewPose
+{
+	FVector RootLocation = FVector::ZeroVector;
+	// Root yaw and spring arm pitch, in degrees
+	float Yaw = 0;
+	float Pitch = 0;
+	float ZoomLength = 0;
+
+	static FRTSCameraViewPose Lerp(const FRTSCameraViewPose& From, const FRTSCameraViewPose& To, float Alpha);
+};
+
+/**
+ * A camera view packed into twelve bytes for replication.
+ *
+ * The root location is quantized to 16 bits per axis within the camera's bounds, the angles to 16 bits per full turn
+ * and the zoom to 16 bits between the minimum and maximum zoom length. Both ends quantize against the same bounds, so
+ * a view only differs from the previous one when it moved by at least one step.
+ */
+USTRUCT()
+struct OPENRTSCAMERA_API FRTSCameraReplicatedView
+{
+	GENERATED_BODY()
+
+	uint16 X = 0;
+	uint16 Y = 0;
+	uint16 Z = 0;
+	uint16 Yaw = 0;
+	uint16 Pitch = 0;
+	uint16 Zoom = 0;
+
+	static FRTSCameraReplicatedView Quantize(
+		const FRTSCameraViewPose& Pose,
+		const FBox& Bounds,
+		float MinimumZoomLength,
+		float MaximumZoomLength
+	);
+
+	FRTSCameraViewPose Dequantize(const FBox& Bounds, float MinimumZoomLength, float MaximumZoomLength) const;
+
+	/** The largest difference between two views on any channel, in quantization steps. */
+	static int32 GetLargestStepDifference(const FRTSCameraReplicatedView& A, const FRTSCameraReplicatedView& B);
+
+	bool NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess);
+
+	bool operator==(const FRTSCameraReplicatedView& Other) const
+	{
+		return this->X == Other.X
+			&& this->Y == Other.Y
+			&& this->Z == Other.Z
+			&& this->Yaw == Other.Yaw
+			&& this->Pitch == Other.Pitch
+			&& this->Zoom == Other.Zoom;
+	}
+
+	bool operator!=(const FRTSCameraReplicatedView& Other) const
+	{
+		return !(*this == Other);
+	}
+};
+
+template <>
+struct TStructOpsTypeTraits<FRTSCameraReplicatedView> : public TStructOpsTypeTraitsBase2<FRTSCameraReplicatedView>
+{
+	enum
+	{
+		WithNetSerializer = true,
+		WithIdenticalViaEquality = true
+	};
+};
@@ -0,0 +1,79 @@
+// Copyright 2024 Jesus Bracho All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "Templates/Function.h"
+
+enum class ERTSCameraOperationType : uint8
+{
+	MoveTo,
+	ZoomTo,
+	RotateTo,
+	// Follows Target for Duration seconds then stops, without a Duration the step finishes and the camera keeps following
+	Follow,
+	// Waits until the camera stopped moving and zooming, or for Duration seconds if that is more than 0
+	WaitUntilSettled,
+};
+
+/**
+ * One step of a camera sequence, queued on a URTSCamera and run by its tick once the steps before it finished.
+ * Moves, zooms and rotations ease in and out over Duration, or happen at once without one.
+ */
+struct FRTSCameraOperation
+{
+	ERTSCameraOperationType Type = ERTSCameraOperationType::WaitUntilSettled;
+	FVector Location = FVector::ZeroVector;
+	float ZoomLength = 0;
+	float Yaw = 0;
+	TWeakObjectPtr<AActor> Target;
+	float Duration = 0;
+
+	/** Called with true once the operation finished, with false if the sequence was cancelled before. */
+	TUniqueFunction<void(bool)> OnFinished;
+
+	static FRTSCameraOperation MoveTo(const FVector& Location, const float Duration)
+	{
+		FRTSCameraOperation Operation;
+		Operation.Type = ERTSCameraOperationType::MoveTo;
+		Operation.Location = Location;
+		Operation.Duration = Duration;
+		return Operation;
+	}
+
+	static FRTSCameraOperation ZoomTo(const float ZoomLength, const float Duration)
+	{
+		FRTSCameraOperation Operation;
+		Operation.Type = ERTSCameraOperationType::ZoomTo;
+		Operation.ZoomLength = ZoomLength;
+		Operation.Duration = Duration;
+		return Operation;
+	}
+
+	static FRTSCameraOperation RotateTo(const float Yaw, const float Duration)
+	{
+		FRTSCameraOperation Operation;
+		Operation.Type = ERTSCameraOperationType::RotateTo;
+		Operation.Yaw = Yaw;
+		Operation.Duration = Duration;
+		return Operation;
+	}
+
+	static FRTSCameraOperation Follow(AActor* Target, const float Duration)
+	{
+		FRTSCameraOperation Operation;
+		Operation.Type = ERTSCameraOperationType::Follow;
+		Operation.Target = Target;
+		Operation.Duration = Duration;
+		return Operation;
+	}
+
+	static FRTSCameraOperation WaitUntilSettled(const float Timeout)
+	{
+		FRTSCameraOperation Operation;
+		Operation.Type = ERTSCameraOperationType::WaitUntilSettled;
+		Operation.Duration = Timeout;
+		return Operation;
+	}
+};
@@ -0,0 +1,58 @@
+// Copyright 2024 Jesus Bracho All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Kismet/BlueprintAsyncActionBase.h"
+#include "RTSCameraSequence.h"
+#include "RTSCameraSequenceAction.generated.h"
+
+class URTSCamera;
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE(FRTSCameraSequenceActionPin);
+
+/**
+ * Blueprint nodes that queue a step of a camera sequence and fire Finished once the camera ran it, or Cancelled if
+ * the sequence was cancelled first. Chain the nodes from Finished, nothing polls the camera in between.
+ */
+UCLASS()
+class OPENRTSCAMERA_API URTSCameraSequenceAction : public UBlueprintAsyncActionBase
+{
+	GENERATED_BODY()
+
+public:
+	UFUNCTION(BlueprintCallable, Category = "RTSCamera - Sequence", meta = (BlueprintInternalUseOnly = "true"))
+	static URTSCameraSequenceAction* MoveCameraTo(URTSCamera* Camera, FVector Location, float Duration = 1);
+
+	UFUNCTION(BlueprintCallable, Category = "RTSCamera - Sequence", meta = (BlueprintInternalUseOnly = "true"))
+	static URTSCameraSequenceAction* ZoomCameraTo(URTSCamera* Camera, float ZoomLength, float Duration = 1);
+
+	/** Turns the camera to the yaw the short way around. */
+	UFUNCTION(BlueprintCallable, Category = "RTSCamera - Sequence", meta = (BlueprintInternalUseOnly = "true"))
+	static URTSCameraSequenceAction* RotateCameraTo(URTSCamera* Camera, float Yaw, float Duration = 1);
+
+	/** Follows the target for Duration seconds, or from then on without a Duration. */
+	UFUNCTION(BlueprintCallable, Category = "RTSCamera - Sequence", meta = (BlueprintInternalUseOnly = "true"))
+	static URTSCameraSequenceAction* FollowWithCamera(URTSCamera* Camera, AActor* Target, float Duration = 3);
+
+	/** Waits until the camera stopped moving and zooming, or for Timeout seconds if that is more than 0. */
+	UFUNCTION(BlueprintCallable, Category = "RTSCamera - Sequence", meta = (BlueprintInternalUseOnly = "true"))
+	static URTSCameraSequenceAction* WaitForCameraToSettle(URTSCamera* Camera, float Timeout = 0);
+
+	virtual void Activate() override;
+
+	UPROPERTY(BlueprintAssignable)
+	FRTSCameraSequenceActionPin Finished;
+
+	UPROPERTY(BlueprintAssignable)
+	FRTSCameraSequenceActionPin Cancelled;
+
+private:
+	static URTSCameraSequenceAction* Create(URTSCamera* Camera, FRTSCameraOperation&& Operation);
+	void OnOperationFinished(bool IsFinished);
+
+	UPROPERTY()
+	URTSCamera* Camera;
+
+	FRTSCameraOperation Operation;
+};
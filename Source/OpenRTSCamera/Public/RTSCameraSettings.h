@@ -0,0 +1,90 @@
+// Copyright 2024 Jesus Bracho All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DeveloperSettings.h"
+#include "RTSCameraSettings.generated.h"
+
+class UInputAction;
+class UInputMappingContext;
+
+/**
+ * Project wide defaults for the RTS camera, found under Project Settings > Plugins > Open RTS Camera.
+ *
+ * The input assets are soft references so that nothing is loaded when the camera class is, they are streamed in
+ * asynchronously when a camera registers and used for every input the camera itself does not set.
+ */
+UCLASS(Config = OpenRTSCamera, DefaultConfig, meta = (DisplayName = "Open RTS Camera"))
+class OPENRTSCAMERA_API URTSCameraSettings : public UDeveloperSettings
+{
+	GENERATED_BODY()
+
+public:
+	URTSCameraSettings();
+
+	virtual FName GetCategoryName() const override;
+
+	UPROPERTY(Config, EditAnywhere, Category = "Inputs")
+	TSoftObjectPtr<UInputMappingContext> InputMappingContext;
+	UPROPERTY(Config, EditAnywhere, Category = "Inputs")
+	TSoftObjectPtr<UInputAction> RotateCameraAxis;
+	UPROPERTY(Config, EditAnywhere, Category = "Inputs")
+	TSoftObjectPtr<UInputAction> TurnCameraLeft;
+	UPROPERTY(Config, EditAnywhere, Category = "Inputs")
+	TSoftObjectPtr<UInputAction> TurnCameraRight;
+	UPROPERTY(Config, EditAnywhere, Category = "Inputs")
+	TSoftObjectPtr<UInputAction> MoveCameraYAxis;
+	UPROPERTY(Config, EditAnywhere, Category = "Inputs")
+	TSoftObjectPtr<UInputAction> MoveCameraXAxis;
+	UPROPERTY(Config, EditAnywhere, Category = "Inputs")
+	TSoftObjectPtr<UInputAction> DragCamera;
+	UPROPERTY(Config, EditAnywhere, Category = "Inputs")
+	TSoftObjectPtr<UInputAction> ZoomCamera;
+	UPROPERTY(Config, EditAnywhere, Category = "Inputs")
+	TSoftObjectPtr<UInputAction> BeginSelection;
+
+	/**
+	 * How long BeginPlay may block waiting for input assets that are still streaming in, in seconds.
+	 * When the wait runs out input is bound as soon as the assets arrive instead.
+	 */
+	UPROPERTY(Config, EditAnywhere, Category = "Inputs", meta = (ClampMin = "0"))
+	float InputAssetLoadTimeout;
+
+	/** Sorts selectables into significance tiers by what the local cameras see every frame. */
+	UPROPERTY(Config, EditAnywhere, Category = "Significance")
+	bool EnableSignificance;
+
+	/** Units on screen and closer than this to a camera are OnScreenClose. */
+	UPROPERTY(Config, EditAnywhere, Category = "Significance", meta = (ClampMin = "0"))
+	float SignificanceCloseDistance;
+
+	/**
+	 * How far past a tier's edge a unit has to move before it drops to a lower tier,
+	 * so that units on the edge of the screen do not flip every frame.
+	 */
+	UPROPERTY(Config, EditAnywhere, Category = "Significance", meta = (ClampMin = "0"))
+	float SignificanceHysteresis;
+
+	/** How far the view footprint reaches along the ground when the camera looks towards the horizon. */
+	UPROPERTY(Config, EditAnywhere, Category = "Significance", meta = (ClampMin = "0"))
+	float SignificanceMaxViewDistance;
+
+	/**
+	 * Streams in the PrefetchAssets of hovered and selected unit types before the UI asks for them.
+	 * Off by default, hovering costs every local camera a spatial query each HoverPrefetchInterval.
+	 */
+	UPROPERTY(Config, EditAnywhere, Category = "Asset Prefetch")
+	bool EnableAssetPrefetch;
+
+	/** Least recently used unit types are released once their estimated size adds up to more than this. */
+	UPROPERTY(Config, EditAnywhere, Category = "Asset Prefetch", meta = (ClampMin = "0", Units = "MB"))
+	float AssetPrefetchBudgetMB;
+
+	UPROPERTY(Config, EditAnywhere, Category = "Asset Prefetch", meta = (ClampMin = "1"))
+	int32 AssetPrefetchMaxTypes;
+
+	/** How often the units under a moving cursor are looked up for prefetching, in seconds. */
+	UPROPERTY(Config, EditAnywhere, Category = "Asset Prefetch", meta = (ClampMin = "0"))
+	float HoverPrefetchInterval;
+};
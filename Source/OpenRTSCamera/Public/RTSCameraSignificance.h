@@ -0,0 +1,57 @@
+// Copyright 2024 Jesus Bracho All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RTSCameraKinematics.h"
+#include "RTSCameraSignificance.generated.h"
+
+/**
+ * How far a camera is zoomed out, in thirds of its zoom range.
+ */
+UENUM(BlueprintType)
+enum class ERTSCameraZoomBand : uint8
+{
+	Near,
+	Mid,
+	Far
+};
+
+/**
+ * How much a unit matters to what the local players see, from most to least.
+ * Tick rate, animation and effect systems can throttle units by tier.
+ */
+UENUM(BlueprintType)
+enum class ERTSSignificanceTier : uint8
+{
+	// On screen and within the close distance of a camera
+	OnScreenClose,
+	OnScreenFar,
+	OffScreen,
+	Num UMETA(Hidden)
+};
+
+/**
+ * The part of the ground a camera sees, published every frame it ticks.
+ */
+USTRUCT(BlueprintType)
+struct OPENRTSCAMERA_API FRTSCameraViewFootprint
+{
+	GENERATED_BODY()
+
+	/** Axis aligned bounds of the footprint on the ground plane. */
+	UPROPERTY(BlueprintReadOnly, Category = "RTSCamera")
+	FBox2D Bounds = FBox2D(ForceInit);
+
+	UPROPERTY(BlueprintReadOnly, Category = "RTSCamera")
+	FVector EyeLocation = FVector::ZeroVector;
+
+	UPROPERTY(BlueprintReadOnly, Category = "RTSCamera")
+	ERTSCameraZoomBand ZoomBand = ERTSCameraZoomBand::Near;
+
+	/** False until the camera ticked with a camera component. */
+	UPROPERTY(BlueprintReadOnly, Category = "RTSCamera")
+	bool IsValid = false;
+
+	RTSCameraKinematics::FFootprint Ground;
+};
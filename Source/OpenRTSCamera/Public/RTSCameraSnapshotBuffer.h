@@ -0,0 +1,102 @@
+// Copyright 2024 Jesus Bracho All Rights Reserved.
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+/**
+ * Hands the latest value of a trivially copyable snapshot from one writer thread to any number of reader threads
+ * without locks.
+ *
+ * The writer fills one of three slots and then points the readers at it, so it never touches the slot readers were
+ * last sent to. Every slot carries a sequence number that is odd while the slot is written: a reader copies the slot
+ * and retries if the number was odd or changed meanwhile, which only happens when it was preempted for two whole
+ * publications. Values are stored as relaxed atomic words, so concurrent copies are well defined.
+ *
+ * Free of the engine like RTSCameraKinematics.h and tested in Tests/KinematicsCore.
+ */
+template <typename T>
+class TRTSCameraSnapshotBuffer
+{
+	static_assert(std::is_trivially_copyable<T>::value, "Snapshots are copied word by word");
+	static_assert(std::is_default_constructible<T>::value, "Readers construct the snapshot they copy into");
+
+public:
+	/** Makes the snapshot the one readers get. Only ever call this from one thread at a time. */
+	void Publish(const T& Snapshot)
+	{
+		uint64_t Words[NumWords] = {};
+		std::memcpy(Words, &Snapshot, sizeof(T));
+
+		const auto Index = (this->LatestIndex.load(std::memory_order_relaxed) + 1) % NumSlots;
+		auto& Slot = this->Slots[Index];
+		const auto Sequence = Slot.Sequence.load(std::memory_order_relaxed);
+		Slot.Sequence.store(Sequence + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+
+		for (auto Word = 0; Word < NumWords; Word++)
+		{
+			Slot.Words[Word].store(Words[Word], std::memory_order_relaxed);
+		}
+
+		Slot.Sequence.store(Sequence + 2, std::memory_order_release);
+		this->LatestIndex.store(Index, std::memory_order_release);
+		this->NumPublished.fetch_add(1, std::memory_order_release);
+	}
+
+	/** Copies the latest snapshot, from any thread. Returns false if none was published yet. */
+	bool Read(T& OutSnapshot) const
+	{
+		if (this->NumPublished.load(std::memory_order_acquire) == 0)
+		{
+			return false;
+		}
+
+		uint64_t Words[NumWords];
+		for (;;)
+		{
+			const auto& Slot = this->Slots[this->LatestIndex.load(std::memory_order_acquire)];
+			const auto Sequence = Slot.Sequence.load(std::memory_order_acquire);
+			if ((Sequence & 1) != 0)
+			{
+				continue;
+			}
+
+			for (auto Word = 0; Word < NumWords; Word++)
+			{
+				Words[Word] = Slot.Words[Word].load(std::memory_order_relaxed);
+			}
+
+			std::atomic_thread_fence(std::memory_order_acquire);
+			if (Slot.Sequence.load(std::memory_order_relaxed) == Sequence)
+			{
+				std::memcpy(&OutSnapshot, Words, sizeof(T));
+				return true;
+			}
+		}
+	}
+
+	/** How many snapshots were published so far, readers can skip work when it did not change. */
+	uint64_t GetNumPublished() const
+	{
+		return this->NumPublished.load(std::memory_order_acquire);
+	}
+
+private:
+	static constexpr int NumSlots = 3;
+	static constexpr int NumWords = static_cast<int>((sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t));
+
+	// Slots on their own cache lines, the writer filling one does not slow down readers copying another
+	struct alignas(64) FSlot
+	{
+		std::atomic<uint32_t> Sequence{0};
+		std::atomic<uint64_t> Words[NumWords] = {};
+	};
+
+	FSlot Slots[NumSlots];
+	alignas(64) std::atomic<int> LatestIndex{0};
+	std::atomic<uint64_t> NumPublished{0};
+};
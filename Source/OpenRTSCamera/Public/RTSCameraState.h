@@ -0,0 +1,32 @@
+// Copyright 2024 Jesus Bracho All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RTSCameraState.generated.h"
+
+/**
+ * What a camera is doing, gathered at the end of every tick it runs.
+ * The pan flags tell which inputs moved the camera that tick.
+ */
+UENUM(BlueprintType, meta = (Bitflags, UseEnumValuesAsMaskValuesInEditor = "true"))
+enum class ERTSCameraStateFlags : uint8
+{
+	None = 0 UMETA(Hidden),
+	KeyboardPan = 1 << 0,
+	EdgeScrollPan = 1 << 1,
+	DragPan = 1 << 2,
+	// The drag button is held, whether or not the cursor moved away from where it was pressed
+	Dragging = 1 << 3,
+	Following = 1 << 4,
+	Jumping = 1 << 5,
+};
+ENUM_CLASS_FLAGS(ERTSCameraStateFlags);
+
+namespace RTSCameraState
+{
+	constexpr auto PanFlags =
+		ERTSCameraStateFlags::KeyboardPan
+		| ERTSCameraStateFlags::EdgeScrollPan
+		| ERTSCameraStateFlags::DragPan;
+}
@@ -0,0 +1,234 @@
+// Copyright 2024 Jesus Bracho All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineBaseTypes.h"
+#include "Engine/HitResult.h"
+#include "RTSCameraSignificance.h"
+#include "RTSUnitCluster.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "RTSCameraSubsystem.generated.h"
+
+class APlayerController;
+class URTSCamera;
+class URTSCameraSubsystem;
+class URTSSelectable;
+struct FRTSSelectionView;
+
+/**
+ * Ticks every camera of a URTSCameraSubsystem from one place.
+ */
+USTRUCT()
+struct FRTSCameraSubsystemTickFunction : public FTickFunction
+{
+	GENERATED_BODY()
+
+	URTSCameraSubsystem* Subsystem = nullptr;
+
+	virtual void ExecuteTick(
+		float DeltaTime,
+		ELevelTick TickType,
+		ENamedThreads::Type CurrentThread,
+		const FGraphEventRef& MyCompletionGraphEvent
+	) override;
+
+	virtual FString DiagnosticMessage() override;
+};
+
+template <>
+struct TStructOpsTypeTraits<FRTSCameraSubsystemTickFunction>
+	: public TStructOpsTypeTraitsBase2<FRTSCameraSubsystemTickFunction>
+{
+	enum
+	{
+		WithCopy = false
+	};
+};
+
+/**
+ * Owns every RTS camera and every selectable of a game world.
+ *
+ * Cameras register on BeginPlay, are bound to their own local player controller and are then ticked together instead
+ * of by their components: every camera runs its input and simulation, then the ground traces of all cameras run in one
+ * pass, then all cameras are clamped to their bounds, which are read once per frame no matter how many cameras share
+ * them. The tick runs in the latest CameraTickGroup of the registered cameras and after all of their follow targets.
+ *
+ * Selectables are kept in a uniform grid on the ground plane that is updated incrementally as they move, so a box
+ * selection only looks at the units in grid cells that are on screen.
+ *
+ * After the cameras ticked every selectable is sorted into a significance tier by the view footprints of the local
+ * cameras. Cells away from every footprint mark all of their units off screen without looking at them one by one.
+ *
+ * For strategic zoom, selectables can also be grouped into unit clusters on a second ground grid whose cell size the
+ * HUD picks from the zoom. Like the spatial index, clusters are only touched by the units that moved.
+ */
+UCLASS()
+class OPENRTSCAMERA_API URTSCameraSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	void RegisterCamera(URTSCamera* Camera);
+	void UnregisterCamera(URTSCamera* Camera);
+
+	/**
+	 * The local player controller that drives a camera: the one possessing its pawn, otherwise the first local player
+	 * controller no other camera is bound to, otherwise the first local player controller.
+	 */
+	APlayerController* FindPlayerControllerForCamera(const URTSCamera* Camera) const;
+
+	/** Re-adds the follow targets of every camera as prerequisites of the shared camera tick. */
+	void RefreshTickPrerequisites();
+
+	/** The bounds of a camera boundary volume, gathered at most once per frame. */
+	void GetBoundaryVolumeBounds(const AActor* Volume, FVector& OutOrigin, FVector& OutExtents);
+
+	void RegisterSelectable(URTSSelectable* Selectable);
+	void UnregisterSelectable(URTSSelectable* Selectable);
+	void UpdateSelectable(URTSSelectable* Selectable);
+
+	/** The selectable the server gave this unit id, if it is still registered. Server only. */
+	URTSSelectable* FindSelectableByUnitId(int32 UnitId) const;
+
+	/**
+	 * Finds the actors of all selectables whose root component bounds overlap the screen rectangle.
+	 * Selectables without a root component when they registered are not indexed.
+	 */
+	void GetSelectableActorsInRectangle(
+		const FRTSSelectionView& View,
+		const FBox2D& Rectangle,
+		TArray<AActor*>& OutActors
+	);
+
+	void TickCameras(float DeltaTime);
+
+	DECLARE_MULTICAST_DELEGATE_ThreeParams(
+		FOnSignificanceTierChanged,
+		URTSSelectable* /* Selectable */,
+		ERTSSignificanceTier /* OldTier */,
+		ERTSSignificanceTier /* NewTier */
+	);
+
+	/** Broadcast for every selectable whose tier changed, once all cameras ticked. */
+	FOnSignificanceTierChanged OnSignificanceTierChanged;
+
+	/** How many registered selectables are in the tier right now. */
+	int32 GetNumSelectablesInSignificanceTier(ERTSSignificanceTier Tier) const;
+
+	/**
+	 * Starts grouping selectables into unit clusters: the units of one ClusterType in one ground cell of the given edge
+	 * length, 0 stops clustering. A new cell size regroups every unit, so callers snap it to a few sizes.
+	 * There is one clustering per world, shared by all local HUDs.
+	 */
+	void SetUnitClusterCellSize(double CellSize);
+	double GetUnitClusterCellSize() const;
+
+	/** The clusters whose location projects to within Margin pixels of the viewport, with ScreenLocation filled in. */
+	void GetUnitClustersInView(const FRTSSelectionView& View, float Margin, TArray<FRTSUnitCluster>& OutClusters) const;
+
+	/**
+	 * Finds the actors of all selectables in the clusters whose icon, a square of IconSize pixels around the cluster's
+	 * screen location, overlaps the screen rectangle. Selects whole clusters with one test each.
+	 */
+	void GetSelectableActorsInUnitClusters(
+		const FRTSSelectionView& View,
+		const FBox2D& Rectangle,
+		float IconSize,
+		TArray<AActor*>& OutActors
+	) const;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	struct FSelectableCell
+	{
+		TArray<URTSSelectable*> Selectables;
+		// Union of the root bounds of the selectables, only ever grows until it is recomputed
+		FBox Bounds = FBox(ForceInit);
+		bool IsBoundsDirty = false;
+	};
+
+	struct FGroundTrace
+	{
+		URTSCamera* Camera = nullptr;
+		FVector Start = FVector::ZeroVector;
+		FVector End = FVector::ZeroVector;
+		ECollisionChannel CollisionChannel = ECC_WorldStatic;
+		FHitResult HitResult;
+		bool DidHit = false;
+	};
+
+	struct FUnitClusterKey
+	{
+		FIntPoint CellCoordinates = FIntPoint::ZeroValue;
+		FName Type;
+
+		bool operator==(const FUnitClusterKey& Other) const
+		{
+			return this->CellCoordinates == Other.CellCoordinates && this->Type == Other.Type;
+		}
+
+		friend uint32 GetTypeHash(const FUnitClusterKey& Key)
+		{
+			return HashCombine(GetTypeHash(Key.CellCoordinates), GetTypeHash(Key.Type));
+		}
+	};
+
+	struct FUnitCluster
+	{
+		TArray<URTSSelectable*> Selectables;
+		// Moves within the cell are added to the sum, so the mean location never walks the selectables
+		FVector LocationSum = FVector::ZeroVector;
+	};
+
+	struct FUnitClusterMembership
+	{
+		FUnitClusterKey Key;
+		FVector Location = FVector::ZeroVector;
+	};
+
+	static FIntPoint GetCellCoordinates(const FVector& Location);
+	static void UpdateCellBounds(FSelectableCell& Cell);
+
+	void UpdateTickFunction();
+	void AddSelectableToCell(URTSSelectable* Selectable, const FIntPoint& CellCoordinates, const FBox& Bounds);
+	void RemoveSelectableFromCell(URTSSelectable* Selectable, const FIntPoint& CellCoordinates);
+
+	FUnitClusterKey GetUnitClusterKey(const URTSSelectable* Selectable, const FVector& Location) const;
+	void AddSelectableToUnitCluster(URTSSelectable* Selectable, const FVector& Location);
+	void RemoveSelectableFromUnitCluster(URTSSelectable* Selectable);
+	void UpdateSelectableUnitCluster(URTSSelectable* Selectable, const FVector& Location);
+
+	void UpdateSignificance();
+	ERTSSignificanceTier ComputeSignificanceTier(const URTSSelectable* Selectable) const;
+	void SetSignificanceTier(URTSSelectable* Selectable, ERTSSignificanceTier Tier);
+
+	UPROPERTY()
+	TArray<URTSCamera*> Cameras;
+
+	FRTSCameraSubsystemTickFunction TickFunction;
+
+	TMap<FIntPoint, FSelectableCell> SelectableCells;
+	TMap<URTSSelectable*, FIntPoint> SelectableCellCoordinates;
+	TMap<int32, URTSSelectable*> SelectablesByUnitId;
+	int32 LastUnitId = 0;
+
+	TMap<const AActor*, FBox> BoundaryVolumeBounds;
+	uint64 BoundaryVolumeBoundsFrame = MAX_uint64;
+
+	int32 NumSelectablesInSignificanceTier[static_cast<int32>(ERTSSignificanceTier::Num)] = {};
+
+	double UnitClusterCellSize = 0;
+	TMap<FUnitClusterKey, FUnitCluster> UnitClusters;
+	TMap<URTSSelectable*, FUnitClusterMembership> UnitClusterMemberships;
+
+	// Reused every frame so the batched passes do not allocate
+	TArray<URTSCamera*> ActiveCameras;
+	TArray<FGroundTrace> GroundTraces;
+	TArray<const FRTSCameraViewFootprint*> ViewFootprints;
+	TArray<TPair<URTSSelectable*, ERTSSignificanceTier>> SignificanceChanges;
+};
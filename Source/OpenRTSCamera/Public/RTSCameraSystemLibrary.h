@@ -0,0 +1,93 @@
+// Copyright 2024 Jesus Bracho All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Kismet/BlueprintFunctionLibrary.h"
+#include "RTSCameraSignificance.h"
+#include "RTSCameraSystemLibrary.generated.h"
+
+class URTSCamera;
+class URTSSelectable;
+
+/**
+ * Native helpers that find a player's RTS camera and act on units.
+ * Meant to replace the BPFL_RTSCameraSystem Blueprint library, but its signatures do not mirror the Blueprint functions
+ * yet and graphs calling those still run the Blueprint. OpenRTSCamera.Library.MirrorsBlueprintSignatures lists what
+ * differs.
+ *
+ * Functions that are called for many units come in a batched version as well, taking an array of actors and filling
+ * arrays of the same length, so that a loop over an army costs one Blueprint call instead of one per unit. The batched
+ * versions also do the per call work, finding the camera or the view projection, only once.
+ */
+UCLASS()
+class OPENRTSCAMERA_API URTSCameraSystemLibrary : public UBlueprintFunctionLibrary
+{
+	GENERATED_BODY()
+
+public:
+	/** The RTS camera on the pawn of the player, null if the player controls no pawn with one. */
+	UFUNCTION(BlueprintPure, Category = "RTSCamera", meta = (WorldContext = "WorldContextObject"))
+	static URTSCamera* GetRTSCamera(const UObject* WorldContextObject, int32 PlayerIndex = 0);
+
+	UFUNCTION(BlueprintCallable, Category = "RTSCamera", meta = (WorldContext = "WorldContextObject"))
+	static void FollowActor(const UObject* WorldContextObject, AActor* Target, int32 PlayerIndex = 0);
+
+	/** Follows the centroid of the actors, see URTSCamera::FollowTargets. */
+	UFUNCTION(BlueprintCallable, Category = "RTSCamera", meta = (WorldContext = "WorldContextObject"))
+	static void FollowActors(const UObject* WorldContextObject, const TArray<AActor*>& Targets, int32 PlayerIndex = 0);
+
+	UFUNCTION(BlueprintCallable, Category = "RTSCamera", meta = (WorldContext = "WorldContextObject"))
+	static void StopFollowing(const UObject* WorldContextObject, int32 PlayerIndex = 0);
+
+	UFUNCTION(BlueprintCallable, Category = "RTSCamera", meta = (WorldContext = "WorldContextObject"))
+	static void JumpToActor(const UObject* WorldContextObject, AActor* Target, int32 PlayerIndex = 0);
+
+	/** Replaces the player's selection, actors without a URTSSelectable are skipped. */
+	UFUNCTION(BlueprintCallable, Category = "RTSCamera - Selection", meta = (WorldContext = "WorldContextObject"))
+	static void SelectActors(const UObject* WorldContextObject, const TArray<AActor*>& Actors, int32 PlayerIndex = 0);
+
+	UFUNCTION(BlueprintPure, Category = "RTSCamera - Selection", meta = (WorldContext = "WorldContextObject"))
+	static bool IsActorSelected(const UObject* WorldContextObject, const AActor* Actor, int32 PlayerIndex = 0);
+
+	UFUNCTION(BlueprintCallable, Category = "RTSCamera - Selection", meta = (WorldContext = "WorldContextObject"))
+	static void AreActorsSelected(
+		const UObject* WorldContextObject,
+		const TArray<AActor*>& Actors,
+		TArray<bool>& OutIsSelected,
+		int32 PlayerIndex = 0
+	);
+
+	UFUNCTION(BlueprintPure, Category = "RTSCamera - Selection")
+	static URTSSelectable* GetSelectable(const AActor* Actor);
+
+	/** The URTSSelectable of each actor, null for actors without one. */
+	UFUNCTION(BlueprintCallable, Category = "RTSCamera - Selection")
+	static void GetSelectables(const TArray<AActor*>& Actors, TArray<URTSSelectable*>& OutSelectables);
+
+	/** OffScreen for actors without a URTSSelectable. */
+	UFUNCTION(BlueprintPure, Category = "RTSCamera - Significance")
+	static ERTSSignificanceTier GetSignificanceTier(const AActor* Actor);
+
+	UFUNCTION(BlueprintCallable, Category = "RTSCamera - Significance")
+	static void GetSignificanceTiers(const TArray<AActor*>& Actors, TArray<ERTSSignificanceTier>& OutTiers);
+
+	/** Projects the actor's location into the player's viewport, false if it is behind the camera. */
+	UFUNCTION(BlueprintCallable, Category = "RTSCamera", meta = (WorldContext = "WorldContextObject"))
+	static bool ProjectActorToScreen(
+		const UObject* WorldContextObject,
+		const AActor* Actor,
+		FVector2D& OutScreenLocation,
+		int32 PlayerIndex = 0
+	);
+
+	/** ProjectActorToScreen for each actor, with the view projection worked out once. */
+	UFUNCTION(BlueprintCallable, Category = "RTSCamera", meta = (WorldContext = "WorldContextObject"))
+	static void ProjectActorsToScreen(
+		const UObject* WorldContextObject,
+		const TArray<AActor*>& Actors,
+		TArray<FVector2D>& OutScreenLocations,
+		TArray<bool>& OutIsInFront,
+		int32 PlayerIndex = 0
+	);
+};
@@ -0,0 +1,41 @@
+// Copyright 2024 Jesus Bracho All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RTSCameraKinematics.h"
+#include "RTSCameraSignificance.h"
+#include "RTSCameraSnapshotBuffer.h"
+
+/**
+ * Everything worker threads want to know about a camera's view, captured at the end of the camera tick.
+ * Plain data without UObjects, safe to copy and read on any thread.
+ */
+struct OPENRTSCAMERA_API FRTSCameraViewSnapshot
+{
+	/** GFrameCounter of the tick that captured the snapshot. */
+	uint64 FrameNumber = 0;
+	double WorldTimeSeconds = 0;
+
+	FVector EyeLocation = FVector::ZeroVector;
+	FRotator EyeRotation = FRotator::ZeroRotator;
+	float FieldOfView = 90.f;
+	float AspectRatio = 1.f;
+
+	FMatrix ViewMatrix = FMatrix::Identity;
+	FMatrix ViewProjectionMatrix = FMatrix::Identity;
+
+	/** Near, left, right, top and bottom planes, pointing out of the view. The far plane is infinite. */
+	FPlane FrustumPlanes[5];
+
+	FVector RootLocation = FVector::ZeroVector;
+	float ZoomLength = 0;
+	ERTSCameraZoomBand ZoomBand = ERTSCameraZoomBand::Near;
+	RTSCameraKinematics::FFootprint Ground;
+
+	/** Whether any part of the sphere may be inside the view frustum. */
+	bool IntersectsSphere(const FVector& Center, double Radius) const;
+};
+
+/** The latest view snapshot of a camera, shared so that readers may outlive the camera. */
+using FRTSCameraViewSnapshotBuffer = TRTSCameraSnapshotBuffer<FRTSCameraViewSnapshot>;
@@ -4,8 +4,35 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/HUD.h"
+#include "RTSUnitCluster.h"
 #include "RTSHUD.generated.h"
 
+struct FMinimalViewInfo;
+
+/**
+ * Everything the selection query needs to know about the view.
+ * Unlike the canvas it can be built without rendering, which is what lets selection run in headless benchmarks.
+ */
+struct OPENRTSCAMERA_API FRTSSelectionView
+{
+	FMatrix ViewProjectionMatrix = FMatrix::Identity;
+	FVector2D ViewportSize = FVector2D::ZeroVector;
+
+	/** Projects a world location to viewport pixels the same way UCanvas::Project does. */
+	FVector2D Project(const FVector& WorldLocation) const;
+
+	/** Projects a world location, returns false if it is behind the view. */
+	bool ProjectInFront(const FVector& WorldLocation, FVector2D& OutScreenLocation) const;
+
+	/**
+	 * Projects the corners of a box and returns their screen bounds.
+	 * Returns false if part of the box is behind the view, the screen bounds are not meaningful then.
+	 */
+	bool ProjectBounds(const FBox& Bounds, FBox2D& OutScreenBounds) const;
+
+	static FRTSSelectionView FromViewInfo(const FMinimalViewInfo& ViewInfo, const FVector2D& ViewportSize);
+};
+
 UCLASS()
 class OPENRTSCAMERA_API ARTSHUD : public AHUD
 {
@@ -20,6 +47,48 @@ public:
 	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Selection Box")
 	float SelectionBoxThickness;
 
+	/**
+	 * Once the camera is zoomed out past StrategicZoomThreshold, draws the units of each ClusterType as one icon per
+	 * ground cell with their count, and box selection selects whole clusters.
+	 */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Strategic Zoom")
+	bool EnableStrategicZoom;
+	/** How far out the camera has to be zoomed, see URTSCamera::GetZoomAlpha. */
+	UPROPERTY(
+		BlueprintReadWrite,
+		EditAnywhere,
+		Category = "Strategic Zoom",
+		meta=(EditCondition="EnableStrategicZoom", ClampMin = "0.0", ClampMax = "1.0")
+	)
+	float StrategicZoomThreshold;
+	/** Roughly how far apart clusters are on screen, in pixels. */
+	UPROPERTY(
+		BlueprintReadWrite,
+		EditAnywhere,
+		Category = "Strategic Zoom",
+		meta=(EditCondition="EnableStrategicZoom", ClampMin = "1.0")
+	)
+	float StrategicZoomCellSize;
+	UPROPERTY(
+		BlueprintReadWrite,
+		EditAnywhere,
+		Category = "Strategic Zoom",
+		meta=(EditCondition="EnableStrategicZoom", ClampMin = "1.0")
+	)
+	float StrategicZoomIconSize;
+	/** How the clusters of each ClusterType are drawn, types without a style are drawn as white squares. */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Strategic Zoom", meta=(EditCondition="EnableStrategicZoom"))
+	TMap<FName, FRTSUnitClusterIconStyle> StrategicZoomIconStyles;
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Strategic Zoom", meta=(EditCondition="EnableStrategicZoom"))
+	FLinearColor StrategicZoomCountColor;
+
+	/** Whether the last frame was drawn zoomed out strategically. */
+	UFUNCTION(BlueprintPure, Category = "Strategic Zoom")
+	bool IsStrategicZoomActive() const;
+
+	UFUNCTION(BlueprintNativeEvent, Category = "Strategic Zoom")
+	void DrawUnitClusters(const TArray<FRTSUnitCluster>& Clusters);
+
 	UFUNCTION(BlueprintCallable, Category = "Selection Box")
 	void BeginSelection(const FVector2D& StartPoint);
 
@@ -35,6 +104,21 @@ public:
 	UFUNCTION(BlueprintNativeEvent, Category = "Selection Box")
 	void PerformSelection();
 
+	/** Builds the selection view from the canvas of the frame being drawn, fails outside of DrawHUD. */
+	bool GetSelectionView(FRTSSelectionView& OutView) const;
+
+	/**
+	 * Finds the actors with a URTSSelectable whose root component bounds overlap the screen rectangle spanned by the
+	 * two points.
+	 */
+	static void GetSelectableActorsInRectangle(
+		const UWorld* World,
+		const FRTSSelectionView& View,
+		const FVector2D& FirstPoint,
+		const FVector2D& SecondPoint,
+		TArray<AActor*>& OutActors
+	);
+
 	UPROPERTY()
 	bool bIsDrawingSelectionBox;
 	UPROPERTY()
@@ -42,9 +126,18 @@ public:
 
 protected:
 	virtual void DrawHUD() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 private:
+	// Picks the cluster cell size from the zoom and switches clustering on and off
+	void UpdateStrategicZoom(const FRTSSelectionView& View);
 
 	FVector2D SelectionStart;
 	FVector2D SelectionEnd;
+
+	bool IsInStrategicZoom;
+
+	// Reused by every selection so that selecting does not allocate once it has grown
+	TArray<AActor*> SelectedActorsScratch;
+	TArray<FRTSUnitCluster> UnitClustersScratch;
 };
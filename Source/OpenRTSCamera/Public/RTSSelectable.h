@@ -1,14 +1,93 @@
 ﻿#pragma once
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "Components/SceneComponent.h"
+#include "RTSCameraSignificance.h"
 #include "RTSSelectable.generated.h"
 
+/**
+ * Which units a selection larger than URTSCamera::MaxSelectionCount keeps.
+ */
+UENUM(BlueprintType)
+enum class ERTSSelectionOrder : uint8
+{
+	// Highest SelectionPriority first, nearest to the middle of the selection box among equals
+	Priority,
+	NearestToCenter,
+};
+
 UCLASS(Blueprintable, ClassGroup=(Custom), meta=(BlueprintSpawnableComponent))
 class OPENRTSCAMERA_API URTSSelectable : public UActorComponent
 {
 	GENERATED_BODY()
 public:
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
 	UFUNCTION(BlueprintCallable, BlueprintImplementableEvent, Category = "RTS Selection")
 	void OnSelected();
 
 	UFUNCTION(BlueprintCallable, BlueprintImplementableEvent, Category = "RTS Selection")
 	void OnDeselected();
+
+	/**
+	 * Names the unit in selections mirrored to the server. Handed out by the server's URTSCameraSubsystem when the
+	 * selectable registers and replicated once, 0 until then. Ids are never reused within a world.
+	 */
+	UPROPERTY(Replicated, BlueprintReadOnly, Category = "RTS Selection")
+	int32 UnitId = 0;
+
+	/**
+	 * Replicates UnitId so that clients can name this unit in selections mirrored with the camera's
+	 * EnableSelectionReplication. Off by default, every replicated selectable costs a subobject per unit.
+	 * Must be set before the selectable is registered.
+	 */
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "RTS Selection")
+	bool EnableUnitIdReplication = false;
+
+	/** How much the unit matters to what the local cameras see, kept up to date by the URTSCameraSubsystem. */
+	UPROPERTY(BlueprintReadOnly, Category = "RTS Selection")
+	ERTSSignificanceTier SignificanceTier = ERTSSignificanceTier::OffScreen;
+
+	UFUNCTION(BlueprintImplementableEvent, Category = "RTS Selection")
+	void OnSignificanceTierChanged(ERTSSignificanceTier NewTier);
+
+	/**
+	 * Units are only grouped into a strategic zoom cluster with units of the same type, name one per team and kind of
+	 * unit. Set it before the unit registers.
+	 */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "RTS Selection")
+	FName ClusterType;
+
+	/** Units with a higher priority are kept first when a selection is larger than URTSCamera::MaxSelectionCount. */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "RTS Selection")
+	int32 SelectionPriority = 0;
+
+	/** The box selections are tested against, the bounds of the owner's root component. */
+	virtual FBox GetSelectionBounds() const;
+
+	/** Adds the actors the selectable stands for to OutUnits, which is its owner unless it is a squad. */
+	virtual void AppendUnits(TArray<AActor*>& OutUnits) const;
+
+	/**
+	 * UI assets of the unit's type, such as its portrait and command card, streamed in by the
+	 * URTSAssetPrefetchSubsystem when a unit of the type is hovered or selected. The type is the owner's class and the
+	 * list of the first unit of a class seen is the one used.
+	 */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "RTS Selection")
+	TArray<TSoftObjectPtr<UObject>> PrefetchAssets;
+
+protected:
+	virtual void OnRegister() override;
+	virtual void OnUnregister() override;
+
+private:
+	// Keeps the selectable's cell in the URTSCameraSubsystem spatial index up to date as the owner moves
+	void OnRootTransformUpdated(
+		USceneComponent* UpdatedComponent,
+		EUpdateTransformFlags UpdateTransformFlags,
+		ETeleportType Teleport
+	);
+
+	TWeakObjectPtr<USceneComponent> TrackedRootComponent;
+	FDelegateHandle RootTransformUpdatedHandle;
 };
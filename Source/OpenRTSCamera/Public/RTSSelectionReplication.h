@@ -0,0 +1,94 @@
+// Copyright 2024 Jesus Bracho All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Encodes changes to a selection of units as compact deltas, so a client can mirror its selection to the server
+ * without resending it with every command.
+ *
+ * Units are identified by the id the server gave their URTSSelectable. A delta lists the removed and then the added
+ * ids, each sorted list written as runs of consecutive ids: the gap to the start of the run and the run's length, as
+ * varints. Units spawned together get consecutive ids, so selecting a whole group usually costs a couple of bytes.
+ */
+namespace RTSSelectionReplication
+{
+	/** The most ids a single delta may carry, anything larger is rejected as malformed. */
+	static constexpr int32 MaxUnitIdsPerDelta = 1 << 16;
+
+	/** How many of a client's past selections the server keeps, commands may name any of them. */
+	static constexpr int32 MaxRememberedSelections = 8;
+
+	/** Appends the sorted, unique, positive ids as runs. */
+	OPENRTSCAMERA_API void EncodeUnitIdRuns(const TArray<int32>& SortedUnitIds, TArray<uint8>& OutBytes);
+
+	/** Reads runs written by EncodeUnitIdRuns starting at InOutOffset, returns false if the bytes are malformed. */
+	OPENRTSCAMERA_API bool DecodeUnitIdRuns(const TArray<uint8>& Bytes, int32& InOutOffset, TArray<int32>& OutUnitIds);
+
+	/** Encodes what turns the sorted OldUnitIds into the sorted NewUnitIds. */
+	OPENRTSCAMERA_API void EncodeSelectionDelta(
+		const TArray<int32>& OldUnitIds,
+		const TArray<int32>& NewUnitIds,
+		TArray<uint8>& OutBytes
+	);
+
+	/**
+	 * Applies a delta written by EncodeSelectionDelta to a sorted selection.
+	 * Returns false and leaves the selection alone if the delta is malformed.
+	 */
+	OPENRTSCAMERA_API bool ApplySelectionDelta(const TArray<uint8>& Bytes, TArray<int32>& InOutUnitIds);
+
+	/**
+	 * The owning client's side of a mirrored selection: numbers the updates and diffs each against the last one sent.
+	 * The first update after a reset is a keyframe, a delta from the empty selection that the server takes whatever it
+	 * received before.
+	 */
+	struct OPENRTSCAMERA_API FSelectionSender
+	{
+		// The sorted unit ids last sent to the server
+		TArray<int32> SentUnitIds;
+		int32 Sequence = 0;
+		bool IsKeyframePending = true;
+
+		/** Starts over from an empty selection with a keyframe, for when the server lost track or the camera changed hands. */
+		void Reset();
+
+		/**
+		 * Encodes the update that brings the server to the sorted InOutUnitIds, returns false if it already has them.
+		 * InOutUnitIds is swapped with the ids sent before, so that a caller's scratch array keeps its memory.
+		 */
+		bool MakeUpdate(TArray<int32>& InOutUnitIds, int32& OutSequence, bool& OutIsKeyframe, TArray<uint8>& OutDelta);
+	};
+
+	enum class EReceiveResult : uint8
+	{
+		Applied,
+		// Ignored while waiting for the keyframe that a rejected update asked for
+		Dropped,
+		// Out of sequence or malformed, the client has to be told to send a keyframe
+		ResyncNeeded
+	};
+
+	/**
+	 * The server's side of a mirrored selection: the last few selections received, newest last.
+	 * An update it cannot apply, including a delta before any keyframe, asks for a keyframe once and the updates after
+	 * it are dropped until the keyframe arrives.
+	 */
+	struct OPENRTSCAMERA_API FSelectionReceiver
+	{
+		struct FSelection
+		{
+			int32 Sequence = 0;
+			TArray<int32> UnitIds;
+		};
+
+		TArray<FSelection> Selections;
+		bool IsAwaitingKeyframe = false;
+
+		EReceiveResult Receive(int32 Sequence, bool IsKeyframe, const TArray<uint8>& Delta);
+
+		/** The units of the selection with the given sequence number, null if it has not arrived or was forgotten. */
+		const TArray<int32>* Find(int32 Sequence) const;
+	};
+}
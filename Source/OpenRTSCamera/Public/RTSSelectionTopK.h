@@ -0,0 +1,82 @@
+// Copyright 2024 Jesus Bracho All Rights Reserved.
+
+#pragma once
+
+#include <utility>
+
+/**
+ * Partial selection for capping a selection at its best units without sorting all of the candidates.
+ *
+ * Free of the engine like RTSCameraKinematics.h and tested in Tests/KinematicsCore.
+ */
+namespace RTSSelectionTopK
+{
+	/**
+	 * Reorders Items so that the Count items that order first by Less come first, in no particular order, and the item
+	 * at Count is the one that would be there if they were sorted. Quickselect with a median of three pivot, linear on
+	 * average instead of the N log N of a sort.
+	 */
+	template <typename ItemType, typename LessType>
+	void SelectFirst(ItemType* Items, const int NumItems, const int Count, LessType Less)
+	{
+		if (Count <= 0 || Count >= NumItems)
+		{
+			return;
+		}
+
+		auto Left = 0;
+		auto Right = NumItems - 1;
+		while (Left < Right)
+		{
+			// Sorting the ends and the middle makes sorted and reversed input cheap and bounds both scans
+			const auto Middle = Left + (Right - Left) / 2;
+			if (Less(Items[Middle], Items[Left]))
+			{
+				std::swap(Items[Middle], Items[Left]);
+			}
+			if (Less(Items[Right], Items[Left]))
+			{
+				std::swap(Items[Right], Items[Left]);
+			}
+			if (Less(Items[Right], Items[Middle]))
+			{
+				std::swap(Items[Right], Items[Middle]);
+			}
+
+			const auto Pivot = Items[Middle];
+			auto Low = Left;
+			auto High = Right;
+			while (Low <= High)
+			{
+				while (Less(Items[Low], Pivot))
+				{
+					Low++;
+				}
+				while (Less(Pivot, Items[High]))
+				{
+					High--;
+				}
+				if (Low <= High)
+				{
+					std::swap(Items[Low], Items[High]);
+					Low++;
+					High--;
+				}
+			}
+
+			// Items up to High order no later than the pivot and items from Low no earlier, anything between is equal
+			if (Count <= High)
+			{
+				Right = High;
+			}
+			else if (Count >= Low)
+			{
+				Left = Low;
+			}
+			else
+			{
+				return;
+			}
+		}
+	}
+}
@@ -0,0 +1,68 @@
+// Copyright 2024 Jesus Bracho All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RTSSelectable.h"
+#include "RTSSquadSelectable.generated.h"
+
+/**
+ * A selectable that stands for a squad of member actors which are always commanded together.
+ *
+ * The squad is one entry in the URTSCameraSubsystem spatial index, tested against the union of its members' bounds, so
+ * selecting 50 squads finds, selects and notifies 50 selectables however many members they have. Members do not carry
+ * a URTSSelectable of their own. They are only listed when something asks for them, through GetMembers or
+ * URTSCamera::GetSelectedUnits.
+ *
+ * The squad is placed in the index and in strategic zoom clusters by its owner's location, keep the owner with the
+ * squad, on its leader for example. Selection stays correct if it lags behind, it only tests more cells.
+ */
+UCLASS(Blueprintable, ClassGroup=(Custom), meta=(BlueprintSpawnableComponent))
+class OPENRTSCAMERA_API URTSSquadSelectable : public URTSSelectable
+{
+	GENERATED_BODY()
+
+public:
+	UFUNCTION(BlueprintCallable, Category = "RTS Selection")
+	void AddMember(AActor* Member);
+
+	UFUNCTION(BlueprintCallable, Category = "RTS Selection")
+	void RemoveMember(AActor* Member);
+
+	/** Lists the members that still exist. */
+	UFUNCTION(BlueprintCallable, Category = "RTS Selection")
+	void GetMembers(TArray<AActor*>& OutMembers) const;
+
+	UFUNCTION(BlueprintPure, Category = "RTS Selection")
+	int32 GetNumMembers() const;
+
+	/** The union of the members' bounds, worked out again only after a member moved. */
+	virtual FBox GetSelectionBounds() const override;
+	virtual void AppendUnits(TArray<AActor*>& OutUnits) const override;
+
+protected:
+	virtual void OnRegister() override;
+	virtual void OnUnregister() override;
+
+private:
+	struct FMember
+	{
+		TWeakObjectPtr<AActor> Actor;
+		TWeakObjectPtr<USceneComponent> RootComponent;
+		FDelegateHandle TransformUpdatedHandle;
+	};
+
+	void BindMember(FMember& Member);
+	static void UnbindMember(FMember& Member);
+
+	// A member moving only marks the bounds stale, they are recomputed when a selection tests them
+	void OnMemberTransformUpdated(
+		USceneComponent* UpdatedComponent,
+		EUpdateTransformFlags UpdateTransformFlags,
+		ETeleportType Teleport
+	);
+
+	TArray<FMember> Members;
+	mutable FBox MemberBounds = FBox(ForceInit);
+	mutable bool IsMemberBoundsDirty = true;
+};
@@ -0,0 +1,46 @@
+// Copyright 2024 Jesus Bracho All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RTSUnitCluster.generated.h"
+
+class UTexture2D;
+
+/**
+ * The units of one ClusterType in one ground cell, drawn as a single icon when the camera is zoomed out strategically.
+ */
+USTRUCT(BlueprintType)
+struct OPENRTSCAMERA_API FRTSUnitCluster
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = "RTS Selection")
+	FName Type;
+
+	/** The mean location of the units in the cluster. */
+	UPROPERTY(BlueprintReadOnly, Category = "RTS Selection")
+	FVector Location = FVector::ZeroVector;
+
+	UPROPERTY(BlueprintReadOnly, Category = "RTS Selection")
+	FVector2D ScreenLocation = FVector2D::ZeroVector;
+
+	UPROPERTY(BlueprintReadOnly, Category = "RTS Selection")
+	int32 NumUnits = 0;
+};
+
+/**
+ * How the clusters of a ClusterType are drawn.
+ */
+USTRUCT(BlueprintType)
+struct OPENRTSCAMERA_API FRTSUnitClusterIconStyle
+{
+	GENERATED_BODY()
+
+	/** Drawn tinted by Color, a plain square of Color without one. */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Strategic Zoom")
+	UTexture2D* Icon = nullptr;
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Strategic Zoom")
+	FLinearColor Color = FLinearColor::White;
+};
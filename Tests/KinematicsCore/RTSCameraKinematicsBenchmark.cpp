@@ -0,0 +1,98 @@
+// Copyright 2024 Jesus Bracho All Rights Reserved.
+
+#include "RTSCameraKinematics.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+using namespace RTSCameraKinematics;
+
+namespace
+{
+	constexpr int Repetitions = 15;
+
+	// Keeps the optimizer from dropping the work being measured
+	volatile double Sink = 0;
+
+	/**
+	 * Runs Body Iterations times per repetition and prints the median and best nanoseconds per iteration.
+	 */
+	template <typename TBody>
+	void Measure(const char* Name, const int Iterations, TBody Body)
+	{
+		std::vector<double> Samples;
+		Samples.reserve(Repetitions);
+
+		for (auto Repetition = 0; Repetition < Repetitions; Repetition++)
+		{
+			const auto Start = std::chrono::steady_clock::now();
+			for (auto Iteration = 0; Iteration < Iterations; Iteration++)
+			{
+				Body(Iteration);
+			}
+			const auto End = std::chrono::steady_clock::now();
+			Samples.push_back(std::chrono::duration<double, std::nano>(End - Start).count() / Iterations);
+		}
+
+		std::sort(Samples.begin(), Samples.end());
+		std::printf("%-24s median %8.2f ns  best %8.2f ns\n", Name, Samples[Samples.size() / 2], Samples.front());
+	}
+}
+
+/**
+ * Usage: RTSCameraKinematicsBenchmark [Iterations]
+ */
+int main(const int ArgumentCount, char** Arguments)
+{
+	const auto Iterations = ArgumentCount > 1 ? std::max(1, std::atoi(Arguments[1])) : 1000000;
+	const FVec2 Viewport = {1920, 1080};
+
+	Measure("ApplyZoomInput", Iterations, [](const int Iteration)
+	{
+		Sink = Sink + ApplyZoomInput(500 + Iteration % 3000, Iteration % 2 ? 1 : -1, 500, 4000).DesiredZoomLength;
+	});
+
+	Measure("ComputeEdgeScroll", Iterations, [&Viewport](const int Iteration)
+	{
+		const FVec2 Mouse = {static_cast<double>(Iteration % 1920), static_cast<double>(Iteration % 1080)};
+		const auto EdgeScroll = ComputeEdgeScroll(Mouse, Viewport);
+		Sink = Sink + EdgeScroll.Left + EdgeScroll.Right + EdgeScroll.Up + EdgeScroll.Down;
+	});
+
+	Measure("RotationFromCursor", Iterations, [](const int Iteration)
+	{
+		const FEdgeScroll NoEdge;
+		const auto Rotation = RotationFromCursor({Iteration % 7 - 3.0, Iteration % 5 - 2.0}, NoEdge, 2000);
+		Sink = Sink + Rotation.X + Rotation.Y;
+	});
+
+	FMoveCommand Commands[4] = {{1, 0, 1}, {0, 1, 1}, {0.7, 0.7, -1}, {0, -1, 0.5}};
+	FState State;
+	State.MoveSpeed = 4000;
+	State.EdgeScrollSpeed = 4000;
+	State.DesiredZoomLength = 2000;
+
+	FStepSettings Settings;
+	Settings.ZoomCatchupSpeed = 4;
+	const FVec3 BoundsExtents = {100000, 100000, 100000};
+
+	// What URTSCamera::RunSimulationStep runs, followed by the bounds clamp the camera applies after the ground trace
+	Measure("Step", Iterations, [&](const int Iteration)
+	{
+		FStepInput Input;
+		Input.MoveCommands = Commands;
+		Input.NumMoveCommands = Iteration % 5;
+		Input.EnableEdgeScrolling = true;
+		Input.MousePosition = {static_cast<double>(Iteration % 1920), 540};
+		Input.ViewportSize = Viewport;
+		Input.DeltaSeconds = 1.0 / 60.0;
+		Step(State, Input, Settings);
+		State.RootLocation = ClampToBounds(State.RootLocation, {}, BoundsExtents);
+		Sink = Sink + State.RootLocation.X;
+	});
+
+	return 0;
+}
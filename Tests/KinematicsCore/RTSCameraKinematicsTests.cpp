@@ -0,0 +1,394 @@
+// Copyright 2024 Jesus Bracho All Rights Reserved.
+
+#include "RTSCameraKinematics.h"
+#include "RTSCameraFollowGroup.h"
+#include "RTSCameraSnapshotBuffer.h"
+#include "RTSSelectionTopK.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace RTSCameraKinematics;
+
+namespace
+{
+	int Failures = 0;
+
+	void ExpectNear(const char* What, const double Actual, const double Expected, const double Tolerance = 1.e-6)
+	{
+		if (std::fabs(Actual - Expected) > Tolerance)
+		{
+			std::printf("FAILED %s: expected %f, got %f\n", What, Expected, Actual);
+			Failures++;
+		}
+	}
+
+	void ExpectTrue(const char* What, const bool Value)
+	{
+		if (!Value)
+		{
+			std::printf("FAILED %s\n", What);
+			Failures++;
+		}
+	}
+
+	void TestZoom()
+	{
+		const auto Zoom = ApplyZoomInput(2000, 1, 500, 4000);
+		ExpectNear("zoom speed derives from the previous zoom", Zoom.ZoomSpeed, -120);
+		ExpectNear("move speed derives from the previous zoom", Zoom.MoveSpeed, 4000);
+		ExpectNear("edge scroll speed follows move speed", Zoom.EdgeScrollSpeed, 4000);
+		ExpectNear("zoom in shortens the arm", Zoom.DesiredZoomLength, 1880);
+
+		ExpectNear("zoom clamps to the minimum", ApplyZoomInput(600, 10, 500, 4000).DesiredZoomLength, 500);
+		ExpectNear("zoom clamps to the maximum", ApplyZoomInput(3900, -10, 500, 4000).DesiredZoomLength, 4000);
+	}
+
+	void TestEdgeScroll()
+	{
+		const FVec2 Viewport = {1000, 500};
+
+		const auto Center = ComputeEdgeScroll({500, 250}, Viewport);
+		ExpectTrue("no edge scrolling in the middle", !Center.IsScrolling());
+
+		const auto Left = ComputeEdgeScroll({0, 250}, Viewport);
+		ExpectNear("full speed at the left edge", Left.Left, 1);
+		ExpectNear("no right scrolling at the left edge", Left.Right, 0);
+
+		const auto HalfRight = ComputeEdgeScroll({975, 250}, Viewport);
+		ExpectNear("half speed halfway into the right band", HalfRight.Right, 0.5, 1.e-4);
+
+		const auto Corner = ComputeEdgeScroll({1000, 0}, Viewport);
+		ExpectNear("corner scrolls right", Corner.Right, 1);
+		ExpectNear("corner scrolls up", Corner.Up, 1);
+
+		const auto Offset = EdgeScrollOffset(Corner, {1, 0, 0}, {0, 1, 0}, 100, 0.5);
+		ExpectNear("up moves forward", Offset.X, 50);
+		ExpectNear("right moves right", Offset.Y, 50);
+		ExpectNear("edge scrolling stays level", Offset.Z, 0);
+	}
+
+	void TestMoveCommands()
+	{
+		const auto Offset = MoveCommandOffset(3, 4, 1, 100, 0.1);
+		ExpectNear("move direction is normalized X", Offset.X, 6);
+		ExpectNear("move direction is normalized Y", Offset.Y, 8);
+
+		const auto Degenerate = MoveCommandOffset(0, 0, 1, 100, 0.1);
+		ExpectTrue("a zero direction does not move", Degenerate.X == 0 && Degenerate.Y == 0);
+	}
+
+	void TestDrag()
+	{
+		const auto Drag = DragScale({700, 100}, {500, 250}, {1000, 500}, 0.5);
+		ExpectNear("drag right is a fraction of the extent", Drag.X, 0.4);
+		ExpectNear("drag up moves forward", Drag.Y, 0.6);
+
+		const auto Clamped = DragScale({5000, 250}, {500, 250}, {1000, 500}, 0.5);
+		ExpectNear("drag saturates", Clamped.X, 1);
+
+		const auto Empty = DragScale({10, 10}, {0, 0}, {0, 0}, 0.5);
+		ExpectTrue("an empty viewport does not drag", Empty.X == 0 && Empty.Y == 0);
+	}
+
+	void TestRotation()
+	{
+		const FEdgeScroll NoEdge;
+		const auto Right = RotationFromCursor({5, 0}, NoEdge, 2000);
+		ExpectNear("cursor right yaws right", Right.X, 0.6);
+		ExpectNear("no vertical cursor movement does not pitch", Right.Y, 0);
+
+		FEdgeScroll BottomEdge;
+		BottomEdge.Down = -1;
+		const auto Held = RotationFromCursor({0, 0}, BottomEdge, 0);
+		ExpectNear("holding the cursor on the bottom edge pitches", Held.Y, 0.4);
+	}
+
+	void TestInterpAndBounds()
+	{
+		ExpectNear("interp moves a fraction of the way", InterpTo(0, 100, 0.1, 2), 20);
+		ExpectNear("interp does not overshoot", InterpTo(0, 100, 1, 5), 100);
+		ExpectNear("interp with no speed snaps", InterpTo(0, 100, 0.1, 0), 100);
+
+		const auto Clamped = ClampToBounds({150, -150, 75}, {0, 0, 0}, {100, 100, 10});
+		ExpectNear("bounds clamp X", Clamped.X, 100);
+		ExpectNear("bounds clamp Y", Clamped.Y, -100);
+		ExpectNear("bounds leave height alone", Clamped.Z, 75);
+	}
+
+	void TestQuantization()
+	{
+		ExpectTrue("range start quantizes to zero", QuantizeToUint16(-500, -500, 500) == 0);
+		ExpectTrue("range end quantizes to the last step", QuantizeToUint16(500, -500, 500) == 65535);
+		ExpectTrue("values outside of the range are clamped", QuantizeToUint16(900, -500, 500) == 65535);
+		ExpectNear(
+			"a value survives quantization within half a step",
+			DequantizeFromUint16(QuantizeToUint16(123.456, -500, 500), -500, 500),
+			123.456,
+			1000 / 65535.0 / 2
+		);
+
+		ExpectTrue("a full turn wraps to zero", QuantizeAngleToUint16(360) == 0);
+		ExpectNear("negative angles wrap into a turn", DequantizeAngleFromUint16(QuantizeAngleToUint16(-45)), 315, 0.01);
+
+		ExpectNear("angles interpolate the short way across zero", LerpAngle(350, 10, 0.5), 360);
+		ExpectNear("angles interpolate the short way backwards", LerpAngle(10, 350, 0.5), 0);
+	}
+
+	void TestFootprint()
+	{
+		// Looking straight down from 1000 up with a 90 degree view covers 1000 to each side
+		const auto Down = ComputeGroundFootprint({0, 0, 1000}, 0, -90, 90, 1, 0, 100000);
+		ExpectNear("footprint from above reaches the field of view", Down.Max.X, 1000, 1.e-6);
+		ExpectNear("footprint from above is square", Down.Max.Y, 1000, 1.e-6);
+		ExpectNear("footprint from above is centered", Down.Min.X, -1000, 1.e-6);
+
+		ExpectTrue("a point under the camera is inside", DistanceOutsideFootprint(Down, {0, 0}) < 0);
+		ExpectNear("distance outside is measured from the nearest edge", DistanceOutsideFootprint(Down, {1500, 0}), 500);
+		ExpectNear("distance inside is negative", DistanceOutsideFootprint(Down, {800, 0}), -200);
+
+		// Looking level, the top of the view never meets the ground and is cut off
+		const auto Level = ComputeGroundFootprint({0, 0, 1000}, 0, 0, 90, 1, 0, 5000);
+		ExpectNear("corners above the horizon are cut off", Level.Max.X, 5000 / std::sqrt(2.0), 1.e-6);
+		ExpectTrue("the footprint lies ahead of the camera", Level.Min.X > 0);
+
+		// Yaw turns the footprint around the eye
+		const auto Turned = ComputeGroundFootprint({0, 0, 1000}, 90, -45, 60, 16.0 / 9.0, 0, 100000);
+		ExpectTrue("a camera facing +Y sees ahead along +Y", Turned.Min.Y > 0);
+		ExpectTrue("the point the camera looks at is inside", DistanceOutsideFootprint(Turned, {0, 1000}) < 0);
+		ExpectTrue("a point behind the camera is outside", DistanceOutsideFootprint(Turned, {0, -1000}) > 0);
+	}
+
+	void TestSnapshotBuffer()
+	{
+		// Every field carries the same number, a torn read shows up as a mismatch
+		struct FSnapshot
+		{
+			uint64_t Number = 0;
+			double Fields[30] = {};
+			uint64_t Check = 0;
+		};
+
+		TRTSCameraSnapshotBuffer<FSnapshot> Buffer;
+		FSnapshot Snapshot;
+		ExpectTrue("nothing is read before the first publication", !Buffer.Read(Snapshot));
+
+		constexpr uint64_t NumPublications = 200000;
+		std::atomic<bool> IsDone{false};
+		std::atomic<int> TornReads{0};
+		std::atomic<int> BackwardReads{0};
+
+		std::vector<std::thread> Readers;
+		for (auto Reader = 0; Reader < 3; Reader++)
+		{
+			Readers.emplace_back(
+				[&]()
+				{
+					uint64_t LastNumber = 0;
+					FSnapshot Read;
+					while (!IsDone.load())
+					{
+						if (!Buffer.Read(Read))
+						{
+							continue;
+						}
+
+						auto IsConsistent = Read.Check == Read.Number;
+						for (const auto Field : Read.Fields)
+						{
+							IsConsistent = IsConsistent && Field == static_cast<double>(Read.Number);
+						}
+						TornReads += IsConsistent ? 0 : 1;
+						BackwardReads += Read.Number < LastNumber ? 1 : 0;
+						LastNumber = Read.Number;
+					}
+				}
+			);
+		}
+
+		for (uint64_t Number = 1; Number <= NumPublications; Number++)
+		{
+			FSnapshot Published;
+			Published.Number = Number;
+			for (auto& Field : Published.Fields)
+			{
+				Field = static_cast<double>(Number);
+			}
+			Published.Check = Number;
+			Buffer.Publish(Published);
+		}
+		IsDone = true;
+		for (auto& Reader : Readers)
+		{
+			Reader.join();
+		}
+
+		ExpectTrue("concurrent reads are never torn", TornReads.load() == 0);
+		ExpectTrue("a reader never sees an older snapshot after a newer one", BackwardReads.load() == 0);
+		ExpectTrue("the latest snapshot is read", Buffer.Read(Snapshot) && Snapshot.Number == NumPublications);
+		ExpectTrue("publications are counted", Buffer.GetNumPublished() == NumPublications);
+	}
+
+	void TestFollowGroup()
+	{
+		// A 20 by 20 army 100 apart, far from the origin, and one straggler
+		FRTSCameraFollowGroup Group;
+		std::vector<int> Ids;
+		for (auto Index = 0; Index < 400; Index++)
+		{
+			Ids.push_back(Group.Add({1.e6 + (Index % 20) * 100.0, 2.e6 + (Index / 20) * 100.0, 50}));
+		}
+		ExpectNear("the centroid is the mean", Group.GetCentroid().X, 1.e6 + 950);
+		ExpectNear("the centroid is the mean on both axes", Group.GetCentroid().Y, 2.e6 + 950);
+		ExpectNear("the radius is the spread of the grid", Group.GetRadius(), std::sqrt(2 * 3325.0 * 100), 1.e-3);
+
+		const auto Straggler = Group.Add({1.e6 + 10000, 2.e6, 50});
+		ExpectTrue("a far straggler is an outlier", Group.NumInliers() == 400 && Group.Num() == 401);
+		ExpectNear("outliers do not move the centroid", Group.GetCentroid().X, 1.e6 + 950);
+
+		// The whole army marches, moving every unit keeps the sums exact
+		for (auto Step = 0; Step < 100; Step++)
+		{
+			for (auto Index = 0; Index < 400; Index++)
+			{
+				Group.Move(Ids[Index], {1.e6 + (Index % 20) * 100.0 + Step * 100.0, 2.e6 + (Index / 20) * 100.0, 50});
+			}
+		}
+		ExpectNear("moves carry the centroid along", Group.GetCentroid().X, 1.e6 + 950 + 9900, 1.e-3);
+		ExpectNear("moves keep the radius", Group.GetRadius(), std::sqrt(2 * 3325.0 * 100), 1.e-3);
+
+		// The army reached the straggler, which did not move and has to be looked at again
+		Group.Reclassify(Straggler);
+		ExpectTrue("a straggler the group caught up with rejoins it", Group.NumInliers() == 401);
+
+		Group.Remove(Straggler);
+		ExpectTrue("removed units are gone", Group.Num() == 400 && !Group.IsValid(Straggler));
+		ExpectTrue("ids are reused", Group.Add({1.e6, 2.e6, 50}) == Straggler);
+
+		for (auto Id = 0; Id < Group.GetMaxId(); Id++)
+		{
+			Group.Remove(Id);
+		}
+		ExpectTrue("the group empties", Group.Num() == 0 && Group.GetRadius() == 0);
+	}
+
+	void TestSelectionTopK()
+	{
+		// Random, sorted, reversed and heavily repeated priorities against a full sort
+		std::mt19937 Random(7);
+		for (auto Pattern = 0; Pattern < 4; Pattern++)
+		{
+			for (const auto NumItems : {1, 2, 3, 10, 100, 1000})
+			{
+				std::vector<int> Items(NumItems);
+				for (auto Index = 0; Index < NumItems; Index++)
+				{
+					Items[Index] = Pattern == 0
+						? static_cast<int>(Random() % 100000)
+						: Pattern == 1
+						? Index
+						: Pattern == 2
+						? NumItems - Index
+						: static_cast<int>(Random() % 3);
+				}
+
+				auto Sorted = Items;
+				std::sort(Sorted.begin(), Sorted.end());
+				for (const auto Count : {0, 1, NumItems / 3, NumItems - 1, NumItems})
+				{
+					auto Selected = Items;
+					RTSSelectionTopK::SelectFirst(
+						Selected.data(),
+						NumItems,
+						Count,
+						[](const int A, const int B) { return A < B; }
+					);
+					std::sort(Selected.begin(), Selected.begin() + Count);
+					ExpectTrue(
+						"the first items are the smallest",
+						std::equal(Selected.begin(), Selected.begin() + Count, Sorted.begin())
+					);
+					ExpectTrue(
+						"the item after them is in its sorted place",
+						Count >= NumItems || Count == 0 || Selected[Count] == Sorted[Count]
+					);
+				}
+			}
+		}
+	}
+
+	void TestStep()
+	{
+		const FMoveCommand Commands[] = {{1, 0, 1}, {0, 1, -1}};
+
+		FState State;
+		State.MoveSpeed = 100;
+		State.EdgeScrollSpeed = 100;
+		State.DesiredZoomLength = 1000;
+
+		FStepInput Input;
+		Input.MoveCommands = Commands;
+		Input.NumMoveCommands = 2;
+		Input.EnableEdgeScrolling = true;
+		Input.MousePosition = {500, 250};
+		Input.ViewportSize = {1000, 500};
+		Input.DeltaSeconds = 0.5;
+
+		FStepSettings Settings;
+		Settings.ZoomCatchupSpeed = 1;
+
+		const auto EdgeScroll = Step(State, Input, Settings);
+		ExpectTrue("cursor in the middle does not edge scroll", !EdgeScroll.IsScrolling());
+		ExpectNear("step applies move commands", State.RootLocation.X, 50);
+		ExpectNear("step applies every move command", State.RootLocation.Y, -50);
+		ExpectNear("step smooths the zoom", State.TargetArmLength, 500);
+
+		// On the right edge, edge scrolling moves along the root's right vector unless a drag is in progress
+		Input.NumMoveCommands = 0;
+		Input.MousePosition = {1000, 250};
+		Input.IsDragging = true;
+		ExpectTrue("dragging suspends edge scrolling", !Step(State, Input, Settings).IsScrolling());
+		ExpectNear("dragging does not edge scroll", State.RootLocation.Y, -50);
+
+		Input.IsDragging = false;
+		ExpectNear("cursor on the right edge scrolls right", Step(State, Input, Settings).Right, 1);
+		ExpectNear("edge scrolling moves the root", State.RootLocation.Y, 0);
+
+		// URTSCamera runs the sub-steps one by one to time them, they have to add up to Step
+		Input.NumMoveCommands = 2;
+		auto SubSteps = State;
+		Step(State, Input, Settings);
+		ApplyMoveCommands(SubSteps, Input);
+		ApplyEdgeScrolling(SubSteps, Input);
+		SmoothZoom(SubSteps, Input, Settings);
+		ExpectNear("sub-steps move like step", SubSteps.RootLocation.Y, State.RootLocation.Y);
+		ExpectNear("sub-steps move like step along x", SubSteps.RootLocation.X, State.RootLocation.X);
+		ExpectNear("sub-steps zoom like step", SubSteps.TargetArmLength, State.TargetArmLength);
+	}
+}
+
+int main()
+{
+	TestZoom();
+	TestEdgeScroll();
+	TestMoveCommands();
+	TestDrag();
+	TestRotation();
+	TestInterpAndBounds();
+	TestQuantization();
+	TestFootprint();
+	TestStep();
+	TestSnapshotBuffer();
+	TestFollowGroup();
+	TestSelectionTopK();
+
+	if (Failures == 0)
+	{
+		std::printf("All kinematics tests passed\n");
+	}
+
+	return Failures == 0 ? 0 : 1;
+}